@@ -0,0 +1,81 @@
+#include <memory>
+#include <string>
+
+#include "binder/binder.h"
+#include "binder/statement/copy_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the argument of a COPY option as a string; bare words parse as type names */
+auto CopyOptionValue(duckdb_libpgquery::PGDefElem *def_elem) -> std::string {
+  if (def_elem->arg == nullptr) {
+    return "";
+  }
+  switch (def_elem->arg->type) {
+    case duckdb_libpgquery::T_PGString:
+      return reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.str;
+    case duckdb_libpgquery::T_PGInteger:
+      return std::to_string(reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.ival);
+    case duckdb_libpgquery::T_PGTypeName: {
+      auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def_elem->arg);
+      return reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+    }
+    default:
+      throw NotImplementedException(fmt::format("unsupported value for COPY option {}", def_elem->defname));
+  }
+}
+
+}  // namespace
+
+auto Binder::BindCopy(duckdb_libpgquery::PGCopyStmt *stmt) -> std::unique_ptr<CopyStatement> {
+  if (stmt->relation == nullptr) {
+    throw NotImplementedException("only support copying a table, not a query");
+  }
+  if (stmt->attlist != nullptr) {
+    throw NotImplementedException("only support copying all columns of a table");
+  }
+  if (stmt->filename == nullptr || stmt->is_program) {
+    throw NotImplementedException("only support copying from or to a file");
+  }
+  auto table = BindBaseTableRef(stmt->relation->relname, std::nullopt);
+
+  auto format = CopyFormat::CSV;
+  char delimiter = ',';
+  bool header = false;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto def_elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      auto name = StringUtil::Lower(def_elem->defname);
+      auto value = CopyOptionValue(def_elem);
+      if (name == "format") {
+        auto format_name = StringUtil::Lower(value);
+        if (format_name == "csv") {
+          format = CopyFormat::CSV;
+        } else if (format_name == "binary") {
+          format = CopyFormat::BINARY;
+        } else {
+          throw NotImplementedException(fmt::format("COPY format {} is not supported", value));
+        }
+      } else if (name == "delimiter") {
+        if (value.size() != 1 || value[0] == '"' || value[0] == '\n' || value[0] == '\r') {
+          throw Exception("COPY delimiter must be a single character other than a quote or a newline");
+        }
+        delimiter = value[0];
+      } else if (name == "header") {
+        auto header_value = StringUtil::Lower(value);
+        header = header_value.empty() || header_value == "true" || header_value == "on" || header_value == "1";
+      } else {
+        throw NotImplementedException(fmt::format("COPY option {} is not supported", def_elem->defname));
+      }
+    }
+  }
+
+  return std::make_unique<CopyStatement>(std::move(table), stmt->filename, stmt->is_from, format, delimiter, header);
+}
+
+}  // namespace bustub
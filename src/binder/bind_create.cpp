@@ -112,7 +112,27 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  // `WITH (format = pax)` picks the page format; its value parses as a type name unless it is quoted.
+  std::string format = "row";
+  if (pg_stmt->options != nullptr) {
+    for (auto cell = pg_stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto def_elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (std::string(def_elem->defname) != "format" || def_elem->arg == nullptr) {
+        throw NotImplementedException(fmt::format("table option {} is not supported", def_elem->defname));
+      }
+      if (def_elem->arg->type == duckdb_libpgquery::T_PGString) {
+        format = reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.str;
+      } else if (def_elem->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def_elem->arg);
+        format = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+      } else {
+        throw NotImplementedException("format takes a name");
+      }
+      format = StringUtil::Lower(format);
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), std::move(format));
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -129,7 +149,45 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // The parser has no INCLUDE clause, so included columns come as an index option: `WITH (include = v2)`, or
+  // `WITH (include = 'v2, v3')` for several of them.
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto def_elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (std::string(def_elem->defname) != "include" || def_elem->arg == nullptr) {
+        throw NotImplementedException(fmt::format("index option {} is not supported", def_elem->defname));
+      }
+      std::vector<std::string> names;
+      if (def_elem->arg->type == duckdb_libpgquery::T_PGString) {
+        for (const auto &name :
+             StringUtil::Split(reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.str, ',')) {
+          names.emplace_back(StringUtil::Lower(StringUtil::Strip(name, ' ')));
+        }
+      } else if (def_elem->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        // a bare column name parses as a type name
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def_elem->arg);
+        names.emplace_back(
+            reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str);
+      } else {
+        throw NotImplementedException("include takes column names");
+      }
+      for (const auto &name : names) {
+        auto column_ref = ResolveColumn(*table, std::vector{name});
+        include_cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+      }
+    }
+  }
+
+  // Without a USING clause the parser fills in its own default access method, art, so an explicit `USING art` looks
+  // the same as none; both get the B+ tree, and the adaptive radix tree goes by `radix` instead.
+  std::string index_type = StringUtil::Lower(stmt->accessMethod);
+  if (index_type == DEFAULT_INDEX_TYPE) {
+    index_type = "btree";
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(include_cols),
+                                          stmt->unique, std::move(index_type));
 }
 
 }  // namespace bustub
@@ -0,0 +1,24 @@
+#include <memory>
+
+#include "binder/binder.h"
+#include "binder/statement/vacuum_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto Binder::BindVacuum(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<VacuumStatement> {
+  // VACUUM FULL does the same as VACUUM: there are no statistics to ANALYZE and nothing else to tune.
+  if ((stmt->options & ~(duckdb_libpgquery::PG_VACOPT_VACUUM | duckdb_libpgquery::PG_VACOPT_FULL)) != 0) {
+    throw NotImplementedException("only support VACUUM and VACUUM FULL");
+  }
+  if (stmt->va_cols != nullptr) {
+    throw NotImplementedException("only support vacuuming whole tables");
+  }
+  if (stmt->relation == nullptr) {
+    return std::make_unique<VacuumStatement>(nullptr);
+  }
+  return std::make_unique<VacuumStatement>(BindBaseTableRef(stmt->relation->relname, std::nullopt));
+}
+
+}  // namespace bustub
@@ -0,0 +1,22 @@
+#include "binder/statement/copy_statement.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+CopyStatement::CopyStatement(std::unique_ptr<BoundBaseTableRef> table, std::string file_name, bool is_from,
+                             CopyFormat format, char delimiter, bool header)
+    : BoundStatement(StatementType::COPY_STATEMENT),
+      table_(std::move(table)),
+      file_name_(std::move(file_name)),
+      is_from_(is_from),
+      format_(format),
+      delimiter_(delimiter),
+      header_(header) {}
+
+auto CopyStatement::ToString() const -> std::string {
+  return fmt::format("BoundCopy {{ table={}, file={}, direction={}, format={}, delimiter={}, header={} }}", *table_,
+                     file_name_, is_from_ ? "from" : "to", format_ == CopyFormat::CSV ? "csv" : "binary", delimiter_,
+                     header_);
+}
+
+}  // namespace bustub
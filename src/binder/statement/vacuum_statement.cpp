@@ -0,0 +1,16 @@
+#include "binder/statement/vacuum_statement.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+VacuumStatement::VacuumStatement(std::unique_ptr<BoundBaseTableRef> table)
+    : BoundStatement(StatementType::VACUUM_STATEMENT), table_(std::move(table)) {}
+
+auto VacuumStatement::ToString() const -> std::string {
+  if (table_ == nullptr) {
+    return "BoundVacuum { table=all }";
+  }
+  return fmt::format("BoundVacuum {{ table={} }}", *table_);
+}
+
+}  // namespace bustub
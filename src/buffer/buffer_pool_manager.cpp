@@ -32,7 +32,17 @@ BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager
   }
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::~BufferPoolManager() {
+  {
+    std::scoped_lock lock(prefetch_latch_);
+    stop_prefetching_ = true;
+  }
+  prefetch_cv_.notify_all();
+  for (auto &worker : prefetch_workers_) {
+    worker.join();
+  }
+  delete[] pages_;
+}
 
 auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
   const std::lock_guard<std::mutex> lock(latch_);
@@ -75,15 +85,19 @@ auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
 }
 
 auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
-  const std::lock_guard<std::mutex> lock(latch_);
+  std::unique_lock<std::mutex> lock(latch_);
+  // a prefetched page is pinned until its read is done, so it is still in the frame when the wait ends
+  read_ahead_done_.wait(lock, [&] { return reading_ahead_.count(page_id) == 0; });
   auto page = GetPage(page_id);
   if (page != nullptr) {
     page->pin_count_++;
     replacer_->RecordAccess(page_table_[page_id]);
     replacer_->SetEvictable(page_table_[page_id], false);
+    hit_count_++;
     return page;
   }
   // not in memory, read from disk
+  miss_count_++;
   frame_id_t free_frame_id = -1;
 
   if (free_list_.empty()) {
@@ -119,7 +133,10 @@ auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, AccessType a
   if (page == nullptr) {return false;}
   if (page->GetPinCount() == 0) {return false;}
   page->pin_count_--;
-  page->is_dirty_ = is_dirty;
+  // never clear the flag here: an earlier writer may still have unflushed changes
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
   if (page->GetPinCount() == 0) {
     replacer_->SetEvictable(page_table_[page_id], true);
   }
@@ -141,6 +158,10 @@ auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
 auto BufferPoolManager::FlushPageNoLock(page_id_t page_id) -> bool {
   Page *page = GetPage(page_id);
   if (page == nullptr) {return false;}
+  if (reading_ahead_.count(page_id) > 0) {
+    // the frame is still being filled from disk, so the disk copy is the current one
+    return true;
+  }
   disk_manager_->WritePage(page_id, page->GetData());
   page->is_dirty_ = false;
   return true;
@@ -158,11 +179,9 @@ auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
   auto page = GetPage(page_id);
   if (page == nullptr) {return true;}
   if (page->GetPinCount() != 0) {return false;}
-  if (page->IsDirty()) {
-    latch_.unlock();
-    FlushPage(page_id);
-    latch_.lock();
-  }
+  // The contents of a deleted page are garbage, so there is nothing to flush. Dropping latch_ to write it out would
+  // also let another fetch evict and reuse the frame under us.
+  page->is_dirty_ = false;
   auto frame_id = page_table_[page_id];
   page_table_.erase(page_id);
   replacer_->Remove(frame_id);
@@ -195,4 +214,108 @@ auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
 
 auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, NewPage(page_id)}; }
 
+auto BufferPoolManager::PrefetchPage(page_id_t page_id) -> bool {
+  // an id that was never allocated would leave a stale frame behind for NewPage() to collide with later
+  if (page_id < 0 || page_id >= next_page_id_) {
+    return false;
+  }
+  {
+    const std::lock_guard<std::mutex> lock(latch_);
+    if (prefetch_pins_ >= pool_size_ / BUFFER_POOL_PREFETCH_SHARE) {
+      return false;
+    }
+    Page *page = GetPage(page_id);
+    if (page != nullptr) {
+      page->pin_count_++;
+      prefetch_pins_++;
+      replacer_->SetEvictable(page_table_[page_id], false);
+      return true;
+    }
+    // leave at least one frame for the fetches the prefetch is only meant to speed up
+    if (free_list_.size() + replacer_->Size() < 2) {
+      return false;
+    }
+    frame_id_t free_frame_id = -1;
+    if (free_list_.empty()) {
+      if (!replacer_->Evict(&free_frame_id)) {
+        return false;
+      }
+    } else {
+      free_frame_id = free_list_.front();
+      free_list_.pop_front();
+    }
+
+    page = &pages_[free_frame_id];
+    if (page->IsDirty()) {
+      FlushPageNoLock(page->GetPageId());
+    }
+    if (page->GetPageId() != INVALID_PAGE_ID) {
+      page_table_.erase(page->GetPageId());
+    }
+    // one pin for the caller and one for the read, which the caller may well outlive
+    page->page_id_ = page_id;
+    page->pin_count_ = 2;
+    prefetch_pins_++;
+    page->is_dirty_ = false;
+    page_table_[page_id] = free_frame_id;
+    page->ResetMemory();
+    replacer_->RecordAccess(free_frame_id);
+    replacer_->SetEvictable(free_frame_id, false);
+    reading_ahead_.insert(page_id);
+  }
+
+  std::call_once(prefetch_workers_started_, [this] {
+    for (int i = 0; i < BUFFER_POOL_PREFETCH_WORKERS; i++) {
+      prefetch_workers_.emplace_back([this] { PrefetchWorker(); });
+    }
+  });
+  {
+    std::scoped_lock lock(prefetch_latch_);
+    prefetch_queue_.push_back(page_id);
+  }
+  prefetch_cv_.notify_one();
+  return true;
+}
+
+auto BufferPoolManager::UnpinPrefetchedPage(page_id_t page_id) -> bool {
+  if (!UnpinPage(page_id, false)) {
+    return false;
+  }
+  const std::lock_guard<std::mutex> lock(latch_);
+  prefetch_pins_--;
+  return true;
+}
+
+void BufferPoolManager::PrefetchWorker() {
+  while (true) {
+    page_id_t page_id;
+    {
+      std::unique_lock lock(prefetch_latch_);
+      prefetch_cv_.wait(lock, [this] { return stop_prefetching_ || !prefetch_queue_.empty(); });
+      if (stop_prefetching_) {
+        return;
+      }
+      page_id = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+    }
+
+    // The read holds a pin of its own, so the page stays in its frame, and fetches wait for it, so the I/O itself can
+    // run without latch_.
+    Page *page;
+    {
+      const std::lock_guard<std::mutex> lock(latch_);
+      page = GetPage(page_id);
+    }
+    disk_manager_->ReadPage(page_id, page->GetData());
+    {
+      const std::lock_guard<std::mutex> lock(latch_);
+      reading_ahead_.erase(page_id);
+      if (--page->pin_count_ == 0) {
+        replacer_->SetEvictable(page_table_[page_id], true);
+      }
+    }
+    read_ahead_done_.notify_all();
+  }
+}
+
 }  // namespace bustub
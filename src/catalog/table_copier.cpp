@@ -0,0 +1,531 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_copier.cpp
+//
+// Identification: src/catalog/table_copier.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/table_copier.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <thread>  // NOLINT
+
+#include "common/exception.h"
+#include "common/util/string_util.h"
+#include "fmt/format.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** First bytes of a binary COPY file */
+constexpr std::string_view BINARY_MAGIC = "BUSTUBCOPY";
+
+/** Read-only view of a whole file, memory-mapped when the system allows it and read into memory otherwise. */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw Exception(fmt::format("COPY cannot open {}: {}", file_name, strerror(errno)));
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+      close(fd);
+      throw Exception(fmt::format("COPY cannot stat {}: {}", file_name, strerror(errno)));
+    }
+    size_ = file_stat.st_size;
+    if (size_ > 0) {
+      void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(addr);
+        mapped_ = true;
+      } else {
+        buffer_.resize(size_);
+        size_t done = 0;
+        while (done < size_) {
+          auto n = read(fd, buffer_.data() + done, size_ - done);
+          if (n <= 0) {
+            close(fd);
+            throw Exception(fmt::format("COPY cannot read {}", file_name));
+          }
+          done += n;
+        }
+        data_ = buffer_.data();
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (mapped_) {
+      munmap(const_cast<char *>(data_), size_);
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+  auto Data() const -> const char * { return data_; }
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  const char *data_{nullptr};
+  size_t size_{0};
+  bool mapped_{false};
+  std::string buffer_;
+};
+
+/**
+ * @return whether the bytes of a tuple read from a file stay within its size: the fixed-size part, the null bitmap,
+ * and each variable-length value its offset points at. Toasted values are refused, as they point into another heap.
+ */
+auto IsWellFormed(const char *data, uint32_t size, const Schema &schema) -> bool {
+  uint32_t fixed_size = schema.GetLength() + Tuple::NullBitmapSize(&schema);
+  if (size < fixed_size) {
+    return false;
+  }
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    uint32_t offset;
+    memcpy(&offset, data + schema.GetColumn(column_idx).GetOffset(), sizeof(uint32_t));
+    if (offset < fixed_size || offset > size - sizeof(uint32_t)) {
+      return false;
+    }
+    uint32_t len;
+    memcpy(&len, data + offset, sizeof(uint32_t));
+    if (len != BUSTUB_VALUE_NULL && ((len & TOAST_MASK) != 0 || len > size - sizeof(uint32_t) - offset)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Buffered writer of a whole file. */
+class FileWriter {
+ public:
+  explicit FileWriter(const std::string &file_name)
+      : file_name_(file_name), out_(file_name, std::ios::binary | std::ios::trunc) {
+    if (!out_) {
+      throw Exception(fmt::format("COPY cannot open {} for writing", file_name));
+    }
+  }
+
+  auto Buffer() -> std::string & { return buffer_; }
+
+  /** Hand the buffer to the file once it holds a chunk, or always if force is set. */
+  void Flush(bool force = false) {
+    if (buffer_.size() >= TableCopier::CHUNK_SIZE || force) {
+      out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+      buffer_.clear();
+      if (!out_) {
+        throw Exception(fmt::format("COPY cannot write {}", file_name_));
+      }
+    }
+  }
+
+ private:
+  std::string file_name_;
+  std::ofstream out_;
+  std::string buffer_;
+};
+
+template <typename T>
+auto ParseInteger(std::string_view text, int64_t min, int64_t max) -> T {
+  int64_t value;
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (ec != std::errc() || ptr != text.data() + text.size() || value < min || value > max) {
+    throw Exception(fmt::format("invalid integer \"{}\"", text));
+  }
+  return static_cast<T>(value);
+}
+
+/** @return the value of one CSV field in the column's type */
+auto ParseValue(std::string_view text, bool quoted, const Column &column) -> Value {
+  auto type = column.GetType();
+  if (text.empty() && !quoted) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  switch (type) {
+    case TypeId::BOOLEAN: {
+      auto word = StringUtil::Lower(std::string(text));
+      if (word == "t" || word == "true" || word == "1") {
+        return ValueFactory::GetBooleanValue(true);
+      }
+      if (word == "f" || word == "false" || word == "0") {
+        return ValueFactory::GetBooleanValue(false);
+      }
+      throw Exception(fmt::format("invalid boolean \"{}\"", text));
+    }
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(ParseInteger<int8_t>(text, BUSTUB_INT8_MIN, BUSTUB_INT8_MAX));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(ParseInteger<int16_t>(text, BUSTUB_INT16_MIN, BUSTUB_INT16_MAX));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(ParseInteger<int32_t>(text, BUSTUB_INT32_MIN, BUSTUB_INT32_MAX));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(ParseInteger<int64_t>(text, BUSTUB_INT64_MIN, BUSTUB_INT64_MAX));
+    case TypeId::TIMESTAMP:
+      return ValueFactory::GetTimestampValue(ParseInteger<int64_t>(text, 0, BUSTUB_INT64_MAX));
+    case TypeId::DECIMAL: {
+      double value;
+      auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (ec != std::errc() || ptr != text.data() + text.size()) {
+        throw Exception(fmt::format("invalid decimal \"{}\"", text));
+      }
+      return ValueFactory::GetDecimalValue(value);
+    }
+    case TypeId::VARCHAR:
+      return ValueFactory::GetVarcharValue(std::string(text));
+    default:
+      throw NotImplementedException(fmt::format("COPY does not support column {}", column.GetName()));
+  }
+}
+
+/** Append a value to a CSV line, quoting strings that would not read back the same otherwise. */
+void FormatValue(const Value &value, char delimiter, std::string *out) {
+  if (value.IsNull()) {
+    return;
+  }
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+      out->append(value.GetAs<int8_t>() != 0 ? "true" : "false");
+      return;
+    case TypeId::DECIMAL:
+      out->append(fmt::format("{}", value.GetAs<double>()));
+      return;
+    case TypeId::TIMESTAMP:
+      out->append(fmt::format("{}", value.GetAs<uint64_t>()));
+      return;
+    case TypeId::VARCHAR: {
+      auto str = value.ToString();
+      if (!str.empty() && str.find_first_of(std::string{delimiter, '"', '\n', '\r'}) == std::string::npos) {
+        out->append(str);
+        return;
+      }
+      out->push_back('"');
+      for (char c : str) {
+        if (c == '"') {
+          out->push_back('"');
+        }
+        out->push_back(c);
+      }
+      out->push_back('"');
+      return;
+    }
+    default:
+      out->append(value.ToString());
+  }
+}
+
+/** Tuples of one chunk, or the first error in it. */
+struct ParsedChunk {
+  std::vector<Tuple> tuples_;
+  std::string error_;
+  /** Where the line with the error starts */
+  const char *error_line_{nullptr};
+};
+
+/** Parse the CSV lines in [begin, end), which must start and end at line boundaries. */
+void ParseCsvChunk(const char *begin, const char *end, const Schema &schema, char delimiter, ParsedChunk *out) {
+  const auto column_count = schema.GetColumnCount();
+  std::vector<Value> values;
+  values.reserve(column_count);
+  std::string unquoted;
+  const char *p = begin;
+  const char *line = begin;
+  try {
+    while (p < end) {
+      line = p;
+      values.clear();
+      while (true) {
+        std::string_view text;
+        bool quoted = false;
+        if (*p == '"') {
+          quoted = true;
+          unquoted.clear();
+          p++;
+          while (true) {
+            if (p >= end) {
+              throw Exception("unterminated quoted field");
+            }
+            if (*p == '"') {
+              if (p + 1 < end && p[1] == '"') {
+                unquoted.push_back('"');
+                p += 2;
+                continue;
+              }
+              p++;
+              break;
+            }
+            unquoted.push_back(*p++);
+          }
+          text = unquoted;
+          if (p < end && *p == '\r') {
+            p++;
+          }
+          if (p < end && *p != delimiter && *p != '\n') {
+            throw Exception("unexpected character after quoted field");
+          }
+        } else {
+          const char *field = p;
+          while (p < end && *p != delimiter && *p != '\n') {
+            p++;
+          }
+          text = std::string_view(field, p - field);
+          if (!text.empty() && text.back() == '\r' && (p == end || *p == '\n')) {
+            text.remove_suffix(1);
+          }
+        }
+        if (values.size() == column_count) {
+          throw Exception(fmt::format("more than {} fields", column_count));
+        }
+        values.push_back(ParseValue(text, quoted, schema.GetColumn(values.size())));
+        if (p < end && *p == delimiter) {
+          p++;
+          continue;
+        }
+        if (p < end) {
+          p++;  // the newline
+        }
+        break;
+      }
+      if (values.size() != column_count) {
+        throw Exception(fmt::format("expected {} fields, found {}", column_count, values.size()));
+      }
+      out->tuples_.emplace_back(values, &schema);
+    }
+  } catch (Exception &e) {
+    out->error_ = e.what();
+    out->error_line_ = line;
+  }
+}
+
+/** @return the ends of chunks of about CHUNK_SIZE bytes of [start, size) that end at line boundaries */
+auto SplitCsv(const char *data, size_t start, size_t size) -> std::vector<size_t> {
+  std::vector<size_t> ends;
+  if (memchr(data + start, '"', size - start) == nullptr) {
+    // no quotes, so every newline ends a line
+    for (size_t pos = start; pos < size;) {
+      auto end = std::min(pos + TableCopier::CHUNK_SIZE, size);
+      if (end < size) {
+        auto newline = static_cast<const char *>(memchr(data + end, '\n', size - end));
+        end = newline == nullptr ? size : newline - data + 1;
+      }
+      ends.push_back(end);
+      pos = end;
+    }
+    return ends;
+  }
+  // a quoted field may hold newlines, so track quotes from the start
+  bool in_quotes = false;
+  size_t chunk_start = start;
+  for (size_t pos = start; pos < size; pos++) {
+    if (data[pos] == '"') {
+      in_quotes = !in_quotes;
+    } else if (data[pos] == '\n' && !in_quotes && pos + 1 - chunk_start >= TableCopier::CHUNK_SIZE) {
+      ends.push_back(pos + 1);
+      chunk_start = pos + 1;
+    }
+  }
+  if (chunk_start < size) {
+    ends.push_back(size);
+  }
+  return ends;
+}
+
+}  // namespace
+
+TableCopier::TableCopier(ExecutorContext *exec_ctx, CopyFormat format, char delimiter, bool header, size_t num_threads)
+    : exec_ctx_(exec_ctx),
+      format_(format),
+      delimiter_(delimiter),
+      header_(header),
+      num_threads_(num_threads != 0 ? num_threads : std::max(1U, std::thread::hardware_concurrency())) {}
+
+auto TableCopier::CopyFrom(const TableInfo *table_info, const std::string &file_name) -> size_t {
+  MappedFile file(file_name);
+  if (format_ == CopyFormat::BINARY) {
+    return CopyFromBinary(table_info, file_name, file.Data(), file.Size());
+  }
+  return CopyFromCsv(table_info, file_name, file.Data(), file.Size());
+}
+
+auto TableCopier::CopyFromCsv(const TableInfo *table_info, const std::string &file_name, const char *data,
+                              size_t size) -> size_t {
+  size_t start = 0;
+  if (header_ && size > 0) {
+    auto newline = static_cast<const char *>(memchr(data, '\n', size));
+    start = newline == nullptr ? size : newline - data + 1;
+  }
+  auto ends = SplitCsv(data, start, size);
+
+  // Parse num_threads_ chunks at a time, then load them in file order.
+  size_t num_rows = 0;
+  for (size_t first = 0; first < ends.size(); first += num_threads_) {
+    auto last = std::min(first + num_threads_, ends.size());
+    std::vector<ParsedChunk> parsed(last - first);
+    auto parse = [&](size_t i) {
+      auto begin = i == 0 ? start : ends[i - 1];
+      ParseCsvChunk(data + begin, data + ends[i], table_info->schema_, delimiter_, &parsed[i - first]);
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = first + 1; i < last; i++) {
+      workers.emplace_back(parse, i);
+    }
+    parse(first);
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    for (auto &chunk : parsed) {
+      if (chunk.error_line_ != nullptr) {
+        auto line_number = std::count(data, chunk.error_line_, '\n') + 1;
+        throw Exception(fmt::format("COPY {}, line {}: {}", file_name, line_number, chunk.error_));
+      }
+      InsertRows(table_info, chunk.tuples_);
+      num_rows += chunk.tuples_.size();
+    }
+  }
+  return num_rows;
+}
+
+auto TableCopier::CopyFromBinary(const TableInfo *table_info, const std::string &file_name, const char *data,
+                                 size_t size) -> size_t {
+  const auto &schema = table_info->schema_;
+  const auto column_count = schema.GetColumnCount();
+  auto header_size = BINARY_MAGIC.size() + sizeof(uint32_t) + column_count;
+  if (size < header_size || std::string_view(data, BINARY_MAGIC.size()) != BINARY_MAGIC ||
+      *reinterpret_cast<const uint32_t *>(data + BINARY_MAGIC.size()) != column_count) {
+    throw Exception(fmt::format("COPY {}: not a binary COPY file of {} columns", file_name, column_count));
+  }
+  for (uint32_t i = 0; i < column_count; i++) {
+    if (static_cast<TypeId>(data[BINARY_MAGIC.size() + sizeof(uint32_t) + i]) != schema.GetColumn(i).GetType()) {
+      throw Exception(fmt::format("COPY {}: column {} has another type in the file", file_name, i));
+    }
+  }
+
+  size_t num_rows = 0;
+  std::vector<Tuple> tuples;
+  size_t batch_bytes = 0;
+  for (size_t pos = header_size; pos < size;) {
+    uint32_t tuple_size;
+    if (size - pos < sizeof(uint32_t) ||
+        (memcpy(&tuple_size, data + pos, sizeof(uint32_t)), size - pos - sizeof(uint32_t) < tuple_size) ||
+        tuple_size == 0) {
+      throw Exception(fmt::format("COPY {}: bad tuple at byte {}", file_name, pos));
+    }
+    if (!IsWellFormed(data + pos + sizeof(uint32_t), tuple_size, schema)) {
+      throw Exception(fmt::format("COPY {}: bad tuple at byte {}", file_name, pos));
+    }
+    tuples.emplace_back().DeserializeFrom(data + pos);
+    pos += sizeof(uint32_t) + tuple_size;
+    batch_bytes += tuple_size;
+    if (batch_bytes >= CHUNK_SIZE) {
+      InsertRows(table_info, tuples);
+      num_rows += tuples.size();
+      tuples.clear();
+      batch_bytes = 0;
+    }
+  }
+  InsertRows(table_info, tuples);
+  return num_rows + tuples.size();
+}
+
+void TableCopier::InsertRows(const TableInfo *table_info, const std::vector<Tuple> &tuples) {
+  if (tuples.empty()) {
+    return;
+  }
+  auto *catalog = exec_ctx_->GetCatalog();
+  auto *txn = exec_ctx_->GetTransaction();
+  std::vector<RID> rids;
+  if (!table_info->table_->AppendTuples(tuples, &rids, txn)) {
+    throw Exception(fmt::format("COPY could not append to table {}", table_info->name_));
+  }
+  for (auto *index_info : catalog->GetTableIndexes(table_info->name_)) {
+    std::vector<Tuple> keys;
+    keys.reserve(tuples.size());
+    for (size_t i = 0; i < tuples.size(); i++) {
+      keys.push_back(tuples[i].KeyFromTuple(table_info->schema_, *index_info->index_->GetEntrySchema(),
+                                            index_info->index_->GetEntryAttrs()));
+      txn->AppendIndexWriteRecord(
+          IndexWriteRecord(rids[i], table_info->oid_, WType::INSERT, tuples[i], index_info->index_oid_, catalog));
+    }
+    if (!index_info->index_->InsertEntries(keys, rids, txn)) {
+      throw Exception(fmt::format("COPY: duplicate key in unique index {}", index_info->name_));
+    }
+  }
+}
+
+auto TableCopier::CopyTo(const TableInfo *table_info, const std::string &file_name) -> size_t {
+  const auto &schema = table_info->schema_;
+  const auto column_count = schema.GetColumnCount();
+  FileWriter writer(file_name);
+  auto &out = writer.Buffer();
+  if (format_ == CopyFormat::BINARY) {
+    out.append(BINARY_MAGIC);
+    out.append(reinterpret_cast<const char *>(&column_count), sizeof(uint32_t));
+    for (const auto &column : schema.GetColumns()) {
+      out.push_back(static_cast<char>(column.GetType()));
+    }
+  } else if (header_) {
+    for (uint32_t i = 0; i < column_count; i++) {
+      if (i > 0) {
+        out.push_back(delimiter_);
+      }
+      out.append(schema.GetColumn(i).GetName());
+    }
+    out.push_back('\n');
+  }
+
+  size_t num_rows = 0;
+  auto *txn = exec_ctx_->GetTransaction();
+  auto scan_latch = table_info->table_->LockForScan();
+  for (auto iter = table_info->table_->Begin(txn); iter != table_info->table_->End(); ++iter) {
+    if (format_ == CopyFormat::BINARY) {
+      // Toasted values point into this database, so write them out in full.
+      const Tuple *tuple = &*iter;
+      Tuple detoasted;
+      if (tuple->IsToasted(&schema)) {
+        std::vector<Value> values;
+        for (uint32_t i = 0; i < column_count; i++) {
+          values.push_back(tuple->GetValue(&schema, i));
+        }
+        detoasted = Tuple(values, &schema);
+        tuple = &detoasted;
+      }
+      auto offset = out.size();
+      out.resize(offset + sizeof(uint32_t) + tuple->GetLength());
+      tuple->SerializeTo(out.data() + offset);
+    } else {
+      for (uint32_t i = 0; i < column_count; i++) {
+        if (i > 0) {
+          out.push_back(delimiter_);
+        }
+        FormatValue(iter->GetValue(&schema, i), delimiter_, &out);
+      }
+      out.push_back('\n');
+    }
+    num_rows++;
+    writer.Flush();
+  }
+  writer.Flush(true);
+  return num_rows;
+}
+
+}  // namespace bustub
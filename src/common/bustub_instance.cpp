@@ -6,13 +6,16 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/copy_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "catalog/table_copier.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
 #include "common/enums/statement_type.h"
@@ -132,6 +135,7 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.WriteHeaderCell("index_oid");
   writer.WriteHeaderCell("index_name");
   writer.WriteHeaderCell("index_cols");
+  writer.WriteHeaderCell("key_filter");
   writer.EndHeader();
   for (const auto &table_name : table_names) {
     for (const auto *index_info : catalog_->GetTableIndexes(table_name)) {
@@ -140,6 +144,16 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
       writer.WriteCell(fmt::format("{}", index_info->index_oid_));
       writer.WriteCell(index_info->name_);
       writer.WriteCell(index_info->key_schema_.ToString());
+      const auto *filter = index_info->index_->GetKeyFilter();
+      if (filter == nullptr) {
+        writer.WriteCell("");
+      } else {
+        auto stats = filter->GetStats();
+        auto saved_page_fetches = stats.skipped_ * index_info->index_->LookupPageCount();
+        writer.WriteCell(fmt::format("lookups={} skipped={} false_positives={} fp_rate={:.4f} saved_page_fetches={}",
+                                     stats.lookups_, stats.skipped_, stats.false_positives_, stats.FalsePositiveRate(),
+                                     saved_page_fetches));
+      }
       writer.EndRow();
     }
   }
@@ -216,9 +230,22 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     switch (statement->type_) {
       case StatementType::CREATE_STATEMENT: {
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
+        auto schema = Schema(create_stmt.columns_);
+
+        TableFormat format;
+        if (create_stmt.format_ == "row") {
+          format = TableFormat::ROW;
+        } else if (create_stmt.format_ == "pax") {
+          format = TableFormat::PAX;
+          if (PaxPage::EmptyPageSpace(schema) == 0) {
+            throw NotImplementedException("the rows of this table are too wide for a pax page");
+          }
+        } else {
+          throw NotImplementedException(fmt::format("table format {} is not supported", create_stmt.format_));
+        }
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_));
+        auto info = catalog_->CreateTable(txn, create_stmt.table_, schema, true, format);
         l.unlock();
 
         if (info == nullptr) {
@@ -243,10 +270,49 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
+        IndexType index_type;
+        if (index_stmt.index_type_ == "btree") {
+          index_type = IndexType::BPlusTreeIndex;
+        } else if (index_stmt.index_type_ == "radix") {
+          index_type = IndexType::ARTIndex;
+        } else if (index_stmt.index_type_ == "hash") {
+          index_type = IndexType::HashTableIndex;
+        } else {
+          throw NotImplementedException(fmt::format("index type {} is not supported", index_stmt.index_type_));
+        }
+        if (index_type != IndexType::BPlusTreeIndex && !index_stmt.include_cols_.empty()) {
+          throw NotImplementedException("only support including columns in a B+ tree index");
+        }
+
+        // Included columns are stored after the key, so the index takes the smallest key size that fits both.
+        // A key with several rows keeps one entry whose included columns come from one of them, so only unique
+        // indexes can answer queries from included columns.
+        if (!index_stmt.include_cols_.empty() && !index_stmt.unique_) {
+          throw NotImplementedException("only support including columns in a unique index");
+        }
+        std::vector<uint32_t> include_ids;
+        for (const auto &col : index_stmt.include_cols_) {
+          auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
+          include_ids.push_back(idx);
+          if (!index_stmt.table_->schema_.GetColumn(idx).IsInlined()) {
+            throw NotImplementedException("only support including fixed-length columns in an index");
+          }
+        }
+        auto entry_ids = col_ids;
+        entry_ids.insert(entry_ids.end(), include_ids.begin(), include_ids.end());
+        auto key_size = IntegerIndexKeySize(Schema::CopySchema(&index_stmt.table_->schema_, entry_ids).GetLength());
+        if (key_size == 0) {
+          throw NotImplementedException("included columns do not fit in an index entry");
+        }
+
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        auto info = DispatchIntegerIndexKeySize(key_size, [&](auto size) {
+          constexpr size_t key_bytes = decltype(size)::value;
+          return catalog_->CreateIndex<GenericKey<key_bytes>, RID, GenericComparator<key_bytes>>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              key_bytes, HashFunction<GenericKey<key_bytes>>{}, include_ids, index_stmt.unique_, index_type,
+              IsIndexKeyFilter() && index_type != IndexType::ARTIndex);
+        });
         l.unlock();
 
         if (info == nullptr) {
@@ -255,6 +321,64 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
         continue;
       }
+      case StatementType::COPY_STATEMENT: {
+        const auto &copy_stmt = dynamic_cast<const CopyStatement &>(*statement);
+
+        std::shared_lock<std::shared_mutex> l(catalog_lock_);
+        auto exec_ctx = MakeExecutorContext(txn);
+        TableCopier copier(exec_ctx.get(), copy_stmt.format_, copy_stmt.delimiter_, copy_stmt.header_);
+        const auto *table_info = catalog_->GetTable(copy_stmt.table_->oid_);
+        auto num_rows = copy_stmt.is_from_ ? copier.CopyFrom(table_info, copy_stmt.file_name_)
+                                           : copier.CopyTo(table_info, copy_stmt.file_name_);
+        l.unlock();
+
+        WriteOneCell(fmt::format("{}", num_rows), writer);
+        continue;
+      }
+      case StatementType::VACUUM_STATEMENT: {
+        const auto &vacuum_stmt = dynamic_cast<const VacuumStatement &>(*statement);
+
+        // Vacuuming gives tuples new RIDs, which must not happen under a transaction that still refers to the old ones.
+        if (!txn->GetWriteSet()->empty() || !txn->GetIndexWriteSet()->empty()) {
+          throw Exception("VACUUM cannot run in a transaction that has changed data");
+        }
+
+        std::unique_lock<std::shared_mutex> l(catalog_lock_);
+        std::vector<TableInfo *> tables;
+        if (vacuum_stmt.table_ != nullptr) {
+          tables.push_back(catalog_->GetTable(vacuum_stmt.table_->oid_));
+        } else {
+          for (const auto &name : catalog_->GetTableNames()) {
+            auto *table_info = catalog_->GetTable(name);
+            if (table_info->table_ != nullptr) {
+              tables.push_back(table_info);
+            }
+          }
+        }
+        size_t num_pages = 0;
+        for (auto *table_info : tables) {
+          auto indexes = catalog_->GetTableIndexes(table_info->name_);
+          auto num_dropped = table_info->table_->Vacuum(
+              [&](const Tuple &tuple, const RID &old_rid, const RID &new_rid) {
+                for (auto *index_info : indexes) {
+                  auto key = tuple.KeyFromTuple(table_info->schema_, *index_info->index_->GetEntrySchema(),
+                                                index_info->index_->GetEntryAttrs());
+                  index_info->index_->DeleteEntry(key, old_rid, txn);
+                  index_info->index_->InsertEntry(key, new_rid, txn);
+                }
+              },
+              txn);
+          if (!num_dropped.has_value()) {
+            throw Exception(fmt::format("VACUUM cannot run while {} is scanned or changed by other transactions",
+                                        table_info->name_));
+          }
+          num_pages += *num_dropped;
+        }
+        l.unlock();
+
+        WriteOneCell(fmt::format("{}", num_pages), writer);
+        continue;
+      }
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
         auto content = GetSessionVariable(show_stmt.variable_);
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -24,9 +25,15 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn, bool unique,
+                                         uint32_t header_max_depth)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      unique_(unique) {
+  // directory pages are only created once keys go to them
+  auto header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id_);
+  header_guard.template AsMut<HashTableDirectoryHeaderPage>()->Init(header_page_id_, header_max_depth);
 }
 
 /*****************************************************************************
@@ -45,23 +52,98 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t {
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+auto HASH_TABLE_TYPE::KeyToDirectoryPageId(KeyType key, bool create) -> page_id_t {
+  uint32_t directory_idx;
+  {
+    auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+    const auto *header_page = header_guard.template As<HashTableDirectoryHeaderPage>();
+    directory_idx = header_page->HashToDirectoryIndex(Hash(key));
+    auto directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+    if (directory_page_id != INVALID_PAGE_ID || !create) {
+      return directory_page_id;
+    }
+  }
+
+  auto header_guard = buffer_pool_manager_->FetchPageWrite(header_page_id_);
+  // another thread may have created the directory while this one waited for the header
+  auto directory_page_id = header_guard.template As<HashTableDirectoryHeaderPage>()->GetDirectoryPageId(directory_idx);
+  if (directory_page_id != INVALID_PAGE_ID) {
+    return directory_page_id;
+  }
+
+  // start with a single bucket at depth 0
+  auto dir_guard = buffer_pool_manager_->NewPageGuarded(&directory_page_id);
+  auto *dir_page = dir_guard.template AsMut<HashTableDirectoryPage>();
+  dir_page->SetPageId(directory_page_id);
+  page_id_t bucket_page_id;
+  auto bucket_guard = buffer_pool_manager_->NewPageGuarded(&bucket_page_id);
+  bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>()->Init();
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  header_guard.template AsMut<HashTableDirectoryHeaderPage>()->SetDirectoryPageId(directory_idx, directory_page_id);
+  return directory_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t {
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+template <typename F>
+auto HASH_TABLE_TYPE::VisitChain(const HASH_TABLE_BUCKET_TYPE *bucket, F &&f) -> bool {
+  if (f(bucket)) {
+    return true;
+  }
+  for (auto page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    auto page_guard = buffer_pool_manager_->FetchPageRead(page_id);
+    const auto *page = page_guard.template As<HASH_TABLE_BUCKET_TYPE>();
+    if (f(page)) {
+      return true;
+    }
+    page_id = page->GetNextPageId();
+  }
+  return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+auto HASH_TABLE_TYPE::Conflicts(const HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value)
+    -> bool {
+  bool unique = unique_ && !comparator_.HasNull(key);
+  std::vector<ValueType> values;
+  VisitChain(bucket, [&](const HASH_TABLE_BUCKET_TYPE *page) {
+    page->GetValue(key, comparator_, &values);
+    return unique && !values.empty();
+  });
+  return unique ? !values.empty() : std::find(values.begin(), values.end(), value) != values.end();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::InsertIntoChain(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value,
+                                      bool grow) -> bool {
+  auto *page = bucket;
+  WritePageGuard page_guard;
+  while (page->IsFull()) {
+    auto next_page_id = page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      if (!grow) {
+        return false;
+      }
+      auto overflow_guard = buffer_pool_manager_->NewPageGuarded(&next_page_id);
+      auto *overflow = overflow_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+      overflow->Init();
+      page->SetNextPageId(next_page_id);
+      return overflow->Insert(key, value, comparator_);
+    }
+    page_guard = buffer_pool_manager_->FetchPageWrite(next_page_id);
+    page = page_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+  }
+  return page->Insert(key, value, comparator_);
 }
 
 /*****************************************************************************
@@ -69,7 +151,21 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  auto directory_page_id = KeyToDirectoryPageId(key, false);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id);
+  auto bucket_page_id = KeyToPageId(key, dir_guard.template As<HashTableDirectoryPage>());
+  // the bucket cannot be split away from the key once it is latched, so the directory can go
+  auto bucket_guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+  dir_guard.Drop();
+  bool found = false;
+  VisitChain(bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>(), [&](const HASH_TABLE_BUCKET_TYPE *page) {
+    found |= page->GetValue(key, comparator_, result);
+    return false;
+  });
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +173,115 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  auto directory_page_id = KeyToDirectoryPageId(key, true);
+  {
+    auto dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id);
+    auto bucket_page_id = KeyToPageId(key, dir_guard.template As<HashTableDirectoryPage>());
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    dir_guard.Drop();
+
+    const auto *bucket = bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>();
+    if (Conflicts(bucket, key, value)) {
+      return false;
+    }
+    if ((!bucket->IsFull() || bucket->GetNextPageId() != INVALID_PAGE_ID) &&
+        InsertIntoChain(bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>(), key, value, false)) {
+      return true;
+    }
+  }
+  // the bucket is full, so it has to be split with the directory latched
+  return SplitInsert(transaction, directory_page_id, key, value);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, page_id_t directory_page_id, const KeyType &key,
+                                  const ValueType &value) -> bool {
+  auto dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id);
+  // only mark the directory dirty once it changes
+  const auto *dir_page = dir_guard.template As<HashTableDirectoryPage>();
+  // a split may leave every pair on one side, so keep splitting until the key's bucket has room
+  while (true) {
+    auto bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    auto bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    const auto *bucket = bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>();
+    if (Conflicts(bucket, key, value)) {
+      return false;
+    }
+    // another thread may have split the bucket while this one waited for the directory
+    if ((!bucket->IsFull() || bucket->GetNextPageId() != INVALID_PAGE_ID) &&
+        InsertIntoChain(bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>(), key, value, false)) {
+      return true;
+    }
+
+    // no split can part pairs of one hash, and none can happen once the directory is full
+    auto hash = Hash(key);
+    bool splittable = VisitChain(bucket, [&](const HASH_TABLE_BUCKET_TYPE *page) {
+      for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && page->IsOccupied(slot); slot++) {
+        if (page->IsReadable(slot) && Hash(page->KeyAt(slot)) != hash) {
+          return true;
+        }
+      }
+      return false;
+    });
+    auto local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (!splittable ||
+        (local_depth == dir_page->GetGlobalDepth() && dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE)) {
+      return InsertIntoChain(bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>(), key, value, true);
+    }
+
+    auto *mut_dir_page = dir_guard.template AsMut<HashTableDirectoryPage>();
+    if (local_depth == mut_dir_page->GetGlobalDepth()) {
+      mut_dir_page->IncrGlobalDepth();
+    }
+
+    // the slots whose index has the new local depth bit set move to the split image
+    page_id_t image_page_id;
+    auto image_guard = buffer_pool_manager_->NewPageGuarded(&image_page_id);
+    auto *image = image_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    image->Init();
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t idx = 0; idx < mut_dir_page->Size(); idx++) {
+      if (mut_dir_page->GetBucketPageId(idx) == bucket_page_id) {
+        mut_dir_page->IncrLocalDepth(idx);
+        if ((idx & high_bit) != 0) {
+          mut_dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    auto *mut_bucket = bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    if (mut_bucket->GetNextPageId() == INVALID_PAGE_ID) {
+      for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && mut_bucket->IsOccupied(slot); slot++) {
+        if (mut_bucket->IsReadable(slot) && (Hash(mut_bucket->KeyAt(slot)) & high_bit) != 0) {
+          image->Insert(mut_bucket->KeyAt(slot), mut_bucket->ValueAt(slot), comparator_);
+          mut_bucket->RemoveAt(slot);
+        }
+      }
+      continue;
+    }
+
+    // spread the pairs of the bucket and its overflow pages over the two halves anew, and free the old overflow pages
+    std::vector<MappingType> pairs;
+    std::vector<page_id_t> overflow_page_ids;
+    VisitChain(mut_bucket, [&](const HASH_TABLE_BUCKET_TYPE *page) {
+      for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && page->IsOccupied(slot); slot++) {
+        if (page->IsReadable(slot)) {
+          pairs.emplace_back(page->KeyAt(slot), page->ValueAt(slot));
+        }
+      }
+      if (page->GetNextPageId() != INVALID_PAGE_ID) {
+        overflow_page_ids.push_back(page->GetNextPageId());
+      }
+      return false;
+    });
+    mut_bucket->Init();
+    for (const auto &[pair_key, pair_value] : pairs) {
+      InsertIntoChain((Hash(pair_key) & high_bit) != 0 ? image : mut_bucket, pair_key, pair_value, true);
+    }
+    for (auto overflow_page_id : overflow_page_ids) {
+      buffer_pool_manager_->DeletePage(overflow_page_id);
+    }
+  }
 }
 
 /*****************************************************************************
@@ -90,38 +289,128 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  auto directory_page_id = KeyToDirectoryPageId(key, false);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  bool removed;
+  bool empty;
+  {
+    auto dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id);
+    auto bucket_page_id = KeyToPageId(key, dir_guard.template As<HashTableDirectoryPage>());
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    dir_guard.Drop();
+
+    auto *bucket = bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    removed = bucket->Remove(key, value, comparator_);
+    // an overflow page the pair leaves empty is taken out of the chain
+    auto *prev = bucket;
+    WritePageGuard prev_guard;
+    for (auto page_id = bucket->GetNextPageId(); !removed && page_id != INVALID_PAGE_ID;) {
+      auto page_guard = buffer_pool_manager_->FetchPageWrite(page_id);
+      auto *page = page_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+      removed = page->Remove(key, value, comparator_);
+      if (removed && page->IsEmpty()) {
+        prev->SetNextPageId(page->GetNextPageId());
+        page_guard.Drop();
+        buffer_pool_manager_->DeletePage(page_id);
+        break;
+      }
+      page_id = page->GetNextPageId();
+      prev = page;
+      prev_guard = std::move(page_guard);
+    }
+    empty = bucket->IsEmpty() && bucket->GetNextPageId() == INVALID_PAGE_ID;
+  }
+
+  if (removed && empty) {
+    Merge(transaction, directory_page_id, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, page_id_t directory_page_id, const KeyType &key,
+                            const ValueType &value) {
+  auto dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id);
+  const auto *dir_page = dir_guard.template As<HashTableDirectoryPage>();
+  auto bucket_idx = KeyToDirectoryIndex(key, dir_page);
+  // The bucket may have taken new pairs, or been merged already, since Remove let go of it. A merge can leave an
+  // empty bucket behind whose image waited for it to reach the same depth, so keep going while that is the case.
+  while (true) {
+    auto bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    auto local_depth = dir_page->GetLocalDepth(bucket_idx);
+    auto image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (local_depth == 0 || dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    auto image_page_id = dir_page->GetBucketPageId(image_idx);
+    {
+      auto bucket_guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+      auto image_guard = buffer_pool_manager_->FetchPageRead(image_page_id);
+      auto is_empty = [](const HASH_TABLE_BUCKET_TYPE *page) {
+        return page->IsEmpty() && page->GetNextPageId() == INVALID_PAGE_ID;
+      };
+      if (!is_empty(bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>())) {
+        if (!is_empty(image_guard.template As<HASH_TABLE_BUCKET_TYPE>())) {
+          break;
+        }
+        // fold the empty image into the bucket instead
+        std::swap(bucket_page_id, image_page_id);
+      }
+    }
+
+    auto *mut_dir_page = dir_guard.template AsMut<HashTableDirectoryPage>();
+    for (uint32_t idx = 0; idx < mut_dir_page->Size(); idx++) {
+      auto page_id = mut_dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        mut_dir_page->SetBucketPageId(idx, image_page_id);
+        mut_dir_page->SetLocalDepth(idx, local_depth - 1);
+      }
+    }
+    // nobody else can reach the bucket: new operations find the image instead, and the ones that went through the
+    // directory before have let go of the bucket by the time they let this thread latch the directory
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+    while (mut_dir_page->CanShrink()) {
+      mut_dir_page->DecrGlobalDepth();
+    }
+    bucket_idx &= mut_dir_page->GetGlobalDepthMask();
+  }
+}
 
 /*****************************************************************************
- * GETGLOBALDEPTH - DO NOT TOUCH
+ * GETGLOBALDEPTH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-  table_latch_.RUnlock();
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+  const auto *header_page = header_guard.template As<HashTableDirectoryHeaderPage>();
+  uint32_t global_depth = 0;
+  for (uint32_t idx = 0; idx < header_page->MaxSize(); idx++) {
+    if (header_page->GetDirectoryPageId(idx) != INVALID_PAGE_ID) {
+      auto dir_guard = buffer_pool_manager_->FetchPageRead(header_page->GetDirectoryPageId(idx));
+      global_depth = std::max(global_depth, dir_guard.template As<HashTableDirectoryPage>()->GetGlobalDepth());
+    }
+  }
   return global_depth;
 }
 
 /*****************************************************************************
- * VERIFY INTEGRITY - DO NOT TOUCH
+ * VERIFY INTEGRITY
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-  table_latch_.RUnlock();
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+  const auto *header_page = header_guard.template As<HashTableDirectoryHeaderPage>();
+  for (uint32_t idx = 0; idx < header_page->MaxSize(); idx++) {
+    if (header_page->GetDirectoryPageId(idx) != INVALID_PAGE_ID) {
+      auto dir_guard = buffer_pool_manager_->FetchPageRead(header_page->GetDirectoryPageId(idx));
+      dir_guard.template As<HashTableDirectoryPage>()->VerifyIntegrity();
+    }
+  }
 }
 
 /*****************************************************************************
@@ -10,13 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "container/disk/hash/linear_probe_hash_table.h"
 
@@ -26,21 +29,245 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : header_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)) {
+  CreateNewBlockPages(std::clamp<size_t>(num_buckets, 1, HashTableHeaderPage::MaxBlocks() * BLOCK_ARRAY_SIZE));
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::StartSlot(const KeyType &key, size_t size) -> size_t {
+  return hash_fn_.GetHash(key) % size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetValueIn(page_id_t header_page_id, const KeyType &key, std::vector<ValueType> *result)
+    -> bool {
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id);
+  const auto *header_page = header_guard.template As<HashTableHeaderPage>();
+  auto size = header_page->GetSize();
+  auto slot = StartSlot(key, size);
+  bool found = false;
+  ReadPageGuard block_guard;
+  size_t block_idx = header_page->NumBlocks();
+  // the probe ends at the first slot that was never taken, or once it went around the whole array
+  for (size_t i = 0; i < size; i++, slot = (slot + 1) % size) {
+    if (slot / BLOCK_ARRAY_SIZE != block_idx) {
+      block_idx = slot / BLOCK_ARRAY_SIZE;
+      auto block_page_id = header_page->GetBlockPageId(block_idx);
+      if (block_page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      block_guard = buffer_pool_manager_->FetchPageRead(block_page_id);
+    }
+    const auto *block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+    auto offset = slot % BLOCK_ARRAY_SIZE;
+    if (!block->IsOccupied(offset)) {
+      break;
+    }
+    if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0) {
+      result->push_back(block->ValueAt(offset));
+      found = true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::RemoveIn(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool {
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id);
+  const auto *header_page = header_guard.template As<HashTableHeaderPage>();
+  auto size = header_page->GetSize();
+  auto slot = StartSlot(key, size);
+  WritePageGuard block_guard;
+  size_t block_idx = header_page->NumBlocks();
+  for (size_t i = 0; i < size; i++, slot = (slot + 1) % size) {
+    if (slot / BLOCK_ARRAY_SIZE != block_idx) {
+      block_idx = slot / BLOCK_ARRAY_SIZE;
+      auto block_page_id = header_page->GetBlockPageId(block_idx);
+      if (block_page_id == INVALID_PAGE_ID) {
+        return false;
+      }
+      block_guard = buffer_pool_manager_->FetchPageWrite(block_page_id);
+    }
+    const auto *block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+    auto offset = slot % BLOCK_ARRAY_SIZE;
+    if (!block->IsOccupied(offset)) {
+      return false;
+    }
+    if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value) {
+      block_guard.template AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(offset);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ResizeInsert(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool {
+  auto header_guard = buffer_pool_manager_->FetchPageWrite(header_page_id);
+  const auto *header_page = header_guard.template As<HashTableHeaderPage>();
+  auto size = header_page->GetSize();
+  auto slot = StartSlot(key, size);
+  WritePageGuard block_guard;
+  size_t block_idx = header_page->NumBlocks();
+  for (size_t i = 0; i < size; i++, slot = (slot + 1) % size) {
+    if (slot / BLOCK_ARRAY_SIZE != block_idx) {
+      block_idx = slot / BLOCK_ARRAY_SIZE;
+      auto block_page_id = header_page->GetBlockPageId(block_idx);
+      if (block_page_id == INVALID_PAGE_ID) {
+        // a zeroed page is an empty block
+        buffer_pool_manager_->NewPageGuarded(&block_page_id).Drop();
+        header_guard.template AsMut<HashTableHeaderPage>()->SetBlockPageId(block_idx, block_page_id);
+      }
+      block_guard = buffer_pool_manager_->FetchPageWrite(block_page_id);
+    }
+    // tombstones are not reused, a pair is only ever put into a slot that was never taken
+    if (block_guard.template AsMut<HASH_TABLE_BLOCK_TYPE>()->Insert(slot % BLOCK_ARRAY_SIZE, key, value)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateNewBlockPages(size_t new_size) {
+  size_t num_blocks = (new_size - 1) / BLOCK_ARRAY_SIZE + 1;
+  BUSTUB_ASSERT(num_blocks <= HashTableHeaderPage::MaxBlocks(), "hash table does not fit into one header page");
+  page_id_t header_page_id;
+  auto header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id);
+  auto *header_page = header_guard.template AsMut<HashTableHeaderPage>();
+  header_page->SetPageId(header_page_id);
+  header_page->SetLSN(INVALID_LSN);
+  header_page->SetSize(new_size);
+  // blocks are created by the first insert into them
+  for (size_t i = 0; i < num_blocks; i++) {
+    header_page->AddBlockPageId(INVALID_PAGE_ID);
+  }
+
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = header_page_id;
+  migrate_cursor_ = 0;
+  num_used_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::Migrate(size_t num_slots) {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  {
+    auto header_guard = buffer_pool_manager_->FetchPageRead(old_header_page_id_);
+    const auto *header_page = header_guard.template As<HashTableHeaderPage>();
+    auto size = header_page->GetSize();
+    while (num_slots > 0 && migrate_cursor_ < size) {
+      auto block_idx = migrate_cursor_ / BLOCK_ARRAY_SIZE;
+      auto block_end = std::min(size, (block_idx + 1) * BLOCK_ARRAY_SIZE);
+      auto block_page_id = header_page->GetBlockPageId(block_idx);
+      if (block_page_id == INVALID_PAGE_ID) {
+        // nothing to move in a block that was never created
+        migrate_cursor_ = block_end;
+        num_slots--;
+        continue;
+      }
+      auto block_guard = buffer_pool_manager_->FetchPageWrite(block_page_id);
+      for (; num_slots > 0 && migrate_cursor_ < block_end; num_slots--, migrate_cursor_++) {
+        auto offset = migrate_cursor_ % BLOCK_ARRAY_SIZE;
+        const auto *block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+        if (!block->IsReadable(offset)) {
+          continue;
+        }
+        // the new array is twice as large and at most half full, so there is room
+        BUSTUB_ENSURE(ResizeInsert(header_page_id_, block->KeyAt(offset), block->ValueAt(offset)),
+                      "new array is full");
+        num_used_++;
+        // a tombstone keeps the probes through the old array going until it is dropped
+        block_guard.template AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(offset);
+      }
+    }
+    if (migrate_cursor_ < size) {
+      return;
+    }
+  }
+  DeleteBlockPages(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteBlockPages(page_id_t header_page_id) {
+  {
+    auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id);
+    const auto *header_page = header_guard.template As<HashTableHeaderPage>();
+    for (size_t i = 0; i < header_page->NumBlocks(); i++) {
+      if (header_page->GetBlockPageId(i) != INVALID_PAGE_ID) {
+        buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(i));
+      }
+    }
+  }
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  bool found = GetValueIn(header_page_id_, key, result);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    found = GetValueIn(old_header_page_id_, key, result) || found;
+  }
+  table_latch_.RUnlock();
+  return found;
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  Migrate(MIGRATE_STEP);
+
+  std::vector<ValueType> values;
+  GetValueIn(header_page_id_, key, &values);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    GetValueIn(old_header_page_id_, key, &values);
+  }
+  if (std::find(values.begin(), values.end(), value) != values.end()) {
+    table_latch_.WUnlock();
+    return false;
+  }
+
+  size_t size;
+  {
+    auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+    size = header_guard.template As<HashTableHeaderPage>()->GetSize();
+  }
+  if ((num_used_ + 1) * 2 > size) {
+    // a resize that has not caught up yet is finished first, which only happens under a burst of tombstones
+    Migrate(std::numeric_limits<size_t>::max());
+    // grow while the pairs fill the table, otherwise only get rid of the tombstones
+    auto new_size = (num_pairs_ + 1) * 4 > size ? size * 2 : size;
+    if ((new_size - 1) / BLOCK_ARRAY_SIZE + 1 <= HashTableHeaderPage::MaxBlocks()) {
+      CreateNewBlockPages(new_size);
+    } else if (num_used_ == size) {
+      LOG_WARN("linear probe hash table is full");
+      table_latch_.WUnlock();
+      return false;
+    }
+  }
+
+  bool inserted = ResizeInsert(header_page_id_, key, value);
+  if (inserted) {
+    num_used_++;
+    num_pairs_++;
+  }
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -48,21 +275,37 @@ auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  Migrate(MIGRATE_STEP);
+  bool removed = RemoveIn(header_page_id_, key, value) ||
+                 (old_header_page_id_ != INVALID_PAGE_ID && RemoveIn(old_header_page_id_, key, value));
+  if (removed) {
+    num_pairs_--;
+  }
+  table_latch_.WUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  Migrate(std::numeric_limits<size_t>::max());
+  auto new_size = std::max(initial_size * 2, GetSize());
+  new_size = std::min(new_size, HashTableHeaderPage::MaxBlocks() * BLOCK_ARRAY_SIZE);
+  CreateNewBlockPages(new_size);
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+  return header_guard.template As<HashTableHeaderPage>()->GetSize();
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -11,17 +11,53 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <vector>
 
+#include "concurrency/transaction.h"
 #include "execution/executors/delete_executor.h"
 
 namespace bustub {
 
 DeleteExecutor::DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void DeleteExecutor::Init() { throw NotImplementedException("DeleteExecutor is not implemented"); }
+void DeleteExecutor::Init() {
+  child_executor_->Init();
+  done_ = false;
+}
 
-auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
+auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (done_) {
+    return false;
+  }
+  done_ = true;
+
+  auto *catalog = exec_ctx_->GetCatalog();
+  auto *txn = exec_ctx_->GetTransaction();
+  const auto *table_info = catalog->GetTable(plan_->TableOid());
+  auto indexes = catalog->GetTableIndexes(table_info->name_);
+
+  Tuple child_tuple;
+  RID child_rid;
+  int32_t count = 0;
+  while (child_executor_->Next(&child_tuple, &child_rid)) {
+    if (!table_info->table_->MarkDelete(child_rid, txn)) {
+      continue;
+    }
+    for (auto *index_info : indexes) {
+      auto key = child_tuple.KeyFromTuple(table_info->schema_, *index_info->index_->GetEntrySchema(),
+                                          index_info->index_->GetEntryAttrs());
+      index_info->index_->DeleteEntry(key, child_rid, txn);
+      txn->AppendIndexWriteRecord(
+          IndexWriteRecord(child_rid, table_info->oid_, WType::DELETE, child_tuple, index_info->index_oid_, catalog));
+    }
+    count++;
+  }
+
+  std::vector<Value> values{Value(TypeId::INTEGER, count)};
+  *tuple = Tuple(values, &GetOutputSchema());
+  return true;
+}
 
 }  // namespace bustub
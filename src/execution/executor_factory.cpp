@@ -20,6 +20,7 @@
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/filter_executor.h"
 #include "execution/executors/hash_join_executor.h"
+#include "execution/executors/index_lookup_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
@@ -55,6 +56,11 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan.get()));
     }
 
+    // Create a new index lookup executor
+    case PlanType::IndexLookup: {
+      return std::make_unique<IndexLookupExecutor>(exec_ctx, dynamic_cast<const IndexLookupPlanNode *>(plan.get()));
+    }
+
     // Create a new insert executor
     case PlanType::Insert: {
       auto insert_plan = dynamic_cast<const InsertPlanNode *>(plan.get());
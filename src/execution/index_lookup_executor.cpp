@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_lookup_executor.cpp
+//
+// Identification: src/execution/index_lookup_executor.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "execution/executors/index_lookup_executor.h"
+
+namespace bustub {
+IndexLookupExecutor::IndexLookupExecutor(ExecutorContext *exec_ctx, const IndexLookupPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexLookupExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  const auto *index_info = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info->table_name_);
+  scan_latch_ = table_info_->table_->LockForScan();
+
+  std::vector<Value> values{plan_->key_};
+  Tuple key(values, &index_info->key_schema_);
+  rids_.clear();
+  cursor_ = 0;
+  index_info->index_->ScanKey(key, &rids_, exec_ctx_->GetTransaction());
+}
+
+auto IndexLookupExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (cursor_ < rids_.size()) {
+    auto entry_rid = rids_[cursor_++];
+    if (table_info_->table_->GetTuple(entry_rid, tuple, exec_ctx_->GetTransaction())) {
+      *rid = entry_rid;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
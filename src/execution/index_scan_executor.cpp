@@ -11,12 +11,128 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "type/limits.h"
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  scan_latch_ = table_info_->table_->LockForScan();
+
+  entry_column_of_.clear();
+  if (plan_->index_only_) {
+    const auto &entry_attrs = index_info_->index_->GetEntryAttrs();
+    entry_column_of_.assign(GetOutputSchema().GetColumnCount(), -1);
+    for (size_t i = 0; i < entry_attrs.size(); i++) {
+      entry_column_of_[entry_attrs[i]] = static_cast<int>(i);
+    }
+  }
+
+  // Integer keys turn exclusive bounds into inclusive ones, which is what the bounded iterators take. NULL keys sort
+  // first and only an unbounded scan returns them, as no comparison is true for NULL.
+  bool bounded = plan_->lower_bound_.has_value() || plan_->upper_bound_.has_value();
+  int32_t low = bounded ? BUSTUB_INT32_MIN : BUSTUB_INT32_NULL;
+  int32_t high = BUSTUB_INT32_MAX;
+  bool empty = false;
+  if (plan_->lower_bound_.has_value()) {
+    auto key = plan_->lower_bound_->key_.GetAs<int32_t>();
+    if (!plan_->lower_bound_->inclusive_) {
+      empty = key == BUSTUB_INT32_MAX;
+      key++;
+    }
+    low = std::max(low, key);
+  }
+  if (plan_->upper_bound_.has_value()) {
+    auto key = plan_->upper_bound_->key_.GetAs<int32_t>();
+    if (!plan_->upper_bound_->inclusive_) {
+      empty = empty || key == BUSTUB_INT32_MIN;
+      key--;
+    }
+    high = std::min(high, key);
+  }
+
+  if (index_info_->index_type_ == IndexType::ARTIndex) {
+    auto *art = dynamic_cast<ARTIndex *>(index_info_->index_.get());
+    if (empty || low > high) {
+      iter_ = art->GetEndIterator();
+    } else if (plan_->reverse_) {
+      iter_ = art->GetReverseBeginIterator(MakeKeyTuple(high), MakeKeyTuple(low));
+    } else {
+      iter_ = art->GetBeginIterator(MakeKeyTuple(low), MakeKeyTuple(high));
+    }
+    return;
+  }
+
+  DispatchIntegerIndexKeySize(index_info_->key_size_, [&](auto size) {
+    constexpr size_t key_bytes = decltype(size)::value;
+    auto *tree = dynamic_cast<BPlusTreeIndexForIntegerKey<key_bytes> *>(index_info_->index_.get());
+    BUSTUB_ENSURE(tree != nullptr, "index scans need a B+ tree index on one integer column");
+    if (empty || low > high) {
+      iter_ = tree->GetEndIterator();
+    } else if (plan_->reverse_) {
+      iter_ = tree->GetReverseBeginIterator(MakeKey<key_bytes>(high), MakeKey<key_bytes>(low));
+    } else {
+      iter_ = tree->GetBeginIterator(MakeKey<key_bytes>(low), MakeKey<key_bytes>(high));
+    }
+  });
+}
+
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  return std::visit(
+      [&](auto &iter) {
+        while (!iter.IsEnd()) {
+          auto [entry, entry_rid] = *iter;
+          ++iter;
+          // the optimizer plans index-only scans on B+ trees only
+          if constexpr (!std::is_same_v<std::decay_t<decltype(iter)>, ARTIterator>) {
+            if (plan_->index_only_) {
+              *tuple = EntryToTuple(entry);
+              *rid = entry_rid;
+              return true;
+            }
+          }
+          if (table_info_->table_->GetTuple(entry_rid, tuple, exec_ctx_->GetTransaction())) {
+            *rid = entry_rid;
+            return true;
+          }
+        }
+        return false;
+      },
+      iter_);
+}
+
+auto IndexScanExecutor::MakeKeyTuple(int32_t value) const -> Tuple {
+  std::vector<Value> values{Value(TypeId::INTEGER, value)};
+  return {values, &index_info_->key_schema_};
+}
 
-void IndexScanExecutor::Init() { throw NotImplementedException("IndexScanExecutor is not implemented"); }
+template <size_t KeySize>
+auto IndexScanExecutor::MakeKey(int32_t value) const -> GenericKey<KeySize> {
+  GenericKey<KeySize> key;
+  key.SetFromKey(MakeKeyTuple(value));
+  return key;
+}
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+template <size_t KeySize>
+auto IndexScanExecutor::EntryToTuple(const GenericKey<KeySize> &entry) const -> Tuple {
+  const auto &schema = GetOutputSchema();
+  auto *entry_schema = index_info_->index_->GetEntrySchema();
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    values.push_back(entry_column_of_[i] < 0 ? ValueFactory::GetNullValueByType(schema.GetColumn(i).GetType())
+                                             : entry.ToValue(entry_schema, entry_column_of_[i]));
+  }
+  return {values, &schema};
+}
 
 }  // namespace bustub
@@ -11,17 +11,89 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <vector>
 
+#include "common/exception.h"
+#include "concurrency/transaction.h"
 #include "execution/executors/insert_executor.h"
+#include "fmt/format.h"
 
 namespace bustub {
 
 InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void InsertExecutor::Init() { throw NotImplementedException("InsertExecutor is not implemented"); }
+void InsertExecutor::Init() {
+  child_executor_->Init();
+  done_ = false;
+}
 
-auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
+auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (done_) {
+    return false;
+  }
+  done_ = true;
+
+  std::vector<Tuple> batch;
+  Tuple child_tuple;
+  RID child_rid;
+  int32_t count = 0;
+  bool append = false;
+  while (child_executor_->Next(&child_tuple, &child_rid)) {
+    batch.push_back(child_tuple);
+    if (batch.size() == BULK_INSERT_BATCH_SIZE) {
+      count += InsertBatch(batch, true);
+      append = true;
+      batch.clear();
+    }
+  }
+  count += InsertBatch(batch, append);
+
+  std::vector<Value> values{Value(TypeId::INTEGER, count)};
+  *tuple = Tuple(values, &GetOutputSchema());
+  return true;
+}
+
+auto InsertExecutor::InsertBatch(const std::vector<Tuple> &tuples, bool append) -> int32_t {
+  auto *catalog = exec_ctx_->GetCatalog();
+  auto *txn = exec_ctx_->GetTransaction();
+  const auto *table_info = catalog->GetTable(plan_->TableOid());
+
+  std::vector<RID> rids;
+  std::vector<Tuple> kept;
+  const auto *inserted = &tuples;
+  if (append) {
+    if (!table_info->table_->AppendTuples(tuples, &rids, txn)) {
+      return 0;
+    }
+  } else {
+    for (const auto &tuple : tuples) {
+      RID rid;
+      if (table_info->table_->InsertTuple(tuple, &rid, txn)) {
+        kept.push_back(tuple);
+        rids.push_back(rid);
+      }
+    }
+    inserted = &kept;
+  }
+
+  for (auto *index_info : catalog->GetTableIndexes(table_info->name_)) {
+    std::vector<Tuple> keys;
+    keys.reserve(inserted->size());
+    for (size_t i = 0; i < inserted->size(); i++) {
+      keys.push_back((*inserted)[i].KeyFromTuple(table_info->schema_, *index_info->index_->GetEntrySchema(),
+                                              index_info->index_->GetEntryAttrs()));
+      txn->AppendIndexWriteRecord(
+          IndexWriteRecord(rids[i], table_info->oid_, WType::INSERT, (*inserted)[i], index_info->index_oid_, catalog));
+    }
+    if (!index_info->index_->InsertEntries(keys, rids, txn)) {
+      // the key is already in a unique index: abort, so the rows inserted so far roll back
+      txn->SetState(TransactionState::ABORTED);
+      throw ExecutionException(fmt::format("duplicate key in unique index {}", index_info->name_));
+    }
+  }
+  return static_cast<int32_t>(inserted->size());
+}
 
 }  // namespace bustub
@@ -12,19 +12,87 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include <vector>
+
+#include "type/value_factory.h"
+
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  auto *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  inner_table_info_ = catalog->GetTable(plan_->GetInnerTableOid());
+  scan_latch_ = inner_table_info_->table_->LockForScan();
+  has_outer_ = false;
+  inner_rids_.clear();
+  inner_cursor_ = 0;
+}
+
+void NestIndexJoinExecutor::ProbeInner() {
+  inner_rids_.clear();
+  inner_cursor_ = 0;
+  auto key_value = plan_->KeyPredicate()->Evaluate(&outer_tuple_, child_executor_->GetOutputSchema());
+  // NULL equals nothing
+  if (key_value.IsNull()) {
+    return;
+  }
+  std::vector<Value> values{key_value};
+  Tuple key(values, &index_info_->key_schema_);
+  index_info_->index_->ScanKey(key, &inner_rids_, exec_ctx_->GetTransaction());
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  while (true) {
+    if (!has_outer_) {
+      RID outer_rid;
+      if (!child_executor_->Next(&outer_tuple_, &outer_rid)) {
+        return false;
+      }
+      has_outer_ = true;
+      outer_matched_ = false;
+      ProbeInner();
+    }
+
+    std::vector<Value> values;
+    values.reserve(GetOutputSchema().GetColumnCount());
+    for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+      values.push_back(outer_tuple_.GetValue(&outer_schema, i));
+    }
+    while (inner_cursor_ < inner_rids_.size()) {
+      Tuple inner_tuple;
+      if (!inner_table_info_->table_->GetTuple(inner_rids_[inner_cursor_++], &inner_tuple,
+                                               exec_ctx_->GetTransaction())) {
+        continue;
+      }
+      for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+        values.push_back(inner_tuple.GetValue(&inner_schema, i));
+      }
+      outer_matched_ = true;
+      *tuple = Tuple(values, &GetOutputSchema());
+      return true;
+    }
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+    has_outer_ = false;
+    if (!outer_matched_ && plan_->GetJoinType() == JoinType::LEFT) {
+      for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+        values.push_back(ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+      }
+      *tuple = Tuple(values, &GetOutputSchema());
+      return true;
+    }
+  }
+}
 
 }  // namespace bustub
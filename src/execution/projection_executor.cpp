@@ -13,23 +13,21 @@ void ProjectionExecutor::Init() {
 }
 
 auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  Tuple child_tuple{};
-
   // Get the next tuple
-  const auto status = child_executor_->Next(&child_tuple, rid);
+  const auto status = child_executor_->Next(&child_tuple_, rid);
 
   if (!status) {
     return false;
   }
 
   // Compute expressions
-  std::vector<Value> values{};
-  values.reserve(GetOutputSchema().GetColumnCount());
+  values_.clear();
   for (const auto &expr : plan_->GetExpressions()) {
-    values.push_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+    values_.push_back(expr->Evaluate(&child_tuple_, child_executor_->GetOutputSchema()));
   }
 
-  *tuple = Tuple{values, &GetOutputSchema()};
+  // The output is a view of buffer_, which every row reuses
+  *tuple = Tuple::ViewOf(values_, &GetOutputSchema(), &buffer_);
 
   return true;
 }
@@ -1,23 +1,54 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void SeqScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  scan_latch_ = table_info_->table_->LockForScan();
+  next_page_id_ = table_info_->table_->GetFirstPageId();
+  page_copy_.resize(BUSTUB_PAGE_SIZE);
+  tuples_.clear();
+  cursor_ = 0;
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (cursor_ == tuples_.size()) {
+      if (next_page_id_ == INVALID_PAGE_ID) {
+        return false;
+      }
+      next_page_id_ = table_info_->table_->ScanPage(next_page_id_, page_copy_.data(), &tuples_,
+                                                    plan_->columns_.has_value() ? &*plan_->columns_ : nullptr,
+                                                    &plan_->ranges_);
+      cursor_ = 0;
+      continue;
+    }
+    auto &view = tuples_[cursor_++];
+    if (plan_->filter_predicate_ != nullptr) {
+      auto value = plan_->filter_predicate_->Evaluate(&view, GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    *rid = view.GetRid();
+    *tuple = std::move(view);
+    return true;
+  }
+}
+
+}  // namespace bustub
@@ -76,11 +76,13 @@ class BoundExpression;
 class BoundExpressionListRef;
 class BoundOrderBy;
 class BoundSubqueryRef;
+class CopyStatement;
 class CreateStatement;
 class ExplainStatement;
 class IndexStatement;
 class DeleteStatement;
 class UpdateStatement;
+class VacuumStatement;
 
 /**
  * The binder is responsible for transforming the Postgres parse tree to a binder tree
@@ -204,6 +206,10 @@ class Binder {
 
   auto BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> std::unique_ptr<VariableShowStatement>;
 
+  auto BindCopy(duckdb_libpgquery::PGCopyStmt *stmt) -> std::unique_ptr<CopyStatement>;
+
+  auto BindVacuum(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<VacuumStatement>;
+
   class ContextGuard {
    public:
     explicit ContextGuard(const BoundTableRef **scope, const CTEList **cte_scope) {
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/copy_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "binder/bound_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+
+namespace bustub {
+
+/** File formats of COPY */
+enum class CopyFormat : uint8_t { CSV, BINARY };
+
+/**
+ * `COPY table FROM 'file'` loads rows from a file into a table, and `COPY table TO 'file'` writes all rows of a
+ * table to a file. Options come as `WITH (FORMAT csv|binary, DELIMITER ',', HEADER)`.
+ */
+class CopyStatement : public BoundStatement {
+ public:
+  explicit CopyStatement(std::unique_ptr<BoundBaseTableRef> table, std::string file_name, bool is_from,
+                         CopyFormat format, char delimiter, bool header);
+
+  /** The table to copy into or out of */
+  std::unique_ptr<BoundBaseTableRef> table_;
+
+  /** Path of the file */
+  std::string file_name_;
+
+  /** Whether rows go from the file into the table, rather than the other way around */
+  bool is_from_;
+
+  /** Format of the file */
+  CopyFormat format_;
+
+  /** Field delimiter of a CSV file */
+  char delimiter_;
+
+  /** Whether a CSV file starts with a line of column names */
+  bool header_;
+
+  auto ToString() const -> std::string override;
+};
+
+}  // namespace bustub
@@ -21,11 +21,14 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, std::string format = "row");
 
   std::string table_;
   std::vector<Column> columns_;
 
+  /** The page format of `WITH (format = ...)`: row, or pax to store the rows of a page column by column */
+  std::string format_;
+
   auto ToString() const -> std::string override;
 };
 
@@ -21,7 +21,9 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols,
+                          std::vector<std::unique_ptr<BoundColumnRef>> include_cols = {}, bool unique = false,
+                          std::string index_type = "btree");
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +34,15 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Name of the columns stored in the index after the key */
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols_;
+
+  /** Whether a key may appear in at most one row */
+  bool unique_;
+
+  /** The access method of the `USING` clause: btree, or radix for an adaptive radix tree */
+  std::string index_type_;
+
   auto ToString() const -> std::string override;
 };
 
@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/vacuum_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "binder/bound_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+
+namespace bustub {
+
+/**
+ * `VACUUM table` packs the tuples of a table into as few pages as it can and drops the pages this empties.
+ * `VACUUM` alone does so for every table.
+ */
+class VacuumStatement : public BoundStatement {
+ public:
+  explicit VacuumStatement(std::unique_ptr<BoundBaseTableRef> table);
+
+  /** The table to vacuum, nullptr for all tables */
+  std::unique_ptr<BoundBaseTableRef> table_;
+
+  auto ToString() const -> std::string override;
+};
+
+}  // namespace bustub
@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "buffer/lru_k_replacer.h"
 #include "common/config.h"
@@ -49,6 +54,12 @@ class BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t { return pool_size_; }
 
+  /** @brief Return the number of fetches that found their page in the pool. */
+  auto GetHitCount() -> uint64_t { return hit_count_; }
+
+  /** @brief Return the number of fetches that had to read their page from disk. */
+  auto GetMissCount() -> uint64_t { return miss_count_; }
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
@@ -121,6 +132,31 @@ class BufferPoolManager {
   auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
   auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
 
+  /**
+   * @brief Pin a page for a later FetchPage() and, if it is not in the buffer pool yet, read it in the background, so
+   * that the fetch does not have to wait for the disk.
+   *
+   * The frame is taken and pinned right away; the read runs on one of BUFFER_POOL_PREFETCH_WORKERS threads, started
+   * on first use. A fetch that comes while the read is in flight waits for it. The pin keeps the replacer from
+   * evicting the page before it is used, and belongs to the caller, who must UnpinPrefetchedPage() it whether or not
+   * the page is fetched in the end.
+   *
+   * Prefetching is a hint, so it gives way to fetches: it pins at most 1/BUFFER_POOL_PREFETCH_SHARE of the frames,
+   * and never takes the last frame that could be freed.
+   *
+   * @param page_id id of a page that has been allocated
+   * @return false if the page was not pinned: prefetch pins are at their limit, no frame could be spared for it, or
+   * page_id was never allocated
+   */
+  auto PrefetchPage(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Let go of the pin a PrefetchPage() call took.
+   * @param page_id id of the prefetched page
+   * @return false if the page is not in the buffer pool or not pinned
+   */
+  auto UnpinPrefetchedPage(page_id_t page_id) -> bool;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -209,5 +245,28 @@ class BufferPoolManager {
 
   auto GetPage(page_id_t page_id) -> Page*;
   auto FlushPageNoLock(page_id_t page_id) -> bool;
+
+  /** Take prefetched pages off the queue and read them in until the buffer pool shuts down. */
+  void PrefetchWorker();
+
+  /**
+   * Pages whose frames are reserved by PrefetchPage() but not read in yet. They must not be flushed, and fetches wait
+   * on read_ahead_done_ for them to come off this set. Guarded by latch_.
+   */
+  std::unordered_set<page_id_t> reading_ahead_;
+  std::condition_variable read_ahead_done_;
+  /** Pins taken by PrefetchPage() and not yet given back, guarded by latch_. */
+  size_t prefetch_pins_{0};
+
+  /** Page ids waiting for a prefetch worker, guarded by prefetch_latch_. */
+  std::deque<page_id_t> prefetch_queue_;
+  bool stop_prefetching_{false};
+  std::mutex prefetch_latch_;
+  std::condition_variable prefetch_cv_;
+  /** Fetch outcomes, for hit rates; updated under latch_. */
+  std::atomic<uint64_t> hit_count_{0};
+  std::atomic<uint64_t> miss_count_{0};
+  std::once_flag prefetch_workers_started_;
+  std::vector<std::thread> prefetch_workers_;
 };
 }  // namespace bustub
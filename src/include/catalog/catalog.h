@@ -21,6 +21,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/art_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
@@ -58,6 +59,16 @@ struct TableInfo {
   const table_oid_t oid_;
 };
 
+/** The data structures an index can be built on. */
+enum class IndexType {
+  /** A B+ tree in the buffer pool */
+  BPlusTreeIndex,
+  /** An adaptive radix tree kept in memory */
+  ARTIndex,
+  /** An extendible hash table in the buffer pool, which answers equality lookups only */
+  HashTableIndex
+};
+
 /**
  * The IndexInfo class maintains metadata about a index.
  */
@@ -70,15 +81,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure of the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +104,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure of the index */
+  const IndexType index_type_;
 };
 
 /**
@@ -106,6 +121,9 @@ class Catalog {
   /** Indicates that an operation returning a `IndexInfo*` failed */
   static constexpr IndexInfo *NULL_INDEX_INFO{nullptr};
 
+  /** Smallest number of keys a key filter is sized for, so that the filter of a new table is not full right away */
+  static constexpr size_t KEY_FILTER_MIN_KEYS{1 << 14};
+
   /**
    * Construct a new Catalog instance.
    * @param bpm The buffer pool manager backing tables created by this catalog
@@ -121,10 +139,11 @@ class Catalog {
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param format The format of the pages of the table heap
    * @return A (non-owning) pointer to the metadata for the table
    */
-  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true)
-      -> TableInfo * {
+  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true,
+                   TableFormat format = TableFormat::ROW) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
@@ -136,7 +155,7 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn, &schema, format);
     }
 
     // Fetch the table OID for the new table
@@ -196,12 +215,18 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param include_attrs Columns stored after the key in each entry; keysize must leave room for them
+   * @param is_unique Whether the index rejects a second tuple with the same key
+   * @param index_type The data structure to build the index on; the key types only matter for a B+ tree
+   * @param key_filter Whether to put a key filter in front of the lookups of a B+ tree or hash index
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, const std::vector<uint32_t> &include_attrs = {},
+                   bool is_unique = false, IndexType index_type = IndexType::BPlusTreeIndex, bool key_filter = false)
+      -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -218,29 +243,63 @@ class Catalog {
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, include_attrs, is_unique);
 
     // Construct the index, take ownership of metadata
     // TODO(Kyle): We should update the API for CreateIndex
     // to allow specification of the index type itself, not
     // just the key, value, and comparator types
 
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
-
-    // Populate the index with all tuples in table heap
+    std::unique_ptr<Index> index;
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    if (index_type == IndexType::ARTIndex) {
+      // Build the tree from all tuples in table heap at once, so that its nodes start out at their final size
+      auto art_index = std::make_unique<ARTIndex>(std::move(meta));
+      std::vector<std::pair<Tuple, RID>> entries;
+      for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
+        entries.emplace_back(tuple->KeyFromTuple(schema, *art_index->GetEntrySchema(), art_index->GetEntryAttrs()),
+                             tuple->GetRid());
+      }
+      if (!art_index->BulkLoad(entries)) {
+        // a unique index over a column that already repeats
+        return NULL_INDEX_INFO;
+      }
+      index = std::move(art_index);
+    } else {
+      if (index_type == IndexType::HashTableIndex) {
+        index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                              hash_function);
+      } else {
+        index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+      }
+      if (key_filter) {
+        // leave room for the table to double before the filter gets less selective
+        size_t num_tuples = 0;
+        for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
+          num_tuples++;
+        }
+        index->EnableKeyFilter(std::max<size_t>(2 * num_tuples, KEY_FILTER_MIN_KEYS));
+      }
+
+      // Populate the index with all tuples in table heap, as one batch
+      std::vector<Tuple> keys;
+      std::vector<RID> rids;
+      for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
+        keys.push_back(tuple->KeyFromTuple(schema, *index->GetEntrySchema(), index->GetEntryAttrs()));
+        rids.push_back(tuple->GetRid());
+      }
+      if (!index->InsertEntries(keys, rids, txn)) {
+        return NULL_INDEX_INFO;
+      }
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -298,7 +357,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
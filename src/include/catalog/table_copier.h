@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_copier.h
+//
+// Identification: src/include/catalog/table_copier.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "binder/statement/copy_statement.h"
+#include "catalog/catalog.h"
+#include "execution/executor_context.h"
+
+namespace bustub {
+
+/**
+ * TableCopier moves rows between a table and a file, for COPY.
+ *
+ * COPY FROM maps the file into memory and cuts it into chunks at line ends. Worker threads build tuples straight
+ * from the mapped bytes, one chunk each, and the rows go into the table chunk by chunk in file order, through
+ * TableHeap::AppendTuples and one Index::InsertEntries batch per index.
+ *
+ * CSV follows PostgreSQL: a field may be quoted with ", a quote inside a quoted field is doubled, and an empty
+ * unquoted field is NULL. The binary format is a header that lists the column types, followed by every tuple as
+ * Tuple::SerializeTo lays it out; it loads on one thread.
+ */
+class TableCopier {
+ public:
+  /** Number of bytes of the file a worker parses at a time */
+  static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+  /**
+   * @param exec_ctx the context of the copying transaction
+   * @param format format of the file
+   * @param delimiter field delimiter of a CSV file
+   * @param header whether a CSV file starts with a line of column names
+   * @param num_threads number of threads that parse a CSV file, 0 for one per core
+   */
+  TableCopier(ExecutorContext *exec_ctx, CopyFormat format, char delimiter, bool header, size_t num_threads = 0);
+
+  /**
+   * Load all rows of a file into a table and its indexes. Throws on malformed input, naming the line.
+   * @return the number of rows loaded
+   */
+  auto CopyFrom(const TableInfo *table_info, const std::string &file_name) -> size_t;
+
+  /**
+   * Write all rows of a table to a file, replacing the file if it exists.
+   * @return the number of rows written
+   */
+  auto CopyTo(const TableInfo *table_info, const std::string &file_name) -> size_t;
+
+ private:
+  auto CopyFromCsv(const TableInfo *table_info, const std::string &file_name, const char *data, size_t size)
+      -> size_t;
+
+  auto CopyFromBinary(const TableInfo *table_info, const std::string &file_name, const char *data, size_t size)
+      -> size_t;
+
+  /** Append tuples to the table and insert them into every index of the table. */
+  void InsertRows(const TableInfo *table_info, const std::vector<Tuple> &tuples);
+
+  ExecutorContext *exec_ctx_;
+  CopyFormat format_;
+  char delimiter_;
+  bool header_;
+  size_t num_threads_;
+};
+
+}  // namespace bustub
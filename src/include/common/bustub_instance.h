@@ -266,6 +266,12 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return whether new B+ tree and hash indexes get a key filter in front of their lookups */
+  auto IsIndexKeyFilter() -> bool {
+    auto variable = StringUtil::Lower(GetSessionVariable("index_key_filter"));
+    return variable == "1" || variable == "true" || variable == "yes";
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
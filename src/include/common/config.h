@@ -36,6 +36,9 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int BUFFER_POOL_PREFETCH_WORKERS = 4;    // threads reading prefetched pages in the background
+static constexpr int BUFFER_POOL_PREFETCH_SHARE = 2;      // at most 1/N of the frames hold prefetch pins
+static constexpr int INDEX_ITERATOR_PREFETCH_DEPTH = 8;  // leaves an index iterator prefetches ahead of itself
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -20,6 +20,7 @@
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_header_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
 namespace bustub {
@@ -30,6 +31,18 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * A header page picks one of up to 2^header_max_depth directory pages by the high bits of the hash of a key, and
+ * the directory picks the bucket by the low bits. Each directory grows and shrinks on its own, so a full table has
+ * DIRECTORY_ARRAY_SIZE buckets per directory. Directory pages are created when the first key goes to them and are
+ * never moved, so the header is only write-latched to add one.
+ *
+ * Pairs that all share one hash cannot be split apart, so a bucket full of them, or a full bucket whose directory
+ * cannot grow, chains overflow pages instead. A split of a bucket with overflow pages spreads all of its pairs anew.
+ *
+ * Concurrency is handled with the page latches alone. Lookups, inserts and removes read-latch the directory page
+ * only until they hold the latch of their bucket, so they run in parallel unless they meet in one bucket. Splits and
+ * merges write-latch the directory page, which waits for the operations still on it and keeps new ones out.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -40,9 +53,13 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param unique whether a key may hold a single value only
+   * @param header_max_depth number of high hash bits that pick the directory page, at most
+   * DIRECTORY_HEADER_MAX_DEPTH
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   bool unique = false, uint32_t header_max_depth = DIRECTORY_HEADER_MAX_DEPTH);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -50,7 +67,8 @@ class DiskExtendibleHashTable {
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair is present or the table is unique and has the key (unless
+   * the key has a NULL column)
    */
   auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
 
@@ -75,12 +93,12 @@ class DiskExtendibleHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Returns the global depth
+   * Returns the global depth of the deepest directory
    */
   auto GetGlobalDepth() -> uint32_t;
 
   /**
-   * Helper function to verify the integrity of the extendible hash table's directory.
+   * Helper function to verify the integrity of the extendible hash table's directories.
    */
   void VerifyIntegrity();
 
@@ -110,7 +128,16 @@ class DiskExtendibleHashTable {
    * @param dir_page to use for lookup of global depth
    * @return the directory index
    */
-  auto KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t;
+  auto KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t;
+
+  /**
+   * Get the page id of the directory page of a key.
+   *
+   * @param key the key for lookup
+   * @param create whether to create the directory page, with a single empty bucket, if the key is the first to go there
+   * @return the directory page_id corresponding to the input key, or INVALID_PAGE_ID if there is none and !create
+   */
+  auto KeyToDirectoryPageId(KeyType key, bool create) -> page_id_t;
 
   /**
    * Get the bucket page_id corresponding to a key.
@@ -119,32 +146,42 @@ class DiskExtendibleHashTable {
    * @param dir_page a pointer to the hash table's directory page
    * @return the bucket page_id corresponding to the input key
    */
-  auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
+  auto KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
-   * Fetches the directory page from the buffer pool manager.
-   *
-   * @return a pointer to the directory page
+   * Call f with the bucket and then with each of its overflow pages, until f returns true. The caller holds the
+   * latch of the bucket, which covers its overflow pages.
+   * @return whether f returned true
+   */
+  template <typename F>
+  auto VisitChain(const HASH_TABLE_BUCKET_TYPE *bucket, F &&f) -> bool;
+
+  /**
+   * @return whether inserting (key, value) into the bucket would add the pair twice, or a second value for the key
+   * of a unique table. A key with a NULL column never clashes with another key.
    */
-  auto FetchDirectoryPage() -> HashTableDirectoryPage *;
+  auto Conflicts(const HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value) -> bool;
 
   /**
-   * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
+   * Insert (key, value) into the first page of the bucket's chain that has room.
    *
-   * @param bucket_page_id the page_id to fetch
-   * @return a pointer to a bucket page
+   * @param bucket the bucket, write-latched by the caller
+   * @param grow whether to append an overflow page if every page is full
+   * @return whether the pair was inserted
    */
-  auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
+  auto InsertIntoChain(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value, bool grow) -> bool;
 
   /**
    * Performs insertion with an optional bucket splitting.
    *
    * @param transaction a pointer to the current transaction
+   * @param directory_page_id the directory page of the key
    * @param key the key to insert
    * @param value the value to insert
    * @return whether or not the insertion was successful
    */
-  auto SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
+  auto SplitInsert(Transaction *transaction, page_id_t directory_page_id, const KeyType &key, const ValueType &value)
+      -> bool;
 
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
@@ -156,19 +193,19 @@ class DiskExtendibleHashTable {
    * 3. The bucket's local depth doesn't match its split image's local depth.
    *
    * @param transaction a pointer to the current transaction
+   * @param directory_page_id the directory page of the key
    * @param key the key that was removed
    * @param value the value that was removed
    */
-  void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
+  void Merge(Transaction *transaction, page_id_t directory_page_id, const KeyType &key, const ValueType &value);
 
   // member variables
-  page_id_t directory_page_id_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
-  ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
+  bool unique_;
 };
 
 }  // namespace bustub
@@ -30,6 +30,12 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Resizing is incremental: once half of the slots are taken, a new array of blocks twice as large is started next to
+ * the old one, and every insert and remove moves the next MIGRATE_STEP slots of the old array over to the new one.
+ * Inserts go to the new array; lookups and removes look in both until the old array is drained and dropped. Blocks
+ * are only created once a pair goes into them, so starting a resize costs a single header page, and no operation
+ * does more than a bounded amount of migration work.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -73,7 +79,8 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. The pairs move over to the new array a few at a
+   * time with the inserts and removes that follow.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
@@ -85,19 +92,48 @@ class LinearProbeHashTable {
   auto GetSize() -> size_t;
 
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
-  auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
-  void DeleteBlockPages(HashTableHeaderPage *old_header_page);
-  void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
-  auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
+  /** Number of slots of the old array that each insert or remove moves to the new one. */
+  static constexpr size_t MIGRATE_STEP = 16;
+
+  /** @return the slot at which the probe for key starts in an array of size slots */
+  auto StartSlot(const KeyType &key, size_t size) -> size_t;
+
+  /** Collects the values of key from the array of header_page_id. */
+  auto GetValueIn(page_id_t header_page_id, const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /** Removes the pair from the array of header_page_id. @return false if it is not there */
+  auto RemoveIn(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Puts the pair into the first free slot of the array of header_page_id, creating its block if needed.
+   * @return false if every slot is taken
+   */
+  auto ResizeInsert(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool;
+
+  /** Starts a new array of new_size slots; the current one becomes the old array, to be drained. */
+  void CreateNewBlockPages(size_t new_size);
+
+  /** Moves up to num_slots slots of the old array to the current one, and drops the old array once it is drained. */
+  void Migrate(size_t num_slots);
+
+  /** Deletes the blocks and the header page of an array. */
+  void DeleteBlockPages(page_id_t header_page_id);
 
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // the array being drained by an incremental resize, or INVALID_PAGE_ID
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // slots of the old array before this one have been moved already
+  size_t migrate_cursor_{0};
+  // occupied slots of the current array, tombstones included
+  size_t num_used_{0};
+  // pairs in the table, in either array
+  size_t num_pairs_{0};
+
+  // Readers are lookups, writers are inserts and removes, which move pairs during a resize
   ReaderWriterLatch table_latch_;
 
   // Hash function
@@ -54,6 +54,9 @@ class ExecutionEngine {
                ExecutorContext *exec_ctx) -> bool {
     BUSTUB_ASSERT((txn == exec_ctx->GetTransaction()), "Broken Invariant");
 
+    // Values and tuples built while the query runs come from its arena
+    ArenaPool::Scope arena_scope(exec_ctx->GetArena());
+
     // Construct the executor for the abstract plan node
     auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
@@ -64,6 +67,10 @@ class ExecutionEngine {
       executor->Init();
       PollExecutor(executor.get(), plan, result_set);
     } catch (const ExecutionException &ex) {
+      if (txn->GetState() == TransactionState::ABORTED) {
+        // the executor aborted the transaction, so the statement has to fail and roll back
+        throw;
+      }
 #ifndef NDEBUG
       LOG_ERROR("Error Encountered in Executor Execution: %s", ex.what());
 #endif
@@ -19,6 +19,7 @@
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "type/arena_pool.h"
 
 namespace bustub {
 /**
@@ -60,6 +61,9 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return the arena of the query, which frees everything allocated from it when the query ends */
+  auto GetArena() -> ArenaPool * { return &arena_; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +75,8 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The memory of the query */
+  ArenaPool arena_;
 };
 
 }  // namespace bustub
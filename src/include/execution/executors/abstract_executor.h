@@ -40,6 +40,8 @@ class AbstractExecutor {
 
   /**
    * Yield the next tuple from this executor.
+   * The tuple may be a view of bytes the executor owns, valid until the next call to Next() or Init(). A caller that
+   * keeps it longer copies it, which makes it a tuple of its own.
    * @param[out] tuple The next tuple produced by this executor
    * @param[out] rid The next tuple RID produced by this executor
    * @return `true` if a tuple was produced, `false` if there are no more tuples
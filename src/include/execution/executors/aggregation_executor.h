@@ -24,6 +24,7 @@
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
 #include "storage/table/tuple.h"
+#include "type/arena_pool.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -32,15 +33,22 @@ namespace bustub {
  * A simplified hash table that has all the necessary functionality for aggregations.
  */
 class SimpleAggregationHashTable {
+  /** The hash table is just a map from aggregate keys to aggregate values, with its nodes in the query arena */
+  using HashTable = std::unordered_map<AggregateKey, AggregateValue, std::hash<AggregateKey>, std::equal_to<>,
+                                       ArenaAllocator<std::pair<const AggregateKey, AggregateValue>>>;
+
  public:
   /**
    * Construct a new SimpleAggregationHashTable instance.
    * @param agg_exprs the aggregation expressions
    * @param agg_types the types of aggregations
+   * @param arena the arena of the query (see ExecutorContext::GetArena())
    */
   SimpleAggregationHashTable(const std::vector<AbstractExpressionRef> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
+                             const std::vector<AggregationType> &agg_types, ArenaPool *arena)
+      : ht_{0, std::hash<AggregateKey>{}, std::equal_to<>{}, HashTable::allocator_type{arena}},
+        agg_exprs_{agg_exprs},
+        agg_types_{agg_types} {}
 
   /** @return The initial aggregrate value for this aggregation executor */
   auto GenerateInitialAggregateValue() -> AggregateValue {
@@ -104,7 +112,7 @@ class SimpleAggregationHashTable {
   class Iterator {
    public:
     /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    explicit Iterator(HashTable::const_iterator iter) : iter_{iter} {}
 
     /** @return The key of the iterator */
     auto Key() -> const AggregateKey & { return iter_->first; }
@@ -126,7 +134,7 @@ class SimpleAggregationHashTable {
 
    private:
     /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    HashTable::const_iterator iter_;
   };
 
   /** @return Iterator to the start of the hash table */
@@ -136,8 +144,7 @@ class SimpleAggregationHashTable {
   auto End() -> Iterator { return Iterator{ht_.cend()}; }
 
  private:
-  /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  HashTable ht_;
   /** The aggregate expressions that we have */
   const std::vector<AbstractExpressionRef> &agg_exprs_;
   /** The types of aggregations that we have */
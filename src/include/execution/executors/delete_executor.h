@@ -60,5 +60,7 @@ class DeleteExecutor : public AbstractExecutor {
   const DeletePlanNode *plan_;
   /** The child executor from which RIDs for deleted tuples are pulled */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Whether the count of deleted rows has been emitted */
+  bool done_{false};
 };
 }  // namespace bustub
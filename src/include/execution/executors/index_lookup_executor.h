@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_lookup_executor.h
+//
+// Identification: src/include/execution/executors/index_lookup_executor.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <shared_mutex>
+#include <vector>
+
+#include "common/rid.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/index_lookup_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * IndexLookupExecutor produces the rows of a table that an index holds under one key.
+ */
+class IndexLookupExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index lookup executor.
+   * @param exec_ctx the executor context
+   * @param plan the index lookup plan to be executed
+   */
+  IndexLookupExecutor(ExecutorContext *exec_ctx, const IndexLookupPlanNode *plan);
+
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+ private:
+  /** The index lookup plan node to be executed. */
+  const IndexLookupPlanNode *plan_;
+  /** The table the index points into */
+  const TableInfo *table_info_{nullptr};
+  /** Keeps VACUUM from moving the tuples found under the key while they are read */
+  std::shared_lock<std::shared_mutex> scan_latch_;
+  /** The record ids found under the key, and how many of them were produced */
+  std::vector<RID> rids_;
+  size_t cursor_{0};
+};
+}  // namespace bustub
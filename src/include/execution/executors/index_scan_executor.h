@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <shared_mutex>
+#include <variant>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -42,7 +46,31 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** @return the key tuple holding the single integer value */
+  auto MakeKeyTuple(int32_t value) const -> Tuple;
+
+  /** @return the index key holding the single integer value */
+  template <size_t KeySize>
+  auto MakeKey(int32_t value) const -> GenericKey<KeySize>;
+
+  /** @return the output tuple of an index-only scan for an index entry, with NULL in the columns it does not store */
+  template <size_t KeySize>
+  auto EntryToTuple(const GenericKey<KeySize> &entry) const -> Tuple;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The index being scanned */
+  const IndexInfo *index_info_{nullptr};
+  /** The table the index points into */
+  const TableInfo *table_info_{nullptr};
+  /** Keeps VACUUM from moving the tuples the index points to while the scan is open */
+  std::shared_lock<std::shared_mutex> scan_latch_;
+  /** For index-only scans, the position of each output column in the index entry, or -1 if it is not stored there */
+  std::vector<int> entry_column_of_;
+  /** The scan position, already bounded to the plan's key range, for whichever key size the index has */
+  std::variant<BPlusTreeIndexIteratorForIntegerKey<4>, BPlusTreeIndexIteratorForIntegerKey<8>,
+               BPlusTreeIndexIteratorForIntegerKey<16>, BPlusTreeIndexIteratorForIntegerKey<32>,
+               BPlusTreeIndexIteratorForIntegerKey<64>, ARTIterator>
+      iter_;
 };
 }  // namespace bustub
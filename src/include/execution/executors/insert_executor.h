@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -25,9 +26,15 @@ namespace bustub {
 /**
  * InsertExecutor executes an insert on a table.
  * Inserted values are always pulled from a child executor.
+ *
+ * Inserts of up to BULK_INSERT_BATCH_SIZE rows go in one row at a time and reuse free space anywhere in the table.
+ * Larger ones are appended to the end of the table batch by batch, and each batch goes into every index at once.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
+  /** Number of rows an insert takes at least, and a bulk append takes at most at once */
+  static constexpr size_t BULK_INSERT_BATCH_SIZE = 1024;
+
   /**
    * Construct a new InsertExecutor instance.
    * @param exec_ctx The executor context
@@ -55,8 +62,20 @@ class InsertExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /**
+   * Insert tuples into the table and all of its indexes.
+   * @param tuples The tuples to insert
+   * @param append Whether to append them to the end of the table, rather than insert them one by one
+   * @return The number of tuples inserted
+   */
+  auto InsertBatch(const std::vector<Tuple> &tuples, bool append) -> int32_t;
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
+  /** The child executor from which inserted tuples are pulled */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Whether the count of inserted rows has been emitted */
+  bool done_{false};
 };
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -48,7 +49,24 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Probe the index for the current outer tuple, filling inner_rids_. */
+  void ProbeInner();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The outer table */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The index on the inner table, and the inner table itself */
+  const IndexInfo *index_info_{nullptr};
+  const TableInfo *inner_table_info_{nullptr};
+  /** Keeps VACUUM from moving inner tuples while the join is open */
+  std::shared_lock<std::shared_mutex> scan_latch_;
+  /** The current outer tuple, whether there is one, and whether it has been joined with any inner tuple */
+  Tuple outer_tuple_;
+  bool has_outer_{false};
+  bool outer_matched_{false};
+  /** The inner record ids under the current outer tuple's key, and how many of them were read */
+  std::vector<RID> inner_rids_;
+  size_t inner_cursor_{0};
 };
 }  // namespace bustub
@@ -25,6 +25,8 @@ namespace bustub {
 
 /**
  * The ProjectionExecutor executor executes a projection.
+ *
+ * Every output tuple is a view of one buffer, valid until the next call to Next().
  */
 class ProjectionExecutor : public AbstractExecutor {
  public:
@@ -56,5 +58,14 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The current child tuple, often a view the child owns */
+  Tuple child_tuple_;
+
+  /** The values of the current output tuple */
+  std::vector<Value> values_;
+
+  /** The bytes of the current output tuple */
+  std::vector<char> buffer_;
 };
 }  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <memory>
+#include <shared_mutex>
 #include <vector>
 
 #include "execution/executor_context.h"
@@ -23,6 +25,9 @@ namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * It copies the table a page at a time and yields views into the copy, so a row costs no allocation and no copy of
+ * its own. A tuple it yields is valid until the next call to Next().
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -50,5 +55,17 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned */
+  const TableInfo *table_info_{nullptr};
+  /** Keeps VACUUM from moving tuples and dropping pages while the scan is open */
+  std::shared_lock<std::shared_mutex> scan_latch_;
+  /** The page to copy once the tuples of the current one run out */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** A copy of the current page */
+  std::vector<char> page_copy_;
+  /** Views of the tuples of the current page */
+  std::vector<Tuple> tuples_;
+  /** The next tuple of tuples_ to yield */
+  size_t cursor_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_lookup_plan.h
+//
+// Identification: src/include/execution/plans/index_lookup_plan.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "catalog/catalog.h"
+#include "execution/plans/abstract_plan.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * IndexLookupPlanNode produces the rows of a table whose indexed column equals a constant key, probing the index
+ * once instead of walking a key range. The optimizer plans it on hash indexes, which cannot be scanned in key order.
+ */
+class IndexLookupPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new index lookup plan node.
+   * @param output the output format of this plan node, which is the schema of the table
+   * @param index_oid the identifier of the index to probe
+   * @param key the value of the indexed column to look up
+   */
+  IndexLookupPlanNode(SchemaRef output, index_oid_t index_oid, Value key)
+      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid), key_(std::move(key)) {}
+
+  auto GetType() const -> PlanType override { return PlanType::IndexLookup; }
+
+  /** @return the identifier of the index to probe */
+  auto GetIndexOid() const -> index_oid_t { return index_oid_; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(IndexLookupPlanNode);
+
+  /** The index to probe. */
+  index_oid_t index_oid_;
+
+  /** The key to look up */
+  Value key_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    return fmt::format("IndexLookup {{ index_oid={}, key={} }}", index_oid_, key_.ToString());
+  }
+};
+
+}  // namespace bustub
@@ -12,14 +12,27 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "type/value.h"
 
 namespace bustub {
+
+/** One end of the key range of an index scan. */
+struct IndexScanBound {
+  /** The bounding key */
+  Value key_;
+  /** Whether keys equal to key_ are part of the range */
+  bool inclusive_;
+
+  auto ToString() const -> std::string { return key_.ToString(); }
+};
+
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
  */
@@ -29,9 +42,20 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param table_oid the identifier of table to be scanned
+   * @param reverse whether keys are produced in descending order
+   * @param lower_bound the smallest keys to produce, or std::nullopt to start at the first key
+   * @param upper_bound the largest keys to produce, or std::nullopt to stop at the last key
+   * @param index_only build the output from the index entries without reading the table
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, bool reverse = false,
+                    std::optional<IndexScanBound> lower_bound = std::nullopt,
+                    std::optional<IndexScanBound> upper_bound = std::nullopt, bool index_only = false)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        reverse_(reverse),
+        lower_bound_(std::move(lower_bound)),
+        upper_bound_(std::move(upper_bound)),
+        index_only_(index_only) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,11 +67,31 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** Whether the scan runs from the largest key down */
+  bool reverse_;
+
+  /** Bounds of the scanned key range; a missing bound leaves that end open */
+  std::optional<IndexScanBound> lower_bound_;
+  std::optional<IndexScanBound> upper_bound_;
+
+  /**
+   * Whether the output comes from the index entries alone. The output keeps the table's columns, but only those
+   * stored in the index (its key and included columns) are filled in; the rest are NULL, and nothing above the scan
+   * reads them.
+   */
+  bool index_only_{false};
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string range;
+    if (lower_bound_.has_value() || upper_bound_.has_value()) {
+      range = fmt::format(", range={}{}, {}{}", lower_bound_.has_value() && lower_bound_->inclusive_ ? "[" : "(",
+                          lower_bound_.has_value() ? lower_bound_->ToString() : "-inf",
+                          upper_bound_.has_value() ? upper_bound_->ToString() : "+inf",
+                          upper_bound_.has_value() && upper_bound_->inclusive_ ? "]" : ")");
+    }
+    return fmt::format("IndexScan {{ index_oid={}{}{}{} }}", index_oid_, reverse_ ? ", reverse" : "",
+                       index_only_ ? ", index_only" : "", range);
   }
 };
 
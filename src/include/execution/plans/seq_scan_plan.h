@@ -13,14 +13,17 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/catalog.h"
 #include "catalog/schema.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "fmt/ranges.h"
 
 namespace bustub {
 
@@ -33,13 +36,18 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * Construct a new SeqScanPlanNode instance.
    * @param output The output schema of this sequential scan plan node
    * @param table_oid The identifier of table to be scanned
+   * @param columns The columns read above the scan, or std::nullopt for all of them
+   * @param ranges Bounds on columns that every tuple the scan yields is within
    */
   SeqScanPlanNode(SchemaRef output, table_oid_t table_oid, std::string table_name,
-                  AbstractExpressionRef filter_predicate = nullptr)
+                  AbstractExpressionRef filter_predicate = nullptr,
+                  std::optional<std::vector<uint32_t>> columns = std::nullopt, std::vector<ColumnRange> ranges = {})
       : AbstractPlanNode(std::move(output), {}),
         table_oid_{table_oid},
         table_name_(std::move(table_name)),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        columns_(std::move(columns)),
+        ranges_(std::move(ranges)) {}
 
   /** @return The type of the plan node */
   auto GetType() const -> PlanType override { return PlanType::SeqScan; }
@@ -62,12 +70,32 @@ class SeqScanPlanNode : public AbstractPlanNode {
   */
   AbstractExpressionRef filter_predicate_;
 
+  /**
+   * The columns read above the scan, if it is known. A scan of a PAX table reads only these; the other columns of
+   * its output are NULL.
+   */
+  std::optional<std::vector<uint32_t>> columns_;
+
+  /** Bounds the filters above the scan put on columns. A scan of a PAX table skips the pages outside of them. */
+  std::vector<ColumnRange> ranges_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
+    std::string filter;
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      filter = fmt::format(", filter={}", filter_predicate_);
+    }
+    std::string columns;
+    if (columns_.has_value()) {
+      columns = fmt::format(", columns={}", *columns_);
+    }
+    std::string ranges;
+    for (const auto &range : ranges_) {
+      ranges += fmt::format(", #{}=[{}, {}]", range.column_idx_,
+                            range.lower_.has_value() ? range.lower_->ToString() : "-inf",
+                            range.upper_.has_value() ? range.upper_->ToString() : "+inf");
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{}{}{} }}", table_name_, filter, columns, ranges);
   }
 };
 
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -11,6 +13,7 @@
 #include "concurrency/transaction.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
 
 #define BUSTUB_OPTIMIZER_HACK_REMOVE_AFTER_2022_FALL
 
@@ -85,7 +88,37 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
+  /**
+   * @brief let an index scan skip the table when the plan above it only reads columns stored in the index. A range
+   * filter over a seq scan whose columns an index covers also becomes such an index-only scan.
+   */
+  auto OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief probe a hash index once for a filter over a seq scan that fixes the indexed column to a constant, since a
+   * hash index has no key order to scan.
+   */
+  auto OptimizeFilterAsIndexLookup(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief tell a seq scan of a PAX table which columns the projection or aggregation above it reads, and the
+   * ranges its filters put on columns, so that it reads only those columns of the pages its ranges may match.
+   */
+  auto OptimizeColumnarScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief add the columns of the child tuple that `expr` reads to `columns`. */
+  static void CollectColumns(const AbstractExpressionRef &expr, std::unordered_set<uint32_t> *columns);
+
+  /**
+   * @brief fold the conjuncts of a predicate that compare column `col_idx` with an integer constant into the key range
+   * of an index scan on that column.
+   * @return the conjuncts that could not be folded, ANDed together, or nullptr if every conjunct was folded
+   */
+  auto FoldPredicateIntoIndexRange(const AbstractExpressionRef &predicate, uint32_t col_idx,
+                                   std::optional<IndexScanBound> *lower, std::optional<IndexScanBound> *upper)
+      -> AbstractExpressionRef;
+
+  /** @brief check if the index can be matched, preferring a hash index over ordered ones for these point lookups */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
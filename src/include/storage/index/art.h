@@ -0,0 +1,250 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art.h
+//
+// Identification: src/include/storage/index/art.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * Key of an adaptive radix tree: a byte string that compares (bytewise, as unsigned chars) the way the key it stands
+ * for does. The keys of one tree must be prefix free, i.e. no key may be a proper prefix of another, which holds for
+ * fixed-length keys and for the terminated encodings ARTIndex builds.
+ */
+using ARTKey = std::string;
+
+/** Max number of prefix bytes stored in an inner node; longer prefixes are checked against a leaf below the node. */
+static constexpr uint32_t ART_MAX_PREFIX = 8;
+
+/** The kind of a tree node. Inner nodes are named after the number of children they hold. */
+enum class ARTNodeType : uint8_t { Leaf, Node4, Node16, Node48, Node256 };
+
+/**
+ * Header shared by all nodes of an adaptive radix tree.
+ *
+ * Inner nodes are protected by optimistic lock coupling: readers never write to a node, they remember its version
+ * before reading and restart if it changed by the time they are done. Writers lock the (at most two) nodes they change
+ * by bumping the version, and mark nodes they replace as obsolete so that late readers restart too. Leaves are
+ * immutable once linked in; changing the values of a key links in a new leaf.
+ */
+struct ARTNode {
+  explicit ARTNode(ARTNodeType type) : type_(type) {}
+
+  /** bit 0 is set once the node is unlinked, bit 1 while a writer holds the node, the rest counts the writes */
+  std::atomic<uint64_t> version_{0};
+  ARTNodeType type_;
+  /** number of children */
+  uint16_t count_{0};
+  /** length of the compressed path above the children, of which the first ART_MAX_PREFIX bytes are kept */
+  uint32_t prefix_len_{0};
+  uint8_t prefix_[ART_MAX_PREFIX]{};
+};
+
+/** A key and the record ids stored under it. */
+struct ARTLeaf : public ARTNode {
+  ARTLeaf(ARTKey key, std::vector<RID> values)
+      : ARTNode(ARTNodeType::Leaf), key_(std::move(key)), values_(std::move(values)) {}
+
+  const ARTKey key_;
+  const std::vector<RID> values_;
+};
+
+struct ARTNode4 : public ARTNode {
+  ARTNode4() : ARTNode(ARTNodeType::Node4) {}
+  uint8_t keys_[4]{};
+  ARTNode *children_[4]{};
+};
+
+struct ARTNode16 : public ARTNode {
+  ARTNode16() : ARTNode(ARTNodeType::Node16) {}
+  uint8_t keys_[16]{};
+  ARTNode *children_[16]{};
+};
+
+struct ARTNode48 : public ARTNode {
+  static constexpr uint8_t EMPTY_SLOT = 48;
+  ARTNode48() : ARTNode(ARTNodeType::Node48) {
+    for (auto &index : child_index_) {
+      index = EMPTY_SLOT;
+    }
+  }
+  /** slot in children_ of the child for each key byte, or EMPTY_SLOT */
+  uint8_t child_index_[256];
+  ARTNode *children_[48]{};
+};
+
+struct ARTNode256 : public ARTNode {
+  ARTNode256() : ARTNode(ARTNodeType::Node256) {}
+  ARTNode *children_[256]{};
+};
+
+/**
+ * Epoch based reclamation of unlinked nodes. Optimistic readers may still be looking at a node after a writer
+ * unlinked it, so unlinked nodes are only freed once every operation that was running at the time has finished.
+ *
+ * Operations register in the current epoch. A node retired in epoch e is freed once the epoch has moved on to e + 2;
+ * the epoch only moves from e to e + 1 once no operation is left in e - 1.
+ */
+class ARTEpochManager {
+ public:
+  ARTEpochManager() = default;
+  ~ARTEpochManager();
+
+  DISALLOW_COPY_AND_MOVE(ARTEpochManager);
+
+  /** Register an operation. @return the epoch to pass to Exit() */
+  auto Enter() -> uint64_t;
+
+  /** Unregister an operation, freeing old nodes if the epoch can move on. */
+  void Exit(uint64_t epoch);
+
+  /** Free `node` once no running operation can reach it any more. */
+  void Retire(ARTNode *node);
+
+  /** Free every retired node right away. Only safe while no operation runs. */
+  void ReclaimAll();
+
+ private:
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<uint64_t> active_[3]{};
+  std::atomic<size_t> retired_count_{0};
+  /** protects retired_ and moving the epoch on */
+  std::mutex latch_;
+  std::vector<ARTNode *> retired_[3];
+};
+
+/**
+ * Adaptive radix tree (Leis et al., ICDE 2013) mapping byte string keys to record ids, kept in memory only.
+ *
+ * Inner nodes grow from 4 to 16, 48 and 256 children as keys are added and shrink back as they go. Chains of nodes
+ * with a single child are collapsed into a prefix of the node below. The root is a Node256 that is never replaced.
+ *
+ * All operations are safe to call concurrently (optimistic lock coupling, see ARTNode). In a unique tree a key holds
+ * one record id; otherwise a key holds every record id it was inserted with, sorted like in a non-unique BPlusTree.
+ */
+class AdaptiveRadixTree {
+ public:
+  explicit AdaptiveRadixTree(bool unique = true);
+  ~AdaptiveRadixTree();
+
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree);
+
+  /**
+   * @return false, leaving the tree untouched, if the pair is present or the tree is unique and has the key. With
+   * `allow_duplicate` a unique tree keeps every value of the key instead, as an index does for NULL keys.
+   */
+  auto Insert(const ARTKey &key, const RID &value, bool allow_duplicate = false) -> bool;
+
+  /** Remove the pair (key, value). @return false if it is not in the tree */
+  auto Remove(const ARTKey &key, const RID &value) -> bool;
+
+  /** Remove a key with all of its values. @return false if it is not in the tree */
+  auto Remove(const ARTKey &key) -> bool;
+
+  /** Append the values of key to result. @return false if the key is not in the tree */
+  auto GetValue(const ARTKey &key, std::vector<RID> *result) -> bool;
+
+  /**
+   * Load entries into an empty tree, building every node at its final size. Entries need not be sorted. Must not run
+   * concurrently with other operations.
+   * @return false, leaving the tree empty, if the tree is unique and a key repeats
+   */
+  auto BulkLoad(std::vector<std::pair<ARTKey, RID>> entries) -> bool;
+
+  /**
+   * Collect the leaves of up to `limit` keys in key order, starting at `start` and stopping after `stop`. Keys equal to
+   * `start` are skipped unless `start_inclusive`. With `reverse`, keys come in descending order, and `start` is the
+   * upper end of the range and `stop` the lower one.
+   */
+  void Scan(const std::optional<ARTKey> &start, bool start_inclusive, const std::optional<ARTKey> &stop, bool reverse,
+            size_t limit, std::vector<std::pair<ARTKey, std::vector<RID>>> *result);
+
+  auto IsEmpty() -> bool;
+
+  /** @return whether the tree keeps a single value per key */
+  auto IsUnique() const -> bool { return unique_; }
+
+ private:
+  /** Run `op` until it completes without running into a concurrent writer. */
+  template <typename Op>
+  auto Retry(Op &&op) -> decltype(op(nullptr));
+
+  auto TryInsert(const ARTKey &key, const RID &value, bool allow_duplicate, bool *restart) -> bool;
+  auto TryRemove(const ARTKey &key, const RID *value, bool *restart) -> bool;
+  auto TryGetValue(const ARTKey &key, std::vector<RID> *result, bool *restart) -> bool;
+  // Scan the subtree of node, whose keys share their first `level` bytes, and which was read from parent at
+  // parent_version. `start` is set while the subtree is on the path of the start key. Returns true once `limit` keys
+  // or the stop key are reached.
+  auto ScanNode(ARTNode *node, const ARTNode *parent, uint64_t parent_version, uint32_t level, const ARTKey *start,
+                bool start_inclusive, const std::optional<ARTKey> &stop, bool reverse, size_t limit,
+                std::vector<std::pair<ARTKey, std::vector<RID>>> *result, bool *restart) -> bool;
+
+  // Builds the subtree for entries [begin, end), whose keys share their first `level` bytes, from sorted leaves.
+  auto Build(std::vector<ARTLeaf *> *leaves, size_t begin, size_t end, uint32_t level) -> ARTNode *;
+
+  ARTNode256 *root_;
+  ARTEpochManager epoch_manager_;
+  const bool unique_;
+};
+
+/**
+ * Iterator over a key range of an AdaptiveRadixTree, ascending or descending. It reads the tree in batches of keys,
+ * each read consistently; changes made between batches show up as in a B+ tree iterator that moves from leaf to leaf.
+ */
+class ARTIterator {
+ public:
+  /** Iterator that is already at the end. */
+  ARTIterator() = default;
+
+  /**
+   * @param tree the tree to read
+   * @param start first key of the range (last one if reverse), or nullopt to start at the smallest (largest) key
+   * @param stop last key of the range (first one if reverse), or nullopt to run to the end of the tree
+   */
+  ARTIterator(AdaptiveRadixTree *tree, std::optional<ARTKey> start, std::optional<ARTKey> stop, bool reverse);
+
+  auto IsEnd() const -> bool { return tree_ == nullptr; }
+
+  /** @return the current key and one of its record ids */
+  auto operator*() -> std::pair<const ARTKey &, RID>;
+
+  auto operator++() -> ARTIterator &;
+
+  auto operator==(const ARTIterator &itr) const -> bool;
+
+  auto operator!=(const ARTIterator &itr) const -> bool { return !(*this == itr); }
+
+ private:
+  static constexpr size_t BATCH_SIZE = 64;
+
+  /** Read the next batch of keys after the last one returned, or move to the end if there is none. */
+  void Refill(bool start_inclusive);
+
+  AdaptiveRadixTree *tree_{nullptr};
+  std::optional<ARTKey> start_;
+  std::optional<ARTKey> stop_;
+  bool reverse_{false};
+  std::vector<std::pair<ARTKey, std::vector<RID>>> batch_;
+  size_t key_index_{0};
+  size_t value_index_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "storage/index/art.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+/**
+ * In-memory index on an adaptive radix tree. Unlike BPlusTreeIndex it does not go through the buffer pool, which
+ * makes it the cheaper choice for tables that fit in memory; its contents are lost when the process exits.
+ *
+ * Index keys are turned into byte strings that sort like the keys (see NormalizeKey()), so the tree also answers
+ * range scans. Entries hold the key and the RID only; included columns are not supported.
+ */
+class ARTIndex : public Index {
+ public:
+  explicit ARTIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /**
+   * Fill the still empty index with `entries`, which need not be sorted. @return false if a unique key without NULL
+   * columns repeats
+   */
+  auto BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries) -> bool;
+
+  auto GetBeginIterator() -> ARTIterator;
+
+  /** @return an iterator over the keys from `key` to `stop_key`, both included */
+  auto GetBeginIterator(const Tuple &key, const Tuple &stop_key) -> ARTIterator;
+
+  /** @return an iterator over the keys from `key` down to `stop_key`, both included */
+  auto GetReverseBeginIterator(const Tuple &key, const Tuple &stop_key) -> ARTIterator;
+
+  auto GetEndIterator() -> ARTIterator;
+
+  /**
+   * @return the tree key for an index key. Each column is a 0 byte if it is NULL, and otherwise a 1 byte followed by
+   * the value: integers big endian with the sign bit flipped, decimals as their bits with the sign (or, for negative
+   * numbers, every bit) flipped, and strings with 0 bytes escaped as 0 0xff and terminated by 0 0. Byte strings
+   * compare like the keys, and none is a prefix of another. Sets `has_null` if a column is NULL.
+   */
+  auto NormalizeKey(const Tuple &key, bool *has_null = nullptr) const -> ARTKey;
+
+ protected:
+  // container
+  AdaptiveRadixTree container_;
+};
+
+}  // namespace bustub
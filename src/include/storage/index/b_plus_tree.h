@@ -13,18 +13,26 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique by default; a non-unique tree keeps the record ids of a
+ *     duplicated key in a chain of posting pages hanging off its leaf entry,
+ *     and so does a unique tree for a key with a NULL column
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) Pages carry Lehman-Yao right links and high keys, so readers and inserts
+ *     move right past splits instead of waiting for them to reach the parent
  */
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <deque>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <shared_mutex>
+#include <type_traits>
 #include <vector>
 
 #include "common/config.h"
@@ -33,6 +41,7 @@
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 #include "storage/page/b_plus_tree_root_page.h"
 #include "storage/page/page_guard.h"
 
@@ -50,10 +59,24 @@ class Context {
   page_id_t root_page_id_{INVALID_PAGE_ID};
   std::deque<WritePageGuard> write_set_;
   std::deque<ReadPageGuard> read_set_;
+  // internal pages passed on the way down, root first
+  std::vector<page_id_t> path_;
+  // whether pages are only rebalanced once they are (nearly) empty; see BPlusTree::SetLazyMerge()
+  bool lazy_merge_{false};
 
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
 };
 
+/** Structure changes made by a B+ tree since it was created. Sample it twice to get rates for a workload. */
+struct BPlusTreeStats {
+  // pages split by inserts, leaves and internal pages alike
+  uint64_t splits_{0};
+  // pages merged into a sibling by removes or compaction
+  uint64_t merges_{0};
+  // entries borrowed from a sibling to fix an underflowing page
+  uint64_t redistributions_{0};
+};
+
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 // Main class providing the API for the Interactive B+ Tree.
 INDEX_TEMPLATE_ARGUMENTS
@@ -64,16 +87,24 @@ class BPlusTree {
  public:
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int internal_max_size = INTERNAL_PAGE_SIZE, bool unique = true);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
-  // Insert a key-value pair into this B+ tree.
+  // Whether a key maps to at most one value.
+  auto IsUnique() const -> bool { return unique_; }
+
+  // Insert a key-value pair into this B+ tree. A unique tree rejects a key that is already present, and a non-unique
+  // tree rejects a pair that is already present.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *txn = nullptr) -> bool;
 
-  // Remove a key and its value from this B+ tree.
-  void Remove(const KeyType &key, Transaction *txn);
+  // Remove a key and its value from this B+ tree. Returns false if the key is not in the tree.
+  auto Remove(const KeyType &key, Transaction *txn) -> bool;
+
+  // Remove one key-value pair, leaving the other values of the key in place. Returns false if the pair is not in the
+  // tree.
+  auto Remove(const KeyType &key, const ValueType &value, Transaction *txn) -> bool;
 
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
@@ -81,6 +112,9 @@ class BPlusTree {
   // Return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
+  // Return the number of levels, counting the leaves
+  auto GetHeight() -> int;
+
   // Index iterator
   auto Begin() -> INDEXITERATOR_TYPE;
 
@@ -88,6 +122,32 @@ class BPlusTree {
 
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  // Iterate upward from the first key >= key, ending after the last key <= stop_key.
+  auto Begin(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE;
+
+  // Iterate downward from the largest key.
+  auto RBegin() -> INDEXITERATOR_TYPE;
+
+  // Iterate downward from the largest key <= key.
+  auto RBegin(const KeyType &key) -> INDEXITERATOR_TYPE;
+
+  // Iterate downward from the largest key <= key, ending after the smallest key >= stop_key.
+  auto RBegin(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE;
+
+  // Number of leaves an iterator asks the buffer pool to prefetch ahead of itself; 0 disables prefetching.
+  void SetIteratorPrefetchDepth(int depth) { iterator_prefetch_depth_ = depth; }
+
+  // With lazy merging, removes leave pages under their minimum size alone: a leaf is only merged away once it is
+  // empty, and an internal page once it has a single child. Removes then rarely need more than the leaf latch, and
+  // delete-then-reinsert workloads stop splitting and merging the same pages. Compact() rebalances what is left.
+  void SetLazyMerge(bool lazy_merge) { lazy_merge_ = lazy_merge; }
+
+  // Merge or refill every non-root leaf under its minimum size, as an eager remove would have. Runs alongside other
+  // operations, taking the tree's structure latch for one leaf at a time. Returns the number of leaves fixed up.
+  auto Compact() -> int;
+
+  auto GetStats() const -> BPlusTreeStats;
+
   // Print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -101,6 +161,8 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
  private:
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
+
   /* Debug Routines for FREE!! */
   void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
 
@@ -112,6 +174,94 @@ class BPlusTree {
     }
   }
 
+  // Whether a remove leaves the page at or above its minimum size, so latches above it can be released.
+  auto IsSafeToRemove(const BPlusTreePage *page, bool is_root, bool lazy_merge) const -> bool;
+
+  // Size below which a non-root page is rebalanced.
+  auto UnderflowSize(const BPlusTreePage *page, bool lazy_merge) const -> int;
+
+  // Release the header page and every latched page above the last one in the write set.
+  void ReleaseAncestors(Context *ctx);
+
+  // Latch crab down to the leaf responsible for key, with write latches; pages stay latched in ctx->write_set_
+  // until a page that cannot underflow is reached. Only used with structure_latch_ held exclusively, when no split
+  // is half done. Returns false if the tree is empty.
+  auto FindLeafPessimistic(const KeyType &key, Context *ctx) -> bool;
+
+  // Follow right links from the page in guard until that page covers key (the Lehman-Yao "move right"). Each
+  // sibling is latched before the page to its left is released.
+  template <typename Guard>
+  void MoveRight(Guard *guard, const KeyType &key);
+
+  // Read latch crab down to the leaf responsible for key, moving right past splits that have not reached the
+  // parent yet, and record the internal pages on the way in ctx->path_. If latch_leaf, the leaf is write latched
+  // and left alone in ctx->write_set_. Returns false if the tree is empty.
+  auto FindLeafOptimistic(const KeyType &key, Context *ctx, bool latch_leaf = true) -> bool;
+
+  // Create a page through the buffer pool, failing loudly if every frame is pinned.
+  auto NewTreePage(page_id_t *page_id) -> BasicPageGuard;
+
+  // Insert the separator key and the new right sibling new_page_id of old_page_id, which sits `height` levels
+  // above the leaves, into the level above, splitting up the tree as needed. Only one level is latched at a time:
+  // the split page (the last page in ctx->write_set_) is released before its parent, found through ctx->path_, is
+  // latched.
+  void InsertIntoParent(Context *ctx, page_id_t old_page_id, int height, const KeyType &key, page_id_t new_page_id);
+
+  // Remove the entry for key, or only the pair (key, *value) if value is set. Returns whether anything was removed.
+  auto RemoveEntry(const KeyType &key, const ValueType *value) -> bool;
+
+  // Whether the key may hold several values: any key of a non-unique tree, and a key with a NULL column, which never
+  // equals another key for uniqueness.
+  auto AllowsDuplicates(const KeyType &key) const -> bool { return !unique_ || comparator_.HasNull(key); }
+
+  // Add value to the values of a key that allows duplicates at index in a write latched leaf, starting a posting
+  // list if the key has a single value so far. Returns false if the pair is already present.
+  auto InsertIntoPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool;
+
+  // Remove value from the posting list of the key at index in a write latched leaf, unlinking pages that empty, and
+  // put the last value back inline once only one is left. Returns false if value is not in the list.
+  auto RemoveFromPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool;
+
+  // Append the values of the posting list starting at head_page_id to result. The caller latches the leaf entry.
+  void CollectPostingList(page_id_t head_page_id, std::vector<ValueType> *result);
+
+  // Free every page of the posting list starting at head_page_id, once its leaf entry is gone.
+  void DeletePostingList(page_id_t head_page_id);
+
+  // Free a page that has left the tree. A page still pinned, e.g. by an iterator that prefetched it, cannot be deleted
+  // yet; it is kept in pending_deletes_ and deleted by a later call once the pin is gone.
+  void FreePage(page_id_t page_id);
+
+  // Fix up the underflowing last page in ctx->write_set_ by borrowing from or merging with a sibling.
+  void HandleUnderflow(Context *ctx);
+
+  // Descend with read latches to the leftmost leaf (key == nullptr), or to the leaf responsible for key.
+  // Returns std::nullopt if the tree is empty.
+  auto FindLeafRead(const KeyType *key) -> std::optional<ReadPageGuard>;
+
+  // Reverse iterator starting at the largest key <= key.
+  auto ReverseBegin(const KeyType &key, std::optional<KeyType> stop_key) -> INDEXITERATOR_TYPE;
+
+  // Descend with read latches to the rightmost leaf. Returns std::nullopt if the tree is empty.
+  auto FindLastLeaf() -> std::optional<ReadPageGuard>;
+
+  // Find the largest key < key: returns its read latched leaf and sets *index to its slot, or std::nullopt if
+  // every key is >= key. Used by reverse iterators that cannot latch the left neighbour in order.
+  auto FindLeafBefore(const KeyType &key, int *index) -> std::optional<ReadPageGuard>;
+
+  // Collect the ids of up to count leaves after leaf_page_id, which covers key, in iteration order (before it, if
+  // reverse), from the internal pages above it. The caller holds a leaf latch, so pages are only try-latched, and the
+  // search gives up rather than wait. Reverse collection stops at the first page of the parent, since internal pages
+  // have no left links.
+  void CollectLeavesAhead(const KeyType &key, page_id_t leaf_page_id, bool reverse, int count,
+                          std::vector<page_id_t> *leaves);
+
+  // Right link of any tree page; sets *high_key to the page's high key when the link is valid.
+  auto RightLink(const BPlusTreePage *page, KeyType *high_key) const -> page_id_t;
+
+  // Point the back link of the leaf after leaf_page_id at it, after a split or merge changed its right neighbour.
+  void FixPrevLink(const LeafPage *leaf, page_id_t leaf_page_id);
+
   // member variable
   std::string index_name_;
   BufferPoolManager *bpm_;
@@ -120,6 +270,18 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  bool unique_;
+  // Inserts hold this shared and removes that merge or redistribute pages hold it exclusively, so structural
+  // removes never meet a split whose separator has not reached the parent yet. Readers never take it.
+  std::shared_mutex structure_latch_;
+  // Pages that left the tree while still pinned, guarded by pending_deletes_latch_.
+  std::vector<page_id_t> pending_deletes_;
+  std::mutex pending_deletes_latch_;
+  std::atomic<int> iterator_prefetch_depth_{INDEX_ITERATOR_PREFETCH_DEPTH};
+  std::atomic<bool> lazy_merge_{false};
+  std::atomic<uint64_t> splits_{0};
+  std::atomic<uint64_t> merges_{0};
+  std::atomic<uint64_t> redistributions_{0};
 };
 
 }  // namespace bustub
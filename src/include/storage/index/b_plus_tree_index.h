@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -29,16 +30,30 @@ class BPlusTreeIndex : public Index {
  public:
   BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
 
-  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  /** Inserts the batch in key order, so that consecutive inserts land in the same leaves. */
+  auto InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids, Transaction *transaction)
+      -> bool override;
 
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  auto LookupPageCount() -> size_t override;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  auto GetBeginIterator(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE;
+
+  auto GetReverseBeginIterator() -> INDEXITERATOR_TYPE;
+
+  auto GetReverseBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
+
+  auto GetReverseBeginIterator(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE;
+
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
  protected:
@@ -59,4 +74,46 @@ using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/**
+ * An index with included columns keeps them after the integer in its keys, so it uses one of the wider key sizes the
+ * tree is instantiated for. Keys of every size compare on the integer alone.
+ */
+template <size_t KeySize>
+using BPlusTreeIndexForIntegerKey = BPlusTreeIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+template <size_t KeySize>
+using BPlusTreeIndexIteratorForIntegerKey = IndexIterator<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+
+/** @return the smallest key size that holds index entries of `entry_size` bytes, or 0 if they are too large */
+inline auto IntegerIndexKeySize(size_t entry_size) -> size_t {
+  for (size_t key_size : {4, 8, 16, 32, 64}) {
+    if (entry_size <= key_size) {
+      return key_size;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Call `f` with `std::integral_constant<size_t, key_size>`, so that code working on an integer index can pick the
+ * template instantiation for a key size that is only known at run time.
+ * @param key_size a key size returned by IntegerIndexKeySize()
+ */
+template <typename F>
+auto DispatchIntegerIndexKeySize(size_t key_size, F &&f) {
+  switch (key_size) {
+    case 4:
+      return f(std::integral_constant<size_t, 4>{});
+    case 8:
+      return f(std::integral_constant<size_t, 8>{});
+    case 16:
+      return f(std::integral_constant<size_t, 16>{});
+    case 32:
+      return f(std::integral_constant<size_t, 32>{});
+    case 64:
+      return f(std::integral_constant<size_t, 64>{});
+    default:
+      UNREACHABLE("no integer index with this key size");
+  }
+}
+
 }  // namespace bustub
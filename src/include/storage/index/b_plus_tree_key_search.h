@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/index/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/**
+ * Key ranges at most this long are searched linearly with vector compares instead of being halved further.
+ * Branch-free linear scans beat binary search up to a few cache lines of keys.
+ */
+static constexpr int SIMD_SEARCH_WINDOW = 64;
+
+/** Width in bytes of the vectors used by the integer key search (one AVX2 register, or two SSE/NEON registers). */
+static constexpr int SIMD_SEARCH_WIDTH = 32;
+
+/**
+ * Lower bound over a sorted array of native integers: returns the first index in [lo, hi) whose value is not less
+ * than target, or hi if there is none.
+ *
+ * The range is halved until it fits in SIMD_SEARCH_WINDOW, and the rest is counted with vector compares. Since the
+ * array is sorted, the number of elements smaller than target is exactly the offset of the lower bound. GCC/Clang
+ * vector extensions lower to SSE2/AVX2 on x86 and NEON on ARM, and to a scalar loop anywhere else.
+ *
+ * `data` may be unaligned and is read with memcpy.
+ */
+template <typename T>
+inline auto IntegerLowerBound(const char *data, int lo, int hi, T target) -> int {
+  auto load = [data](int i) {
+    T value;
+    memcpy(&value, data + static_cast<size_t>(i) * sizeof(T), sizeof(T));
+    return value;
+  };
+
+  while (hi - lo > SIMD_SEARCH_WINDOW) {
+    int mid = lo + (hi - lo) / 2;
+    if (load(mid) < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  typedef T Vec __attribute__((vector_size(SIMD_SEARCH_WIDTH)));  // NOLINT(modernize-use-using)
+  constexpr int lanes = SIMD_SEARCH_WIDTH / sizeof(T);
+  Vec target_vec;
+  for (int lane = 0; lane < lanes; lane++) {
+    target_vec[lane] = target;
+  }
+
+  int i = lo;
+  int smaller = 0;
+  for (; i + lanes <= hi; i += lanes) {
+    Vec keys;
+    memcpy(&keys, data + static_cast<size_t>(i) * sizeof(T), sizeof(Vec));
+    // each lane is -1 where key < target and 0 otherwise
+    Vec mask = keys < target_vec;
+    for (int lane = 0; lane < lanes; lane++) {
+      smaller -= static_cast<int>(mask[lane]);
+    }
+    if (mask[lanes - 1] == 0) {
+      // the rest of the sorted range is >= target
+      return lo + smaller;
+    }
+  }
+  for (; i < hi; i++) {
+    if (!(load(i) < target)) {
+      break;
+    }
+    smaller++;
+  }
+  return lo + smaller;
+}
+
+/**
+ * Scalar lower bound: a binary search that calls the comparator, which for GenericComparator deserializes both keys
+ * into Values on every probe.
+ * @return the first index in [lo, hi) of `keys` whose key is >= key, or hi if there is none
+ */
+template <typename KeyType, typename KeyComparator>
+inline auto ComparatorLowerBound(const KeyType *keys, int lo, int hi, const KeyType &key,
+                                 const KeyComparator &comparator) -> int {
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (comparator(keys[mid], key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/** In-node key search for B+ tree pages. Key types without a faster path use the comparator. */
+template <typename KeyType, typename KeyComparator>
+struct BPlusTreeKeySearch {
+  static auto LowerBound(const KeyType *keys, int lo, int hi, const KeyType &key, const KeyComparator &comparator)
+      -> int {
+    return ComparatorLowerBound(keys, lo, hi, key, comparator);
+  }
+};
+
+/**
+ * Single INTEGER/BIGINT keys are stored as raw native integers, so the key array can be searched as an integer array.
+ * Other key schemas of the same width fall back to the comparator.
+ */
+template <size_t KeySize, typename IntType>
+struct IntegerKeySearch {
+  static auto LowerBound(const GenericKey<KeySize> *keys, int lo, int hi, const GenericKey<KeySize> &key,
+                         const GenericComparator<KeySize> &comparator) -> int {
+    if (!comparator.IsIntegerKey()) {
+      return ComparatorLowerBound(keys, lo, hi, key, comparator);
+    }
+    static_assert(sizeof(GenericKey<KeySize>) == sizeof(IntType), "integer keys must be stored back to back");
+    IntType target;
+    memcpy(&target, key.data_, sizeof(IntType));
+    return IntegerLowerBound<IntType>(reinterpret_cast<const char *>(keys), lo, hi, target);
+  }
+};
+
+template <>
+struct BPlusTreeKeySearch<GenericKey<4>, GenericComparator<4>> : IntegerKeySearch<4, int32_t> {};
+
+template <>
+struct BPlusTreeKeySearch<GenericKey<8>, GenericComparator<8>> : IntegerKeySearch<8, int64_t> {};
+
+}  // namespace bustub
@@ -33,12 +33,14 @@ class ExtendibleHashTableIndex : public Index {
 
   ~ExtendibleHashTableIndex() override = default;
 
-  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
 
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  auto LookupPageCount() -> size_t override;
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -12,9 +12,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
+#include <type_traits>
 
 #include "storage/table/tuple.h"
+#include "type/limits.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -32,7 +35,9 @@ class GenericKey {
   inline void SetFromKey(const Tuple &tuple) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    // A key of exactly the size of its columns leaves out the null bitmap, as a NULL column reads as the NULL value
+    // of its type without it.
+    memcpy(data_, tuple.GetData(), std::min<size_t>(tuple.GetLength(), KeySize));
   }
 
   // NOTE: for test purpose only
@@ -75,14 +80,30 @@ class GenericKey {
  */
 template <size_t KeySize>
 class GenericComparator {
+  /** Native type of a single INTEGER/BIGINT key, see IsIntegerKey(). */
+  using IntType = std::conditional_t<KeySize == sizeof(int32_t), int32_t, int64_t>;
+
  public:
+  /**
+   * NULL orders before every other value and is equal only to NULL, the same order the raw integer search gives the
+   * NULL sentinel (the smallest value of its type).
+   */
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    if (integer_key_) {
+      return CompareRaw(lhs, rhs);
+    }
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
       Value lhs_value = (lhs.ToValue(key_schema_, i));
       Value rhs_value = (rhs.ToValue(key_schema_, i));
 
+      if (lhs_value.IsNull() || rhs_value.IsNull()) {
+        if (lhs_value.IsNull() && rhs_value.IsNull()) {
+          continue;
+        }
+        return lhs_value.IsNull() ? -1 : 1;
+      }
       if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
         return -1;
       }
@@ -94,13 +115,57 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, integer_key_{other.integer_key_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema), integer_key_(IsRawIntegerKey(key_schema)) {}
+
+  /**
+   * @return true if the key is a single INTEGER (KeySize 4) or BIGINT (KeySize 8) column stored at offset 0, so that
+   * two keys order exactly like the native integers in their first KeySize bytes. Index pages use this to search
+   * their key arrays without materializing a Value per comparison.
+   */
+  inline auto IsIntegerKey() const -> bool { return integer_key_; }
+
+  /** @return true if a column of the key is NULL. Such a key is never a duplicate, even in a unique index. */
+  inline auto HasNull(const GenericKey<KeySize> &key) const -> bool {
+    if (integer_key_) {
+      IntType value;
+      memcpy(&value, key.data_, sizeof(IntType));
+      return value == static_cast<IntType>(KeySize == sizeof(int32_t) ? BUSTUB_INT32_NULL : BUSTUB_INT64_NULL);
+    }
+    for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+      if (key.ToValue(key_schema_, i).IsNull()) {
+        return true;
+      }
+    }
+    return false;
+  }
 
  private:
+  static auto CompareRaw(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) -> int {
+    IntType lhs_value;
+    IntType rhs_value;
+    memcpy(&lhs_value, lhs.data_, sizeof(IntType));
+    memcpy(&rhs_value, rhs.data_, sizeof(IntType));
+    return lhs_value < rhs_value ? -1 : (rhs_value < lhs_value ? 1 : 0);
+  }
+
+  static auto IsRawIntegerKey(Schema *key_schema) -> bool {
+    if (key_schema == nullptr || key_schema->GetColumnCount() != 1) {
+      return false;
+    }
+    const auto &col = key_schema->GetColumn(0);
+    if (col.GetOffset() != 0) {
+      return false;
+    }
+    return (KeySize == sizeof(int32_t) && col.GetType() == TypeId::INTEGER) ||
+           (KeySize == sizeof(int64_t) && col.GetType() == TypeId::BIGINT);
+  }
+
   Schema *key_schema_;
+  bool integer_key_;
 };
 
 }  // namespace bustub
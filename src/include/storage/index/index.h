@@ -18,6 +18,8 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "storage/index/key_filter.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -43,11 +45,21 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param include_attrs Base table columns stored in each entry after the key but not part of it, so that the index
+   * can answer queries on them without visiting the table
+   * @param is_unique Whether a key maps to at most one tuple; otherwise the index keeps every tuple of a key
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, std::vector<uint32_t> include_attrs = {}, bool is_unique = false)
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        include_attrs_(std::move(include_attrs)),
+        is_unique_(is_unique) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    entry_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, entry_attrs_));
   }
 
   ~IndexMetadata() = default;
@@ -72,6 +84,21 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return The base table columns included in the entries after the key */
+  inline auto GetIncludeAttrs() const -> const std::vector<uint32_t> & { return include_attrs_; }
+
+  /**
+   * @return The schema of a stored entry: the key columns followed by the included columns. Keys only compare on
+   * their leading key columns, so the key schema can still be used to build search keys.
+   */
+  inline auto GetEntrySchema() const -> Schema * { return entry_schema_.get(); }
+
+  /** @return The mapping relation between entry columns and base table columns */
+  inline auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return entry_attrs_; }
+
+  /** @return Whether a key maps to at most one tuple */
+  inline auto IsUnique() const -> bool { return is_unique_; }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -92,8 +119,16 @@ class IndexMetadata {
   std::string table_name_;
   /** The mapping relation between key schema and tuple schema */
   const std::vector<uint32_t> key_attrs_;
+  /** The base table columns stored after the key */
+  const std::vector<uint32_t> include_attrs_;
+  /** Whether a key maps to at most one tuple */
+  const bool is_unique_;
+  /** Key columns followed by included columns */
+  std::vector<uint32_t> entry_attrs_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** The schema of a stored entry */
+  std::shared_ptr<Schema> entry_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +174,12 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return The schema of the stored entries, which is the key schema unless the index has included columns */
+  auto GetEntrySchema() const -> Schema * { return metadata_->GetEntrySchema(); }
+
+  /** @return The index entry attributes: the key attributes followed by the included ones */
+  auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetEntryAttrs(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -153,11 +194,29 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
+   * @param key The index entry, laid out in the entry schema (see GetEntrySchema())
    * @param rid The RID associated with the key
    * @param transaction The transaction context
+   * @return false if the entry was not inserted, e.g. its key is already in a unique index
    */
-  virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
+  virtual auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool = 0;
+
+  /**
+   * Insert a batch of entries. The default inserts them one at a time; indexes that can do better with the whole
+   * batch in hand override it.
+   * @param keys The index entries, laid out in the entry schema
+   * @param rids The RIDs associated with the keys, in the same order
+   * @param transaction The transaction context
+   * @return false if any entry was not inserted
+   */
+  virtual auto InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids, Transaction *transaction)
+      -> bool {
+    bool inserted = true;
+    for (size_t i = 0; i < keys.size(); i++) {
+      inserted &= InsertEntry(keys[i], rids[i], transaction);
+    }
+    return inserted;
+  }
 
   /**
    * Delete an index entry by key.
@@ -175,9 +234,72 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  ///////////////////////////////////////////////////////////////////
+  // Key Filter
+  ///////////////////////////////////////////////////////////////////
+
+  /**
+   * Put a KeyFilter in front of the index, so that ScanKey on a key that is definitely absent returns right away.
+   * Only indexes that consult the filter (the B+ tree and hash indexes) benefit. Must be called before the first
+   * entry goes in.
+   * @param expected_keys number of keys the filter is sized for
+   */
+  void EnableKeyFilter(size_t expected_keys) { key_filter_ = std::make_unique<KeyFilter>(expected_keys); }
+
+  /** @return the key filter of the index, or nullptr if it has none */
+  auto GetKeyFilter() const -> const KeyFilter * { return key_filter_.get(); }
+
+  /** @return the number of pages a lookup reads, which is what a lookup the filter answers saves */
+  virtual auto LookupPageCount() -> size_t { return 1; }
+
+ protected:
+  /**
+   * @return the hash of the key columns of a tuple laid out in `schema`: the entry schema for index entries, or the
+   * key schema for search keys. Included columns are left out, so an entry and a search key for it hash the same.
+   */
+  auto KeyHash(const Tuple &key, const Schema *schema) const -> hash_t {
+    hash_t hash = 0;
+    for (uint32_t i = 0; i < GetIndexColumnCount(); i++) {
+      auto value = key.GetValue(schema, i);
+      hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&value));
+    }
+    return hash;
+  }
+
+  /** Add the key of an entry to the filter, if there is one, after it went into the index. */
+  void FilterInsert(const Tuple &key) {
+    if (key_filter_ != nullptr) {
+      key_filter_->Insert(KeyHash(key, GetEntrySchema()));
+    }
+  }
+
+  /** Take the key of an entry out of the filter, if there is one, after the entry was removed from the index. */
+  void FilterRemove(const Tuple &key) {
+    if (key_filter_ != nullptr) {
+      key_filter_->Remove(KeyHash(key, GetEntrySchema()));
+    }
+  }
+
+  /**
+   * @return false if the filter knows that the search key, laid out in the key schema, is not in the index, in which
+   * case the lookup can stop
+   */
+  auto FilterMayContain(const Tuple &key) -> bool {
+    return key_filter_ == nullptr || key_filter_->MayContain(KeyHash(key, GetKeySchema()));
+  }
+
+  /** Count a lookup that FilterMayContain let through but that found nothing. */
+  void FilterMissed() {
+    if (key_filter_ != nullptr) {
+      key_filter_->RecordFalsePositive();
+    }
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
+  /** Filter in front of the lookups, or nullptr */
+  std::unique_ptr<KeyFilter> key_filter_;
 };
 
 }  // namespace bustub
@@ -13,31 +13,105 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <optional>
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * Iterates over the entries of a B+ tree in ascending key order, or in descending order for a reverse iterator.
+ * An iterator with a stop key ends by itself once it passes that key, so callers scanning a key range do not have to
+ * compare every key against the upper (or, in reverse, the lower) bound.
+ *
+ * Each time the iterator enters a leaf, it asks the buffer pool to prefetch the next few leaves in its direction,
+ * so a cold range scan overlaps their reads with the work on the current leaf. The depth is set per tree with
+ * BPlusTree::SetIteratorPrefetchDepth(). Prefetched leaves stay pinned by the iterator until it reaches them or
+ * ends; otherwise the replacer would evict them, as the least used pages in the pool, before they are needed.
+ *
+ * In a non-unique tree, a key with a posting list yields one entry per value, in value order (reversed in a reverse
+ * iterator). The values are copied out of the posting pages when the iterator reaches the key.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
+  // The default iterator is the end iterator.
   IndexIterator();
+  /**
+   * @param tree the tree being iterated
+   * @param guard read guard on the leaf page the iterator starts in
+   * @param index position in that leaf; if it is off either end of the leaf the iterator moves on to the next leaf
+   * in its direction
+   * @param reverse iterate in descending key order
+   * @param stop_key if set, the iterator ends after the last key <= stop_key (>= stop_key in reverse)
+   */
+  IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, ReadPageGuard guard, int index,
+                bool reverse = false, std::optional<KeyType> stop_key = std::nullopt);
   ~IndexIterator();  // NOLINT
 
+  IndexIterator(IndexIterator &&that) noexcept = default;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator &;
+
   auto IsEnd() -> bool;
 
   auto operator*() -> const MappingType &;
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool {
+    return page_id_ == itr.page_id_ && index_ == itr.index_ && posting_index_ == itr.posting_index_;
+  }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  // Skip to the first entry of the next non-empty leaf once index_ runs off the current one, then end the iteration
+  // if the entry is past the stop key.
+  void SkipExhaustedLeaves();
+
+  // Skip to the last entry of the previous non-empty leaf once index_ drops below zero. bound is the last key
+  // returned; every entry still to come is smaller.
+  void SkipExhaustedLeavesBackward(KeyType bound);
+
+  void SetEnd();
+
+  // Copy out the values of the current entry if it has a posting list, and start at the first one in the direction of
+  // the iteration.
+  void LoadPostingList();
+
+  // Keep up to the tree's prefetch depth of leaves ahead of the current one prefetched. The leaf ids come from the
+  // parent page; they are refreshed once half of them have been reached.
+  void PrefetchAhead();
+
+  // Unpin every leaf prefetched but not reached.
+  void ReleasePrefetched();
+
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  BufferPoolManager *bpm_{nullptr};
+  // Read latch and pin on the current leaf; empty at the end.
+  ReadPageGuard guard_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
+  bool reverse_{false};
+  std::optional<KeyType> stop_key_;
+  // Copy of the current entry, since leaves store keys and values in separate arrays.
+  MappingType item_;
+  // Values of the current key's posting list, empty if the key has a single value, and the one the iterator is at.
+  std::vector<ValueType> posting_list_;
+  int posting_index_{0};
+  // Leaf the last PrefetchAhead() ran for, and the leaves ahead of it that have been prefetched and are pinned by
+  // this iterator, nearest first.
+  page_id_t prefetched_for_{INVALID_PAGE_ID};
+  std::vector<page_id_t> prefetched_;
 };
 
 }  // namespace bustub
@@ -29,5 +29,8 @@ class IntComparator {
     }
     return 0;
   }
+
+  /** Plain integers are never NULL, so every key counts for uniqueness. */
+  inline auto HasNull(const int key) const -> bool { return false; }
 };
 }  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_filter.h
+//
+// Identification: src/include/storage/index/key_filter.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Counters of a KeyFilter. */
+struct KeyFilterStats {
+  /** lookups that asked the filter */
+  uint64_t lookups_{0};
+  /** lookups the filter answered on its own, because the key was definitely absent */
+  uint64_t skipped_{0};
+  /** lookups the filter let through that then found nothing */
+  uint64_t false_positives_{0};
+
+  /** @return the share of lookups for absent keys that the filter let through */
+  auto FalsePositiveRate() const -> double {
+    auto negatives = skipped_ + false_positives_;
+    return negatives == 0 ? 0.0 : static_cast<double>(false_positives_) / static_cast<double>(negatives);
+  }
+};
+
+/**
+ * Counting blocked Bloom filter over key hashes, kept in memory in front of an index.
+ *
+ * Every key maps to one block of BLOCK_SIZE one-byte counters, a cache line, and bumps NUM_PROBES counters in it, so
+ * a lookup touches a single cache line. Counters go down again on removal, which keeps the filter exact under deletes
+ * and duplicate keys; a counter that reached its maximum stays there for good. The filter is sized once for an
+ * expected number of keys and gets less selective, but never wrong, as the index grows past it.
+ */
+class KeyFilter {
+ public:
+  /** Counters per block, i.e. one cache line of one-byte counters. */
+  static constexpr uint32_t BLOCK_SIZE = 64;
+  /** Counters each key bumps. */
+  static constexpr uint32_t NUM_PROBES = 4;
+  /** Counters per expected key, which keeps false positives around 2%. */
+  static constexpr uint32_t COUNTERS_PER_KEY = 10;
+
+  /** @param expected_keys number of keys the filter is sized for */
+  explicit KeyFilter(size_t expected_keys);
+
+  DISALLOW_COPY_AND_MOVE(KeyFilter);
+
+  /** Add a key. Call after the key went into the index. */
+  void Insert(uint64_t hash);
+
+  /** Remove a key. Call only after the key was taken out of the index, and once for every Insert. */
+  void Remove(uint64_t hash);
+
+  /** @return false if no key with this hash is in the filter, true if one may be; counts the lookup */
+  auto MayContain(uint64_t hash) -> bool;
+
+  /** Count a lookup that MayContain let through but that found nothing in the index. */
+  void RecordFalsePositive() { false_positives_.fetch_add(1, std::memory_order_relaxed); }
+
+  auto GetStats() const -> KeyFilterStats;
+
+  /** @return the number of blocks, a power of two */
+  auto NumBlocks() const -> size_t { return num_blocks_; }
+
+ private:
+  /** @return the block of a hash, and the counters to bump in it through `offsets` */
+  auto Locate(uint64_t hash, uint32_t offsets[NUM_PROBES]) const -> std::atomic<uint8_t> *;
+
+  size_t num_blocks_;
+  std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+  std::atomic<uint64_t> lookups_{0};
+  std::atomic<uint64_t> skipped_{0};
+  std::atomic<uint64_t> false_positives_{0};
+};
+
+}  // namespace bustub
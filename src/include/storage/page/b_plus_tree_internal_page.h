@@ -17,8 +17,11 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 28
+#define INTERNAL_PAGE_SLOT_CNT \
+  ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - sizeof(KeyType)) / (sizeof(KeyType) + sizeof(ValueType)))
+// One slot is kept spare so that a full page can take the entry that makes it split.
+#define INTERNAL_PAGE_SIZE (INTERNAL_PAGE_SLOT_CNT - 1)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -27,23 +30,75 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ * Keys and child pointers are kept in two parallel arrays so that the keys are
+ * contiguous in memory and can be searched with vector instructions.
+ *
+ * Like leaf pages, internal pages carry a B-link right link and high key: the
+ * subtrees of this page cover keys below the high key, and the right sibling
+ * (NextPageId) covers the rest. The high key is only meaningful when there is
+ * a next page.
+ *
+ * Internal page format (keys are stored in increasing order; the 28 byte
+ * header is the common page header followed by NextPageId):
+ *  ---------------------------------------------------------------------------------------
+ * | HEADER | HIGH_KEY | KEY(1) | KEY(2) | ... | KEY(n) | ... | PAGE_ID(1) | ... | PAGE_ID(n)
+ *  ---------------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreeInternalPage() = delete;
+  BPlusTreeInternalPage(const BPlusTreeInternalPage &other) = delete;
+
   // must call initialize method after "create" a new node
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
 
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetHighKey() const -> KeyType;
+  void SetHighKey(const KeyType &high_key);
+
+  /** @return true if key is not covered by this page and belongs to a right sibling */
+  auto IsPastHighKey(const KeyType &key, const KeyComparator &comparator) const -> bool;
+
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+
+  /** @return the index of the child pointer equal to value, or -1 if there is none */
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  /** @return the index of the child pointer whose subtree may contain key */
+  auto LookupIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /** @return the child pointer whose subtree may contain key */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  // turn this (new) page into a root with exactly two children
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  // insert new_key/new_value in key order; the page may temporarily hold
+  // max size + 1 children until the caller splits it
+  void InsertNode(const KeyType &new_key, const ValueType &new_value, const KeyComparator &comparator);
+
+  // remove the key and child pointer at index
+  void Remove(int index);
+
+  // split and merge utility methods
+  void MoveHalfTo(BPlusTreeInternalPage *recipient, page_id_t recipient_page_id);
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[1];
+  void CopyNFrom(const KeyType *keys, const ValueType *values, int size);
+
+  page_id_t next_page_id_;
+  KeyType high_key_;
+  // Parallel arrays for page data; only the first GetSize() entries are valid and key 0 is unused.
+  KeyType key_array_[INTERNAL_PAGE_SLOT_CNT];
+  ValueType page_id_array_[INTERNAL_PAGE_SLOT_CNT];
 };
 }  // namespace bustub
@@ -18,41 +18,92 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 32
+#define LEAF_PAGE_SIZE \
+  ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - sizeof(KeyType)) / (sizeof(KeyType) + sizeof(ValueType)))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Keys are unique within the tree; a non-unique tree keeps the record ids
+ * of a duplicated key in posting pages (see b_plus_tree_posting_page.h).
+ *
+ * Keys and values are kept in two parallel arrays so that the keys are
+ * contiguous in memory and can be searched with vector instructions (see
+ * storage/index/b_plus_tree_key_search.h).
+ *
+ * The next page id doubles as the B-link right link: every key on this page is
+ * smaller than the high key, and keys >= the high key live in a right sibling.
+ * The high key is only meaningful when there is a next page. The previous page
+ * id links the leaves backwards for descending scans.
  *
  * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ *  ------------------------------------------------------------------------------------
+ * | HEADER | HIGH_KEY | KEY(1) | KEY(2) | ... | KEY(n) | ... | RID(1) | RID(2) | ... | RID(n)
+ *  ------------------------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 32 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrevPageId (4)
+ *  ------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreeLeafPage() = delete;
+  BPlusTreeLeafPage(const BPlusTreeLeafPage &other) = delete;
+
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+  auto GetHighKey() const -> KeyType;
+  void SetHighKey(const KeyType &high_key);
+
+  /** @return true if key is not covered by this page and belongs to a right sibling */
+  auto IsPastHighKey(const KeyType &key, const KeyComparator &comparator) const -> bool;
+
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+  auto GetItem(int index) const -> MappingType;
+
+  /** @return the index of the first key that is >= key, or GetSize() if every key is smaller */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  // point lookup; returns false if the key is not present
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+
+  // insert in key order; returns false (and leaves the page untouched) on a duplicate key
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
+
+  // remove the entry with the given key; returns false if the key is not present
+  auto Remove(const KeyType &key, const KeyComparator &comparator) -> bool;
+
+  // split and merge utility methods
+  void MoveHalfTo(BPlusTreeLeafPage *recipient, page_id_t recipient_page_id);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
  private:
+  void CopyNFrom(const KeyType *keys, const ValueType *values, int size);
+  void ShiftRight(int from);
+  void ShiftLeft(int from);
+
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  page_id_t prev_page_id_;
+  KeyType high_key_;
+  // Parallel arrays for page data; only the first GetSize() entries are valid.
+  KeyType key_array_[LEAF_PAGE_SIZE];
+  ValueType rid_array_[LEAF_PAGE_SIZE];
 };
 }  // namespace bustub
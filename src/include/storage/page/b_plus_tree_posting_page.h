@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_posting_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+#define POSTING_PAGE_HEADER_SIZE 8
+#define POSTING_PAGE_SIZE ((BUSTUB_PAGE_SIZE - POSTING_PAGE_HEADER_SIZE) / sizeof(RID))
+
+/**
+ * Overflow page holding the record ids of one key in a non-unique B+ tree.
+ *
+ * A key with a single record id keeps it inline in the leaf, like in a unique tree. Once a second record id shows
+ * up, the leaf value is replaced by a posting list marker (see PostingListRid()) naming the first page of a chain of
+ * posting pages. The record ids of a chain are sorted by RID::Get(), and every id on a page is smaller than every id
+ * on the pages after it, so an insert or remove only touches the one page covering its id.
+ *
+ * Posting pages are only reached through their leaf entry, so they are latched after the leaf, and are only changed
+ * under the leaf's write latch.
+ *
+ * Posting page format (record ids are stored in order):
+ *  -----------------------------------------------------------------
+ * | NextPageId (4) | CurrentSize (4) | RID(1) | RID(2) | ... | RID(n)
+ *  -----------------------------------------------------------------
+ */
+class BPlusTreePostingPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreePostingPage() = delete;
+  BPlusTreePostingPage(const BPlusTreePostingPage &other) = delete;
+
+  /** Slot number that no table page hands out, used to tell posting list markers from record ids. */
+  static constexpr uint32_t POSTING_LIST_SLOT = UINT32_MAX;
+
+  /** @return the leaf value standing for the posting list that starts at head_page_id */
+  static auto PostingListRid(page_id_t head_page_id) -> RID { return {head_page_id, POSTING_LIST_SLOT}; }
+
+  /** @return true if a leaf value is a posting list marker rather than a record id */
+  static auto IsPostingList(const RID &rid) -> bool { return rid.GetSlotNum() == POSTING_LIST_SLOT; }
+
+  void Init();
+
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetSize() const -> int;
+  auto IsFull() const -> bool;
+  auto RidAt(int index) const -> RID;
+  auto LastRid() const -> RID;
+
+  /** @return the index of the first record id that is >= rid, or GetSize() if every id is smaller */
+  auto RidIndex(const RID &rid) const -> int;
+
+  // insert in order; returns false (and leaves the page untouched) if rid is already present
+  auto Insert(const RID &rid) -> bool;
+
+  // returns false if rid is not present
+  auto Remove(const RID &rid) -> bool;
+
+  // append every record id on this page to result
+  void CollectRids(std::vector<RID> *result) const;
+
+  // Move the upper half of the record ids to an empty recipient, which is linked in after this page.
+  void MoveHalfTo(BPlusTreePostingPage *recipient, page_id_t recipient_page_id);
+
+ private:
+  page_id_t next_page_id_;
+  int size_;
+  RID rid_array_[POSTING_PAGE_SIZE];
+};
+
+static_assert(sizeof(BPlusTreePostingPage) <= BUSTUB_PAGE_SIZE, "posting page does not fit in a page");
+
+}  // namespace bustub
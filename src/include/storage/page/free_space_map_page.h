@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Free-space map page of a table heap. It lists table pages in the order they joined the heap, each with a one-byte
+ * category of how much free space it has, and links to the next map page of the heap.
+ *
+ * A page in category c has at least c * CATEGORY_SIZE free bytes. Categories are hints: the heap lowers one when an
+ * insert finds the page fuller than recorded, and raises one when a delete frees space.
+ *
+ * Format (size in byte):
+ * ------------------------------------------------------------------------------------------------------
+ * | PageId (4) | NextPageId (4) | Size (4) | TablePageIds (4 * ARRAY_SIZE) | Categories (ARRAY_SIZE) | Free
+ * ------------------------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  /** Number of free bytes each category step stands for */
+  static constexpr uint32_t CATEGORY_SIZE = BUSTUB_PAGE_SIZE / 256;
+  /** Number of table pages one map page can list */
+  static constexpr uint32_t ARRAY_SIZE = (BUSTUB_PAGE_SIZE - 3 * sizeof(uint32_t)) / (sizeof(page_id_t) + 1);
+
+  // Delete all constructor / destructor to ensure memory safety
+  FreeSpaceMapPage() = delete;
+  FreeSpaceMapPage(const FreeSpaceMapPage &other) = delete;
+
+  /** @return the largest category whose pages are sure to have free_bytes free */
+  static auto CategoryOf(uint32_t free_bytes) -> uint8_t { return free_bytes / CATEGORY_SIZE; }
+
+  /** @return the smallest category whose pages are sure to fit needed_bytes */
+  static auto CategoryFor(uint32_t needed_bytes) -> uint8_t {
+    return (needed_bytes + CATEGORY_SIZE - 1) / CATEGORY_SIZE;
+  }
+
+  /**
+   * Initializes an empty map page.
+   * @param page_id the page id of this page
+   */
+  void Init(page_id_t page_id);
+
+  /** @return the page ID of this page */
+  auto GetPageId() const -> page_id_t;
+
+  /** @return the page ID of the next map page of the heap, INVALID_PAGE_ID if this is the last one */
+  auto GetNextPageId() const -> page_id_t;
+
+  /** @param next_page_id the page ID of the next map page of the heap */
+  void SetNextPageId(page_id_t next_page_id);
+
+  /** @return the number of table pages listed in this page */
+  auto GetSize() const -> uint32_t;
+
+  /** @return true if no more table pages fit in this page */
+  auto IsFull() const -> bool;
+
+  /**
+   * Lists one more table page.
+   * @param table_page_id the table page to list
+   * @param category the free-space category of the table page
+   * @return the slot of the table page in this map page
+   */
+  auto Append(page_id_t table_page_id, uint8_t category) -> uint32_t;
+
+  /** @return the table page listed at slot */
+  auto GetTablePageId(uint32_t slot) const -> page_id_t;
+
+  /** @return the free-space category of the table page at slot */
+  auto GetCategory(uint32_t slot) const -> uint8_t;
+
+  /** Sets the free-space category of the table page at slot */
+  void SetCategory(uint32_t slot, uint8_t category);
+
+  /** @return the largest category listed in this page, 0 if the page is empty */
+  auto MaxCategory() const -> uint8_t;
+
+  /**
+   * @param min_category the category a table page must be in at least
+   * @return the first slot whose table page is in min_category or above, GetSize() if there is none
+   */
+  auto FindSlot(uint8_t min_category) const -> uint32_t;
+
+ private:
+  page_id_t page_id_;
+  page_id_t next_page_id_;
+  uint32_t size_;
+  page_id_t table_page_ids_[ARRAY_SIZE];
+  uint8_t categories_[ARRAY_SIZE];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
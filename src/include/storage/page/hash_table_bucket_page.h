@@ -30,9 +30,11 @@ namespace bustub {
  *  ----------------------------------------------------------------
  *
  *  Here '+' means concatenation.
- *  The above format omits the space required for the occupied_ and
+ *  The above format omits the space required for the next page id and the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ * A bucket holding more pairs than fit in one page, which happens when they all share one hash, chains overflow
+ * pages of the same format through the next page id.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -40,12 +42,21 @@ class HashTableBucketPage {
   // Delete all constructor / destructor to ensure memory safety
   HashTableBucketPage() = delete;
 
+  /** Make this page an empty bucket without overflow pages. */
+  void Init();
+
+  /** @return the next page of the bucket's overflow chain, or INVALID_PAGE_ID */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the next page of the bucket's overflow chain. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
   /**
    * Scan the bucket and collect values that have the matching key
    *
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const -> bool;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -120,24 +131,25 @@ class HashTableBucketPage {
   /**
    * @return the number of readable elements, i.e. current size
    */
-  auto NumReadable() -> uint32_t;
+  auto NumReadable() const -> uint32_t;
 
   /**
    * @return whether the bucket is full
    */
-  auto IsFull() -> bool;
+  auto IsFull() const -> bool;
 
   /**
    * @return whether the bucket is empty
    */
-  auto IsEmpty() -> bool;
+  auto IsEmpty() const -> bool;
 
   /**
    * Prints the bucket's occupancy information
    */
-  void PrintBucket();
+  void PrintBucket() const;
 
  private:
+  page_id_t next_page_id_;
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
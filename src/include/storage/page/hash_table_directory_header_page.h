@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_header_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_header_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Header Page for extendible hash table, which spreads the keys over up to DIRECTORY_HEADER_ARRAY_SIZE directory
+ * pages by the high bits of their hash. Directories use the low bits of the hash, so the two never overlap.
+ *
+ * Header format (size in byte):
+ * ---------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | MaxDepth(4) | DirectoryPageIds(2048) | Free(2036)
+ * ---------------------------------------------------------------------
+ */
+class HashTableDirectoryHeaderPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableDirectoryHeaderPage() = delete;
+  HashTableDirectoryHeaderPage(const HashTableDirectoryHeaderPage &other) = delete;
+
+  /**
+   * Initializes a new header page with no directory pages yet.
+   *
+   * @param page_id the page id of this page
+   * @param max_depth number of high hash bits that pick the directory, at most DIRECTORY_HEADER_MAX_DEPTH
+   */
+  void Init(page_id_t page_id, uint32_t max_depth);
+
+  /**
+   * @return the page ID of this page
+   */
+  auto GetPageId() const -> page_id_t;
+
+  /**
+   * @return the lsn of this page
+   */
+  auto GetLSN() const -> lsn_t;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number to which to set the lsn field
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return the number of high hash bits that pick the directory
+   */
+  auto GetMaxDepth() const -> uint32_t;
+
+  /**
+   * @return the number of directory slots, 2^max_depth
+   */
+  auto MaxSize() const -> uint32_t;
+
+  /**
+   * @param hash the 32-bit hash of a key
+   * @return the slot of the directory page that holds the key
+   */
+  auto HashToDirectoryIndex(uint32_t hash) const -> uint32_t;
+
+  /**
+   * @param directory_idx the slot to look up
+   * @return the page id of the directory page at directory_idx, or INVALID_PAGE_ID if no key went there yet
+   */
+  auto GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t;
+
+  /**
+   * @param directory_idx the slot to set
+   * @param directory_page_id the page id of the directory page for the slot
+   */
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t max_depth_;
+  page_id_t directory_page_ids_[DIRECTORY_HEADER_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -35,16 +35,24 @@
 
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * The computation is the same as the above BLOCK_ARRAY_SIZE, less the page id of the next page of the bucket's
+ * overflow chain, but blocks and buckets have different implementations of search, insertion, removal, and helper
+ * methods.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - sizeof(page_id_t)) / (4 * sizeof(MappingType) + 1))
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
  * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
  * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
- * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
- * implementation.
+ * The header page spreads the keys over many directory pages to get past this limit.
  */
 #define DIRECTORY_ARRAY_SIZE 512
+
+/**
+ * DIRECTORY_HEADER_ARRAY_SIZE is the number of directory page_ids that can fit in the header page of an extendible
+ * hash index, 2^DIRECTORY_HEADER_MAX_DEPTH. It is a power of 2 as well, because the directory of a key is picked by
+ * the high bits of its hash.
+ */
+#define DIRECTORY_HEADER_MAX_DEPTH 9
+#define DIRECTORY_HEADER_ARRAY_SIZE (1 << DIRECTORY_HEADER_MAX_DEPTH)
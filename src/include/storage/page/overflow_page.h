@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Overflow page holding a piece of one variable-length value that is too large to keep inside its tuple.
+ *
+ * The table heap cuts such a value into pieces of up to DATA_SIZE bytes and chains them in order. The tuple keeps
+ * only the length of the value and the page ID of the first piece (see TOAST_MASK). A chain is written once, before
+ * its tuple is inserted, and freed when the tuple is deleted, so its pages are never changed in between.
+ *
+ * Format (size in byte):
+ * ------------------------------------------------
+ * | NextPageId (4) | Size (4) | Data (Size) | Free
+ * ------------------------------------------------
+ */
+class OverflowPage {
+ public:
+  /** Number of bytes of the value one page holds */
+  static constexpr uint32_t DATA_SIZE = BUSTUB_PAGE_SIZE - 2 * sizeof(uint32_t);
+
+  // Delete all constructor / destructor to ensure memory safety
+  OverflowPage() = delete;
+  OverflowPage(const OverflowPage &other) = delete;
+
+  /**
+   * Fills a new overflow page.
+   * @param next_page_id the page holding the next piece of the value, INVALID_PAGE_ID if this is the last one
+   * @param data the piece of the value
+   * @param size the size of the piece, at most DATA_SIZE
+   */
+  void Init(page_id_t next_page_id, const char *data, uint32_t size);
+
+  /** @return the page ID of the next piece of the value, INVALID_PAGE_ID if this is the last one */
+  auto GetNextPageId() const -> page_id_t;
+
+  /** @return the number of bytes of the value in this page */
+  auto GetSize() const -> uint32_t;
+
+  /** @return the bytes of the value in this page */
+  auto GetData() const -> const char *;
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t size_;
+  char data_[DATA_SIZE];
+};
+
+static_assert(sizeof(OverflowPage) == BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,257 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "concurrency/lock_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/** Bounds a scan puts on the values of one column, both inclusive. A missing bound does not limit the column. */
+struct ColumnRange {
+  uint32_t column_idx_;
+  std::optional<Value> lower_;
+  std::optional<Value> upper_;
+};
+
+/**
+ * PAX page: the rows of a table page, stored column by column.
+ *
+ * A page has a fixed number of row slots, its capacity. Every column has a minipage holding its value for each slot,
+ * followed by a bit per slot that is set when the value is NULL, so a scan that reads two columns of twenty touches
+ * two minipages. A variable-length column keeps the page offset of each value in its minipage, and the values
+ * themselves, each with its length word as in a tuple, grow from the end of the page towards the minipages.
+ *
+ * The page has the same interface as TablePage. It takes and returns tuples in the row format, so a table heap
+ * stores either kind of page, and the row format of a tuple is rebuilt from the minipages when it is read.
+ *
+ * Each column of a numeric type has a zone map: the smallest and largest non-NULL value ever stored in the page.
+ * Deletes do not shrink it, so it may be wider than the values the page holds, but never narrower.
+ *
+ * Format (size in bytes):
+ *  ----------------------------------------------------------------------------------------------------
+ *  | HEADER | COLUMN DIRECTORY | ROW STATES (Capacity) | MINIPAGES ... | FREE SPACE | VARIABLE-LENGTH |
+ *  ----------------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  ----------------------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) | RowCount (4) | Capacity (4) |
+ *  ----------------------------------------------------------------------------------------------------------
+ *  ------------------
+ *  | ColumnCount (4) |
+ *  ------------------
+ *
+ *  A column directory entry is the offset of the minipage of the column, the width of a value in it, the type of
+ *  the column, and the zone map.
+ */
+class PaxPage : public Page {
+ public:
+  /** Number of bytes an empty page keeps at least for variable-length values, so that a toasted tuple fits */
+  static constexpr uint32_t MIN_VARLEN_SPACE = BUSTUB_PAGE_SIZE / 4;
+
+  /** Size of a variable-length value the capacity of a page is planned for, unless its column is narrower */
+  static constexpr uint32_t EXPECTED_VARLEN_SIZE = 32;
+
+  /**
+   * Initialize the PaxPage header and the minipages for the columns of schema.
+   * @param page_id the page ID of this table page
+   * @param page_size the size of this table page
+   * @param prev_page_id the previous table page ID
+   * @param log_manager the log manager in use
+   * @param txn the transaction that this page is created in
+   * @param schema the schema of the rows
+   */
+  void Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_id, LogManager *log_manager, Transaction *txn,
+            const Schema &schema);
+
+  /** @return the page ID of this table page */
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the page ID of the previous table page */
+  auto GetPrevPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the previous page in the table. */
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** Insert a tuple into a free slot. See TablePage::InsertTuple. */
+  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
+      -> bool;
+
+  /** Append a tuple in the slot after the last used one. See TablePage::AppendTuple. */
+  auto AppendTuple(const Tuple &tuple, RID *rid) -> bool;
+
+  /** Mark a tuple as deleted. See TablePage::MarkDelete. */
+  auto MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) -> bool;
+
+  /** Update a tuple in its slot. See TablePage::UpdateTuple. */
+  auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
+                   LockManager *lock_manager, LogManager *log_manager) -> bool;
+
+  /** Free the slot of a tuple on commit of a delete or abort of an insert. See TablePage::ApplyDelete. */
+  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *removed_tuple = nullptr);
+
+  /** Reverse a MarkDelete. See TablePage::RollbackDelete. */
+  void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+
+  /** Read a tuple, rebuilt in the row format. See TablePage::GetTuple. */
+  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
+
+  /**
+   * Rebuild every tuple that is not deleted into copy, and add a view of it, in slot order.
+   * @param[out] copy BUSTUB_PAGE_SIZE bytes for the tuples
+   * @param[out] tuples the views are appended here
+   * @param columns the columns the caller reads, nullptr for all of them; the others are left NULL
+   */
+  void CopyTuples(char *copy, std::vector<Tuple> *tuples, const std::vector<uint32_t> *columns = nullptr);
+
+  /** @return false if the zone maps show that no row of this page has every column within its range */
+  auto MayMatch(const std::vector<ColumnRange> &ranges) -> bool;
+
+  /** See TablePage::GetFirstTupleRid. */
+  auto GetFirstTupleRid(RID *first_rid) -> bool;
+
+  /** See TablePage::GetNextTupleRid. */
+  auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
+
+  /**
+   * @return the size of the largest tuple a free slot of this page takes, 0 if it has no free slot: the size of the
+   * fixed-size part of a tuple and its null bitmap, plus the bytes left for variable-length values
+   */
+  auto GetFreeSpaceRemaining() -> uint32_t;
+
+  /** @return true if no slot of this page is in use, not even by a tuple marked as deleted */
+  auto IsEmpty() -> bool { return GetRowCount() == 0; }
+
+  /** @return the number of free bytes a page surely takes tuple with, in the sense of GetFreeSpaceRemaining */
+  static auto SpaceNeeded(const Tuple &tuple) -> uint32_t { return tuple.GetLength(); }
+
+  /** @return the free space of an empty page for schema, 0 if a page cannot hold a single row of it */
+  static auto EmptyPageSpace(const Schema &schema) -> uint32_t;
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  /** A column in the column directory */
+  struct ColumnEntry {
+    /** Offset of the minipage: Capacity values of Width bytes, then Capacity bits */
+    uint32_t minipage_offset_;
+    uint16_t width_;
+    uint8_t type_;
+    /** Whether min_ and max_ hold a zone map yet */
+    uint8_t has_range_;
+    char min_[8];
+    char max_[8];
+  };
+  static_assert(sizeof(ColumnEntry) == 24);
+
+  /** State of a row slot */
+  enum RowState : uint8_t { EMPTY = 0, LIVE, DELETED };
+
+  static constexpr size_t SIZE_PAX_PAGE_HEADER = 32;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_FREE_SPACE = 16;
+  static constexpr size_t OFFSET_ROW_COUNT = 20;
+  static constexpr size_t OFFSET_CAPACITY = 24;
+  static constexpr size_t OFFSET_COLUMN_COUNT = 28;
+
+  /**
+   * Lay out the minipages of schema for a capacity.
+   * @param[out] entries if not nullptr, filled with the directory of the layout
+   * @return the end of the minipages
+   */
+  static auto LayOut(const Schema &schema, uint32_t capacity, std::vector<ColumnEntry> *entries) -> uint32_t;
+
+  /** @return the largest capacity whose minipages leave room for the variable-length values of as many rows */
+  static auto CapacityFor(const Schema &schema) -> uint32_t;
+
+  auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+
+  /** @return the number of slots in use or freed in between; the slots after them are all free */
+  auto GetRowCount() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_ROW_COUNT); }
+
+  void SetRowCount(uint32_t row_count) { memcpy(GetData() + OFFSET_ROW_COUNT, &row_count, sizeof(uint32_t)); }
+
+  auto GetCapacity() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CAPACITY); }
+
+  auto GetColumnCount() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_COLUMN_COUNT); }
+
+  auto GetColumns() -> ColumnEntry * { return reinterpret_cast<ColumnEntry *>(GetData() + SIZE_PAX_PAGE_HEADER); }
+
+  auto GetRowStates() -> uint8_t * {
+    return reinterpret_cast<uint8_t *>(GetData() + SIZE_PAX_PAGE_HEADER + sizeof(ColumnEntry) * GetColumnCount());
+  }
+
+  /** @return the end of the minipages, where the free space starts */
+  auto GetMinipagesEnd() -> uint32_t;
+
+  /** @return the size of the fixed-size part of a tuple and its null bitmap */
+  auto GetFixedRowSize() -> uint32_t;
+
+  /** @return the value of a column in a slot, or for a variable-length column its page offset */
+  auto GetValueAt(const ColumnEntry &column, uint32_t slot_num) -> char * {
+    return GetData() + column.minipage_offset_ + column.width_ * slot_num;
+  }
+
+  /** @return the null bits of a column */
+  auto GetNullBits(const ColumnEntry &column) -> uint8_t * {
+    return reinterpret_cast<uint8_t *>(GetData() + column.minipage_offset_ + column.width_ * GetCapacity());
+  }
+
+  /**
+   * @return the size of the tuple in a slot
+   * @param is_read which columns the tuple has values of, nullptr for all; the others are NULL
+   */
+  auto GetRowSize(uint32_t slot_num, const std::vector<bool> *is_read = nullptr) -> uint32_t;
+
+  /**
+   * Rebuild the tuple in a slot into storage, which holds GetRowSize bytes.
+   * @param is_read which columns the tuple has values of, nullptr for all; the others are NULL
+   * @param null_values a fixed-size part of a tuple with the NULL value of every column left out
+   */
+  void ReadRow(uint32_t slot_num, char *storage, const std::vector<bool> *is_read = nullptr,
+               const char *null_values = nullptr);
+
+  /** Store a tuple in a free slot, which the caller has made sure it fits. */
+  void WriteRow(uint32_t slot_num, const Tuple &tuple);
+
+  /** Give the variable-length values of a slot back to the free space. */
+  void FreeVarlenValues(uint32_t slot_num);
+
+  /** Widen the zone map of a column for a value stored in it. */
+  static void WidenRange(ColumnEntry *column, const char *value);
+};
+
+}  // namespace bustub
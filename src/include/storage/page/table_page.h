@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
@@ -84,6 +85,15 @@ class TablePage : public Page {
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
       -> bool;
 
+  /**
+   * Append a tuple in a new slot after the existing ones, without looking for a free slot to reuse. Bulk loads use
+   * this on pages that have no free slots; it is not logged per tuple.
+   * @param tuple tuple to append
+   * @param[out] rid rid of the appended tuple
+   * @return true if the append is successful (i.e. there is enough space)
+   */
+  auto AppendTuple(const Tuple &tuple, RID *rid) -> bool;
+
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
    * @param rid rid of the tuple to mark as deleted
@@ -107,8 +117,11 @@ class TablePage : public Page {
   auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                    LockManager *lock_manager, LogManager *log_manager) -> bool;
 
-  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
-  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+  /**
+   * To be called on commit or abort. Actually perform the delete or rollback an insert.
+   * @param[out] removed_tuple if not nullptr, set to the tuple that was removed
+   */
+  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *removed_tuple = nullptr);
 
   /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
   void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
@@ -123,6 +136,13 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * Copy this page, and add a view into the copy for every tuple that is not deleted, in slot order.
+   * @param[out] copy BUSTUB_PAGE_SIZE bytes for the copy
+   * @param[out] tuples the views are appended here
+   */
+  void CopyTuples(char *copy, std::vector<Tuple> *tuples);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -138,6 +158,17 @@ class TablePage : public Page {
    */
   auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
 
+  /** @return the number of bytes left for new tuples and their slots */
+  auto GetFreeSpaceRemaining() -> uint32_t {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return true if no slot of this page is in use, not even by a tuple marked as deleted */
+  auto IsEmpty() -> bool { return GetTupleCount() == 0; }
+
+  /** @return the number of free bytes a page surely takes tuple with; a page that reuses a slot needs fewer */
+  static auto SpaceNeeded(const Tuple &tuple) -> uint32_t { return tuple.size_ + SIZE_TUPLE; }
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
@@ -167,10 +198,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  auto GetFreeSpaceRemaining() -> uint32_t {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   auto GetTupleOffsetAtSlot(uint32_t slot_num) -> uint32_t {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -12,33 +12,64 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
 #include "recovery/log_manager.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/** How a table heap lays out the tuples in its pages */
+enum class TableFormat { ROW, PAX };
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Inserts do not walk the list. They go to the page the last insert went to, or else to a page the free-space map
+ * (a chain of FreeSpaceMapPage) lists with enough room, or else to a new page appended to the list.
+ *
+ * A heap that knows the schema of its tuples toasts the ones larger than TOAST_THRESHOLD before it stores them: it
+ * moves their largest variable-length values into chains of OverflowPage, largest first, until the rest fits under
+ * the threshold. Tuples read back keep a pointer to the heap and fetch those values only when GetValue asks for them.
+ * The chains of a tuple are freed when ApplyDelete removes it, or when the update that replaced it commits.
+ *
+ * A heap stores its tuples either in slotted pages (TablePage), or column by column in PAX pages (PaxPage), for
+ * scans that read few of many columns. Both take and return tuples in the row format, so the format only shows in
+ * ScanPage, where a PAX heap reads just the columns it is asked for and skips pages by their zone maps.
  */
 class TableHeap {
   friend class TableIterator;
 
  public:
+  /** Size above which a tuple has its largest variable-length values moved out of line */
+  static constexpr uint32_t TOAST_THRESHOLD = BUSTUB_PAGE_SIZE / 4;
+
   ~TableHeap() = default;
 
   /**
    * Create a table heap without a transaction. (open table)
+   * Walks the pages of the table once to build its free-space map.
    * @param buffer_pool_manager the buffer pool manager
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param schema the schema of the tuples, without which tuples that do not fit a page are refused
+   * @param format the format of the pages, PAX only with a schema
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, const Schema *schema = nullptr, TableFormat format = TableFormat::ROW);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,12 +77,14 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param schema the schema of the tuples, without which tuples that do not fit a page are refused
+   * @param format the format of the pages, PAX only with a schema
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, const Schema *schema = nullptr, TableFormat format = TableFormat::ROW);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table. If the tuple is too large (>= page_size) even after toasting, return false.
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
@@ -59,6 +92,16 @@ class TableHeap {
    */
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
 
+  /**
+   * Append tuples at the end of the table: they fill the last page and then fresh pages, one page at a time. Unlike
+   * InsertTuple it never looks for room in earlier pages, so it suits loads of many tuples.
+   * @param tuples tuples to append
+   * @param[out] rids rids of the appended tuples, in the order of tuples
+   * @param txn the transaction performing the insert
+   * @return true iff all tuples were appended; on failure the transaction is aborted
+   */
+  auto AppendTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool;
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -69,6 +112,8 @@ class TableHeap {
 
   /**
    * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * The new tuple is toasted like an inserted one. The overflow pages of the old one stay until ApplyUpdate, since a
+   * rollback may bring it back.
    * @param tuple new tuple
    * @param rid rid of the old tuple
    * @param txn transaction performing the update
@@ -76,6 +121,20 @@ class TableHeap {
    */
   auto UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool;
 
+  /**
+   * Called on Commit of an update to free the overflow pages of the tuple it replaced.
+   * @param old_tuple the replaced tuple, as the write set keeps it
+   */
+  void ApplyUpdate(const Tuple &old_tuple);
+
+  /**
+   * Called on abort to rollback an update: put the replaced tuple back, and free the overflow pages of the update.
+   * @param old_tuple the replaced tuple, as the write set keeps it
+   * @param rid rid of the tuple
+   * @param txn transaction performing the rollback
+   */
+  void RollbackUpdate(const Tuple &old_tuple, const RID &rid, Transaction *txn);
+
   /**
    * Called on Commit/Abort to actually delete a tuple or rollback an insert.
    * @param rid rid of the tuple to delete
@@ -90,6 +149,18 @@ class TableHeap {
    */
   void RollbackDelete(const RID &rid, Transaction *txn);
 
+  /**
+   * Called on Commit/Abort for every write set record of this heap, once the record is applied or rolled back.
+   * @param txn the transaction the record belongs to
+   */
+  void ReleaseWrite(Transaction *txn);
+
+  /**
+   * Keep Vacuum off the heap for as long as the returned lock is held. Scans hold it from the start to the end of a
+   * statement, as they keep page ids and RIDs between calls.
+   */
+  auto LockForScan() -> std::shared_lock<std::shared_mutex> { return std::shared_lock(vacuum_latch_); }
+
   /**
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
@@ -99,6 +170,19 @@ class TableHeap {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
+  /**
+   * Read a whole page of the table for a scan, with one pin and one copy, instead of a tuple at a time.
+   * @param page_id the page to read
+   * @param[out] copy BUSTUB_PAGE_SIZE bytes for a copy of the page
+   * @param[out] tuples replaced by views into the copy, one for every tuple of the page
+   * @param columns the columns the caller reads, nullptr for all; a PAX heap leaves the others NULL
+   * @param ranges bounds on columns; a PAX heap yields no tuples of a page whose zone maps rule them all out
+   * @return the id of the next page of this table, INVALID_PAGE_ID after the last one
+   */
+  auto ScanPage(page_id_t page_id, char *copy, std::vector<Tuple> *tuples,
+                const std::vector<uint32_t> *columns = nullptr, const std::vector<ColumnRange> *ranges = nullptr)
+      -> page_id_t;
+
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
 
@@ -108,11 +192,144 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the format of the pages of this table */
+  inline auto GetFormat() const -> TableFormat { return format_; }
+
+  /** @return the number of pages of this table, not counting its free-space map or overflow pages */
+  auto GetNumPages() -> size_t;
+
+  /**
+   * Read a toasted value from its overflow pages.
+   * @param storage the length word of the value in a tuple of this heap, and the page ID after it
+   * @param type the type of the value
+   */
+  auto ReadToastedValue(const char *storage, TypeId type) const -> Value;
+
+  /**
+   * Move tuples from the last pages of the table into the free space of its first pages, and drop the pages this
+   * empties from the page list. Tuples marked as deleted stay where they are, and so do the pages holding them.
+   *
+   * A moved tuple gets a new RID, so nothing else may use the table meanwhile: no scan may be open on it (see
+   * LockForScan()) and no other transaction may have uncommitted changes to it. Both are checked. Inserts, deletes,
+   * updates and new scans wait for the vacuum to finish. Moves are not logged.
+   * @param on_move called with every moved tuple, its old RID and its new RID, so that indexes can follow
+   * @param txn the vacuuming transaction
+   * @return the number of pages dropped, or std::nullopt if a scan is open or another transaction has uncommitted
+   * changes to the table
+   */
+  auto Vacuum(const std::function<void(const Tuple &, const RID &, const RID &)> &on_move, Transaction *txn)
+      -> std::optional<size_t>;
+
  private:
+  /** Call f with page as the kind of page this heap stores, a TablePage or a PaxPage, and return what f returns. */
+  template <typename F>
+  auto VisitPage(Page *page, F &&f) {
+    if (format_ == TableFormat::PAX) {
+      return f(static_cast<PaxPage *>(page));
+    }
+    return f(static_cast<TablePage *>(page));
+  }
+
+  /** Initialize a new page of this heap. */
+  void InitPage(Page *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn);
+
+  /** @return the free space of a page of this heap */
+  auto GetFreeSpace(Page *page) -> uint32_t {
+    return VisitPage(page, [](auto *table_page) { return table_page->GetFreeSpaceRemaining(); });
+  }
+
+  /** @return the id of the page after a page of this heap */
+  auto GetNextPageId(Page *page) -> page_id_t {
+    return VisitPage(page, [](auto *table_page) { return table_page->GetNextPageId(); });
+  }
+
+  /**
+   * Move the largest variable-length values of a tuple into overflow pages until it fits under TOAST_THRESHOLD.
+   * @param[out] toasted the tuple as the heap stores it, with the moved values replaced by their page IDs
+   * @return false if no value was moved, and toasted is left alone
+   */
+  auto Toast(const Tuple &tuple, Tuple *toasted) -> bool;
+
+  /** @return the first page of a new chain of overflow pages holding size bytes of data */
+  auto WriteOverflowPages(const char *data, uint32_t size) -> page_id_t;
+
+  /** Free the overflow pages of every toasted value of a stored tuple. */
+  void FreeOverflowPages(const Tuple &tuple);
+
+  /** Replace the tuple at rid with a tuple as the heap stores it, and return the replaced one in old_tuple. */
+  auto UpdateStoredTuple(const Tuple &tuple, const RID &rid, Transaction *txn, Tuple *old_tuple) -> bool;
+
+  /** Add a record to the write set of txn, and count txn among the writers of this heap until it releases it. */
+  void RecordWrite(Transaction *txn, const RID &rid, WType wtype, const Tuple &old_tuple = {});
+
+  /** InsertTuple for a tuple that is already toasted as far as it goes. */
+  auto InsertStoredTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+
+  /** AppendTuples for tuples that are already toasted as far as they go. */
+  auto AppendStoredTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool;
+
+  /** Walk the page list to find the last page, and list every page in a new free-space map. */
+  void ListPages();
+
+  /** Take an empty page out of the page list and free it. */
+  void UnlinkPage(page_id_t page_id, page_id_t prev_page_id, page_id_t next_page_id);
+
+  /**
+   * Try to insert the tuple into one existing page. If it does not fit, record how much space the page really has.
+   * @return true iff the tuple went into the page
+   */
+  auto InsertIntoPage(page_id_t page_id, const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+
+  /**
+   * Link a new page after the last page of the table and list it in the free-space map.
+   * @return the new page, pinned and write-latched, or nullptr if no page could be created
+   */
+  auto NewLastPage(Transaction *txn) -> Page *;
+
+  /** List a page that just joined the table in the free-space map. */
+  void AddToFreeSpaceMap(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Record the free space of a listed page.
+   * @param raise_only do not lower the recorded category, for callers that only ever free space
+   */
+  void SetFreeSpace(page_id_t page_id, uint32_t free_space, bool raise_only);
+
+  /** @return a listed page whose category says it fits needed_bytes, INVALID_PAGE_ID if there is none */
+  auto FindPageWithSpace(uint32_t needed_bytes) -> page_id_t;
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  TableFormat format_;
+  /** Schema of the tuples, nullptr if the heap neither toasts nor stores PAX pages */
+  std::unique_ptr<Schema> schema_;
+  /** Size of the largest tuple an empty page takes */
+  uint32_t max_tuple_size_;
+
+  /**
+   * Held exclusively by Vacuum, and shared by scans, MarkDelete and UpdateTuple, which address tuples by RID. Taken
+   * before insert_latch_ and page latches.
+   */
+  std::shared_mutex vacuum_latch_;
+  /** Guards writers_; taken under insert_latch_ when both are held */
+  std::mutex writers_latch_;
+  /** Write set records each transaction holds on this heap, for the transactions that hold any */
+  std::unordered_map<txn_id_t, size_t> writers_;
+
+  /** Serializes inserts, and guards everything below */
+  std::mutex insert_latch_;
+  /** Last page of the page list, where new pages get linked */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** Page the last insert went to */
+  page_id_t last_insert_page_id_{INVALID_PAGE_ID};
+  /** Pages of the free-space map, in chain order */
+  std::vector<page_id_t> fsm_page_ids_;
+  /** Largest category listed in each page of the free-space map, so that searches skip full map pages unread */
+  std::vector<uint8_t> fsm_max_categories_;
+  /** Slot of each table page in the free-space map, counted across all map pages */
+  std::unordered_map<page_id_t, size_t> fsm_slots_;
 };
 
 }  // namespace bustub
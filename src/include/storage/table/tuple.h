@@ -21,14 +21,38 @@
 
 namespace bustub {
 
+class TableHeap;
+
+/**
+ * Set in the length word of a variable-length value that a table heap keeps in overflow pages. The other bits of
+ * the word are the length of the value, and the page ID of the first overflow page follows the word in place of the
+ * value. A NULL value has all bits set, so it is not toasted.
+ */
+static constexpr uint32_t TOAST_MASK = 1U << 31;
+
 /**
  * Tuple format:
- * ---------------------------------------------------------------------
- * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
- * ---------------------------------------------------------------------
+ * ---------------------------------------------------------------------------------
+ * | FIXED-SIZE or VARIED-SIZED OFFSET | NULL BITMAP | PAYLOAD OF VARIED-SIZED FIELD |
+ * ---------------------------------------------------------------------------------
+ *
+ * The null bitmap has one bit per column, the low bit of its first byte for column 0, set when the column is NULL.
+ * The slot of a NULL column still holds the NULL value of its type, so the fixed-size part alone, which is what an
+ * index key keeps, reads the same as before.
+ *
+ * A tuple read from a table heap may have toasted values (see TOAST_MASK). GetValue reads them from the overflow
+ * pages of the heap, so they cost nothing until asked for.
+ *
+ * A tuple either owns its bytes or is a view: it points at bytes someone else keeps, such as the page copy of a
+ * sequential scan. Moving a tuple keeps what it is, and copying one always makes an owning tuple, so a view handed
+ * up an executor pipeline costs nothing until an operator keeps it.
+ *
+ * While a query runs, a tuple built from values or read from a page is a view into the arena of the query (see
+ * ArenaPool), which frees it in bulk when the query ends.
  */
 class Tuple {
   friend class TablePage;
+  friend class PaxPage;
   friend class TableHeap;
   friend class TableIterator;
 
@@ -40,14 +64,27 @@ class Tuple {
   explicit Tuple(RID rid) : rid_(rid) {}
 
   // constructor for creating a new tuple based on input value
-  Tuple(std::vector<Value> values, const Schema *schema);
+  Tuple(const std::vector<Value> &values, const Schema *schema);
 
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
+  // move constructor, a view stays a view
+  Tuple(Tuple &&other) noexcept;
+
   // assign operator, deep copy
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // move assign operator, a view stays a view
+  auto operator=(Tuple &&other) noexcept -> Tuple &;
+
+  // A view of size bytes at data, which must outlive it
+  static auto View(char *data, uint32_t size, RID rid = RID()) -> Tuple;
+
+  // Lay out values as a tuple in buffer, which grows as needed, and return a view of it. The view lives until the
+  // buffer changes, so reusing one buffer for every row of an operator allocates nothing once it is large enough.
+  static auto ViewOf(const std::vector<Value> &values, const Schema *schema, std::vector<char> *buffer) -> Tuple;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -74,26 +111,50 @@ class Tuple {
   // checks the schema to see how to return the Value.
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
+  // Does any value of this tuple live in overflow pages ?
+  auto IsToasted(const Schema *schema) const -> bool;
+
   // Generates a key tuple given schemas and attributes
-  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
+      -> Tuple;
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
-    Value value = GetValue(schema, column_idx);
-    return value.IsNull();
+    return (GetNullBitmap(schema)[column_idx / 8] >> (column_idx % 8) & 1) != 0;
+  }
+
+  // The null bitmap of the tuple, NullBitmapSize(schema) bytes
+  inline auto GetNullBitmap(const Schema *schema) const -> const uint8_t * {
+    return reinterpret_cast<const uint8_t *>(data_ + schema->GetLength());
   }
+
+  // Number of bytes of the null bitmap of a tuple of the schema
+  static inline auto NullBitmapSize(const Schema *schema) -> uint32_t { return (schema->GetColumnCount() + 7) / 8; }
   inline auto IsAllocated() -> bool { return allocated_; }
 
+  // Is this a view of bytes owned elsewhere ?
+  inline auto IsView() const -> bool { return !allocated_ && data_ != nullptr; }
+
   auto ToString(const Schema *schema) const -> std::string;
 
  private:
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
+  // Drop the bytes of this tuple and make room for size new ones, in the arena of this thread if it has room
+  void Allocate(uint32_t size);
+
+  // The number of bytes values take as a tuple
+  static auto SerializedSize(const std::vector<Value> &values, const Schema *schema) -> uint32_t;
+
+  // Write values as a tuple into storage, which holds SerializedSize bytes
+  static void SerializeValues(const std::vector<Value> &values, const Schema *schema, char *storage);
+
   bool allocated_{false};  // is allocated?
   RID rid_{};              // if pointing to the table heap, the rid is valid
   uint32_t size_{0};
   char *data_{nullptr};
+  const TableHeap *heap_{nullptr};  // the table heap this tuple was read from, which holds its toasted values
 };
 
 }  // namespace bustub
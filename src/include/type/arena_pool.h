@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "common/macros.h"
+#include "type/abstract_pool.h"
+
+namespace bustub {
+
+/**
+ * ArenaPool is a bump allocator: it hands out memory from large blocks and frees nothing until it is destroyed, when
+ * it frees every block at once. Each query owns one through its ExecutorContext, and the execution engine makes it
+ * the current arena of the executing thread, so that the varlen data of Values and the bytes of Tuples built during
+ * the query come from it instead of from malloc.
+ *
+ * Allocate() stops handing out memory once a budget is used up and returns nullptr, so callers fall back to the heap.
+ * That keeps a long scan from holding every value it ever read. AllocateAligned() is not bounded; it is for hash
+ * tables and other structures an executor keeps for the whole query anyway.
+ *
+ * An ArenaPool is not thread-safe. Threads other than the one running the query have no current arena.
+ */
+class ArenaPool : public AbstractPool {
+ public:
+  /** Size of the blocks the arena allocates from */
+  static constexpr size_t BLOCK_SIZE = 64 << 10;
+
+  /** Default number of bytes Allocate() hands out before it gives up */
+  static constexpr size_t DEFAULT_BUDGET = 32 << 20;
+
+  explicit ArenaPool(size_t budget = DEFAULT_BUDGET) : budget_(budget) {}
+
+  ~ArenaPool() override = default;
+
+  DISALLOW_COPY_AND_MOVE(ArenaPool);
+
+  /** @return size bytes aligned for any scalar type, or nullptr once the budget is used up */
+  auto Allocate(size_t size) -> void * override;
+
+  /** Memory of an arena is only freed with the arena, so this does nothing. */
+  void Free(void *ptr) override {}
+
+  /** @return size bytes aligned to align, regardless of the budget */
+  auto AllocateAligned(size_t size, size_t align) -> void *;
+
+  /** @return the number of bytes handed out by Allocate() */
+  auto GetBytesUsed() const -> size_t { return bytes_used_; }
+
+  /** @return the number of bytes the arena holds in its blocks */
+  auto GetBytesReserved() const -> size_t { return bytes_reserved_; }
+
+  /** @return the arena of the calling thread, nullptr if there is none */
+  static auto Current() -> ArenaPool * { return current; }
+
+  /** Makes an arena the current one of the calling thread for as long as the scope lives. */
+  class Scope {
+   public:
+    explicit Scope(ArenaPool *arena) : previous_(current) { current = arena; }
+    ~Scope() { current = previous_; }
+    DISALLOW_COPY_AND_MOVE(Scope);
+
+   private:
+    ArenaPool *previous_;
+  };
+
+ private:
+  static inline thread_local ArenaPool *current = nullptr;
+
+  size_t budget_;
+  size_t bytes_used_{0};
+  size_t bytes_reserved_{0};
+  /** The blocks, the last one being the one that is being filled */
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  /** The free part of the last block */
+  char *next_{nullptr};
+  char *end_{nullptr};
+};
+
+/** An STL allocator over an arena, for the containers of an executor. */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;  // NOLINT
+
+  explicit ArenaAllocator(ArenaPool *arena) : arena_(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.GetArena()) {}  // NOLINT
+
+  auto allocate(size_t n) -> T * {  // NOLINT
+    return static_cast<T *>(arena_->AllocateAligned(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *ptr, size_t n) {}  // NOLINT
+
+  auto GetArena() const -> ArenaPool * { return arena_; }
+
+  template <typename U>
+  auto operator==(const ArenaAllocator<U> &other) const -> bool {
+    return arena_ == other.GetArena();
+  }
+
+  template <typename U>
+  auto operator!=(const ArenaAllocator<U> &other) const -> bool {
+    return arena_ != other.GetArena();
+  }
+
+ private:
+  ArenaPool *arena_;
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -29,6 +30,10 @@ inline auto GetCmpBool(bool boolean) -> CmpBool { return boolean ? CmpBool::CmpT
 // A value is an abstract class that represents a view over SQL data stored in
 // some materialized state. All values have a type and comparison functions, but
 // subclasses implement other type-specific functionality.
+//
+// Comparisons and arithmetic between two non-null values of the same fixed-width
+// type work on the native values inline; everything else (NULLs, mixed types,
+// VARCHAR, overflow) goes through the Type of the value.
 class Value {
   // Friend Type classes
   friend class Type;
@@ -71,6 +76,7 @@ class Value {
     std::swap(first.value_, second.value_);
     std::swap(first.size_, second.size_);
     std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.pooled_, second.pooled_);
     std::swap(first.type_id_, second.type_id_);
   }
   // check whether value is integer
@@ -95,28 +101,70 @@ class Value {
   }
   // Comparison Methods
   inline auto CompareEquals(const Value &o) const -> CmpBool {
+    CmpBool result;
+    if (CompareNative(o, std::equal_to<>(), &result)) {
+      return result;
+    }
     return Type::GetInstance(type_id_)->CompareEquals(*this, o);
   }
   inline auto CompareNotEquals(const Value &o) const -> CmpBool {
+    CmpBool result;
+    if (CompareNative(o, std::not_equal_to<>(), &result)) {
+      return result;
+    }
     return Type::GetInstance(type_id_)->CompareNotEquals(*this, o);
   }
   inline auto CompareLessThan(const Value &o) const -> CmpBool {
+    CmpBool result;
+    if (CompareNative(o, std::less<>(), &result)) {
+      return result;
+    }
     return Type::GetInstance(type_id_)->CompareLessThan(*this, o);
   }
   inline auto CompareLessThanEquals(const Value &o) const -> CmpBool {
+    CmpBool result;
+    if (CompareNative(o, std::less_equal<>(), &result)) {
+      return result;
+    }
     return Type::GetInstance(type_id_)->CompareLessThanEquals(*this, o);
   }
   inline auto CompareGreaterThan(const Value &o) const -> CmpBool {
+    CmpBool result;
+    if (CompareNative(o, std::greater<>(), &result)) {
+      return result;
+    }
     return Type::GetInstance(type_id_)->CompareGreaterThan(*this, o);
   }
   inline auto CompareGreaterThanEquals(const Value &o) const -> CmpBool {
+    CmpBool result;
+    if (CompareNative(o, std::greater_equal<>(), &result)) {
+      return result;
+    }
     return Type::GetInstance(type_id_)->CompareGreaterThanEquals(*this, o);
   }
 
   // Other mathematical functions
-  inline auto Add(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Add(*this, o); }
-  inline auto Subtract(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Subtract(*this, o); }
-  inline auto Multiply(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Multiply(*this, o); }
+  inline auto Add(const Value &o) const -> Value {
+    Value result;
+    if (ComputeNative(o, std::plus<>(), &result)) {
+      return result;
+    }
+    return Type::GetInstance(type_id_)->Add(*this, o);
+  }
+  inline auto Subtract(const Value &o) const -> Value {
+    Value result;
+    if (ComputeNative(o, std::minus<>(), &result)) {
+      return result;
+    }
+    return Type::GetInstance(type_id_)->Subtract(*this, o);
+  }
+  inline auto Multiply(const Value &o) const -> Value {
+    Value result;
+    if (ComputeNative(o, std::multiplies<>(), &result)) {
+      return result;
+    }
+    return Type::GetInstance(type_id_)->Multiply(*this, o);
+  }
   inline auto Divide(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Divide(*this, o); }
   inline auto Modulo(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Modulo(*this, o); }
   inline auto Min(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Min(*this, o); }
@@ -132,11 +180,41 @@ class Value {
   // space, or whether we must store only a reference to this value. If inlined
   // is false, we may use the provided data pool to allocate space for this
   // value, storing a reference into the allocated pool space in the storage.
-  inline void SerializeTo(char *storage) const { Type::GetInstance(type_id_)->SerializeTo(*this, storage); }
+  inline void SerializeTo(char *storage) const {
+    switch (type_id_) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+      case TypeId::DECIMAL:
+      case TypeId::TIMESTAMP:
+        memcpy(storage, &value_, Type::GetTypeSize(type_id_));
+        return;
+      default:
+        Type::GetInstance(type_id_)->SerializeTo(*this, storage);
+    }
+  }
 
   // Deserialize a value of the given type from the given storage space.
   inline static auto DeserializeFrom(const char *storage, const TypeId type_id) -> Value {
-    return Type::GetInstance(type_id)->DeserializeFrom(storage);
+    switch (type_id) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return {type_id, *reinterpret_cast<const int8_t *>(storage)};
+      case TypeId::SMALLINT:
+        return {type_id, *reinterpret_cast<const int16_t *>(storage)};
+      case TypeId::INTEGER:
+        return {type_id, *reinterpret_cast<const int32_t *>(storage)};
+      case TypeId::BIGINT:
+        return {type_id, *reinterpret_cast<const int64_t *>(storage)};
+      case TypeId::DECIMAL:
+        return {type_id, *reinterpret_cast<const double *>(storage)};
+      case TypeId::TIMESTAMP:
+        return {type_id, *reinterpret_cast<const uint64_t *>(storage)};
+      default:
+        return Type::GetInstance(type_id)->DeserializeFrom(storage);
+    }
   }
 
   // Return a string version of this value
@@ -163,7 +241,75 @@ class Value {
     TypeId elem_type_id_;
   } size_;
 
+  // Compare with o on the native values if both are non-null and of the same fixed-width type
+  template <class Compare>
+  inline auto CompareNative(const Value &o, Compare compare, CmpBool *result) const -> bool {
+    if (type_id_ != o.type_id_ || IsNull() || o.IsNull()) {
+      return false;
+    }
+    switch (type_id_) {
+      case TypeId::BOOLEAN:
+        *result = GetCmpBool(compare(value_.boolean_, o.value_.boolean_));
+        return true;
+      case TypeId::TINYINT:
+        *result = GetCmpBool(compare(value_.tinyint_, o.value_.tinyint_));
+        return true;
+      case TypeId::SMALLINT:
+        *result = GetCmpBool(compare(value_.smallint_, o.value_.smallint_));
+        return true;
+      case TypeId::INTEGER:
+        *result = GetCmpBool(compare(value_.integer_, o.value_.integer_));
+        return true;
+      case TypeId::BIGINT:
+        *result = GetCmpBool(compare(value_.bigint_, o.value_.bigint_));
+        return true;
+      case TypeId::DECIMAL:
+        *result = GetCmpBool(compare(value_.decimal_, o.value_.decimal_));
+        return true;
+      case TypeId::TIMESTAMP:
+        *result = GetCmpBool(compare(value_.timestamp_, o.value_.timestamp_));
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Compute with o on the native values if both are non-null INTEGER, BIGINT or DECIMAL values. An integer result that
+  // overflows is left to the Type, which throws.
+  template <class Compute>
+  inline auto ComputeNative(const Value &o, Compute compute, Value *result) const -> bool {
+    if (type_id_ != o.type_id_ || IsNull() || o.IsNull()) {
+      return false;
+    }
+    switch (type_id_) {
+      case TypeId::INTEGER: {
+        auto wide = compute(static_cast<int64_t>(value_.integer_), static_cast<int64_t>(o.value_.integer_));
+        if (wide != static_cast<int32_t>(wide)) {
+          return false;
+        }
+        *result = Value(type_id_, static_cast<int32_t>(wide));
+        return true;
+      }
+      case TypeId::BIGINT: {
+        // NOLINTNEXTLINE
+        auto wide = compute(static_cast<__int128>(value_.bigint_), static_cast<__int128>(o.value_.bigint_));
+        if (wide != static_cast<int64_t>(wide)) {
+          return false;
+        }
+        *result = Value(type_id_, static_cast<int64_t>(wide));
+        return true;
+      }
+      case TypeId::DECIMAL:
+        *result = Value(type_id_, compute(value_.decimal_, o.value_.decimal_));
+        return true;
+      default:
+        return false;
+    }
+  }
+
   bool manage_data_;
+  // Managed varlen data that lives in an arena, which frees it rather than the value
+  bool pooled_{false};
   // The data type
   TypeId type_id_;
 };
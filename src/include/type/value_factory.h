@@ -95,6 +95,9 @@ class ValueFactory {
       case TypeId::DECIMAL:
         ret_value = GetDecimalValue(BUSTUB_DECIMAL_NULL);
         break;
+      case TypeId::TIMESTAMP:
+        ret_value = GetTimestampValue(BUSTUB_TIMESTAMP_NULL);
+        break;
       case TypeId::VARCHAR:
         ret_value = GetVarcharValue(nullptr, false, nullptr);
         break;
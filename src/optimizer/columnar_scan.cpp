@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::OptimizeColumnarScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeColumnarScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // A projection or an aggregation is where the columns a query reads are known; it sits on the scan, or on a
+  // filter over the scan. Plans that write the table read whole tuples from a scan right below them.
+  std::unordered_set<uint32_t> columns;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(*optimized_plan).GetExpressions()) {
+      CollectColumns(expr, &columns);
+    }
+  } else if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &aggregation = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    for (const auto &expr : aggregation.GetGroupBys()) {
+      CollectColumns(expr, &columns);
+    }
+    for (const auto &expr : aggregation.GetAggregates()) {
+      CollectColumns(expr, &columns);
+    }
+  } else {
+    return optimized_plan;
+  }
+
+  const FilterPlanNode *filter = nullptr;
+  const AbstractPlanNode *scan_plan = optimized_plan->children_[0].get();
+  if (scan_plan->GetType() == PlanType::Filter) {
+    filter = dynamic_cast<const FilterPlanNode *>(scan_plan);
+    scan_plan = filter->children_[0].get();
+  }
+  if (scan_plan->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*scan_plan);
+  const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
+  if (seq_scan.columns_.has_value() || table_info->table_ == nullptr ||
+      table_info->table_->GetFormat() != TableFormat::PAX) {
+    return optimized_plan;
+  }
+
+  std::vector<AbstractExpressionRef> predicates;
+  if (filter != nullptr) {
+    predicates.push_back(filter->GetPredicate());
+  }
+  if (seq_scan.filter_predicate_ != nullptr) {
+    predicates.push_back(seq_scan.filter_predicate_);
+  }
+  std::unordered_set<uint32_t> filtered_columns;
+  for (const auto &predicate : predicates) {
+    CollectColumns(predicate, &filtered_columns);
+  }
+  columns.insert(filtered_columns.begin(), filtered_columns.end());
+
+  // The folded bounds only need to hold for the tuples the filters keep, so the residual predicates are dropped and
+  // exclusive bounds are taken as inclusive ones.
+  std::vector<ColumnRange> ranges;
+  for (auto col_idx : filtered_columns) {
+    ColumnRange range{col_idx, std::nullopt, std::nullopt};
+    for (const auto &predicate : predicates) {
+      std::optional<IndexScanBound> lower;
+      std::optional<IndexScanBound> upper;
+      FoldPredicateIntoIndexRange(predicate, col_idx, &lower, &upper);
+      if (lower.has_value() && (!range.lower_.has_value() ||
+                                lower->key_.CompareGreaterThan(*range.lower_) == CmpBool::CmpTrue)) {
+        range.lower_ = lower->key_;
+      }
+      if (upper.has_value() && (!range.upper_.has_value() ||
+                                upper->key_.CompareLessThan(*range.upper_) == CmpBool::CmpTrue)) {
+        range.upper_ = upper->key_;
+      }
+    }
+    if (range.lower_.has_value() || range.upper_.has_value()) {
+      ranges.push_back(std::move(range));
+    }
+  }
+  std::sort(ranges.begin(), ranges.end(),
+            [](const ColumnRange &a, const ColumnRange &b) { return a.column_idx_ < b.column_idx_; });
+
+  // A scan of every column with no ranges reads what it read before.
+  if (columns.size() == seq_scan.OutputSchema().GetColumnCount() && ranges.empty()) {
+    return optimized_plan;
+  }
+  std::vector<uint32_t> read_columns(columns.begin(), columns.end());
+  std::sort(read_columns.begin(), read_columns.end());
+
+  AbstractPlanNodeRef scan =
+      std::make_shared<SeqScanPlanNode>(seq_scan.output_schema_, seq_scan.table_oid_, seq_scan.table_name_,
+                                        seq_scan.filter_predicate_, std::move(read_columns), std::move(ranges));
+  if (filter != nullptr) {
+    scan = filter->CloneWithChildren({scan});
+  }
+  return optimized_plan->CloneWithChildren({scan});
+}
+
+}  // namespace bustub
@@ -0,0 +1,57 @@
+#include <memory>
+#include <optional>
+
+#include "catalog/catalog.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_lookup_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::OptimizeFilterAsIndexLookup(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterAsIndexLookup(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Filter) {
+    return optimized_plan;
+  }
+  const auto &filter = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+  if (filter.GetChildPlan()->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*filter.GetChildPlan());
+  if (seq_scan.filter_predicate_ != nullptr) {
+    return optimized_plan;
+  }
+
+  const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
+  for (const auto *index : catalog_.GetTableIndexes(table_info->name_)) {
+    const auto &key_attrs = index->index_->GetKeyAttrs();
+    if (index->index_type_ != IndexType::HashTableIndex || key_attrs.size() != 1) {
+      continue;
+    }
+    // the comparisons on the column have to pin it to a single key; they are all true for that key, so the rest of
+    // the predicate is all that is left to check
+    std::optional<IndexScanBound> lower;
+    std::optional<IndexScanBound> upper;
+    auto residual = FoldPredicateIntoIndexRange(filter.GetPredicate(), key_attrs[0], &lower, &upper);
+    if (!lower.has_value() || !upper.has_value() || !lower->inclusive_ || !upper->inclusive_ ||
+        lower->key_.CompareEquals(upper->key_) != CmpBool::CmpTrue) {
+      continue;
+    }
+    AbstractPlanNodeRef lookup =
+        std::make_shared<IndexLookupPlanNode>(filter.output_schema_, index->index_oid_, lower->key_);
+    if (residual != nullptr) {
+      lookup = std::make_shared<FilterPlanNode>(filter.output_schema_, residual, lookup);
+    }
+    return lookup;
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
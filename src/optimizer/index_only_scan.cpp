@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether the entries of `index` store every one of `columns` */
+auto Covers(const IndexInfo &index, const std::unordered_set<uint32_t> &columns) -> bool {
+  // an ART index keeps its keys in a normalized form that is not read back, and a hash index cannot be scanned
+  if (index.index_type_ != IndexType::BPlusTreeIndex) {
+    return false;
+  }
+  const auto &entry_attrs = index.index_->GetEntryAttrs();
+  return std::all_of(columns.begin(), columns.end(), [&](uint32_t col_idx) {
+    return std::find(entry_attrs.begin(), entry_attrs.end(), col_idx) != entry_attrs.end();
+  });
+}
+
+}  // namespace
+
+void Optimizer::CollectColumns(const AbstractExpressionRef &expr, std::unordered_set<uint32_t> *columns) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    columns->insert(column->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+auto Optimizer::OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexOnlyScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // A projection is where the columns a query reads are known; it sits on the scan, or on a filter over the scan
+  if (optimized_plan->GetType() != PlanType::Projection) {
+    return optimized_plan;
+  }
+  const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan);
+  std::unordered_set<uint32_t> columns;
+  for (const auto &expr : projection.GetExpressions()) {
+    CollectColumns(expr, &columns);
+  }
+
+  const FilterPlanNode *filter = nullptr;
+  const AbstractPlanNode *scan_plan = projection.children_[0].get();
+  if (scan_plan->GetType() == PlanType::Filter) {
+    filter = dynamic_cast<const FilterPlanNode *>(scan_plan);
+    CollectColumns(filter->GetPredicate(), &columns);
+    scan_plan = filter->children_[0].get();
+  }
+
+  AbstractPlanNodeRef index_scan;
+  AbstractExpressionRef residual = filter != nullptr ? filter->GetPredicate() : nullptr;
+  if (scan_plan->GetType() == PlanType::IndexScan) {
+    const auto &index_scan_plan = dynamic_cast<const IndexScanPlanNode &>(*scan_plan);
+    if (index_scan_plan.index_only_ || !Covers(*catalog_.GetIndex(index_scan_plan.GetIndexOid()), columns)) {
+      return optimized_plan;
+    }
+    index_scan = std::make_shared<IndexScanPlanNode>(index_scan_plan.output_schema_, index_scan_plan.index_oid_,
+                                                     index_scan_plan.reverse_, index_scan_plan.lower_bound_,
+                                                     index_scan_plan.upper_bound_, true);
+  } else if (scan_plan->GetType() == PlanType::SeqScan && filter != nullptr) {
+    // Without an order by, an index is only worth it if the filter bounds its key and it also saves the table reads.
+    const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*scan_plan);
+    if (seq_scan.filter_predicate_ != nullptr) {
+      return optimized_plan;
+    }
+    const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
+    for (const auto *index : catalog_.GetTableIndexes(table_info->name_)) {
+      const auto &key_attrs = index->index_->GetKeyAttrs();
+      if (key_attrs.size() != 1 || !Covers(*index, columns)) {
+        continue;
+      }
+      std::optional<IndexScanBound> lower;
+      std::optional<IndexScanBound> upper;
+      residual = FoldPredicateIntoIndexRange(filter->GetPredicate(), key_attrs[0], &lower, &upper);
+      if (!lower.has_value() && !upper.has_value()) {
+        continue;
+      }
+      index_scan = std::make_shared<IndexScanPlanNode>(filter->output_schema_, index->index_oid_, false,
+                                                       std::move(lower), std::move(upper), true);
+      break;
+    }
+  }
+  if (index_scan == nullptr) {
+    return optimized_plan;
+  }
+
+  if (residual != nullptr) {
+    index_scan = std::make_shared<FilterPlanNode>(filter->output_schema_, residual, index_scan);
+  }
+  return std::make_shared<ProjectionPlanNode>(projection.output_schema_, projection.GetExpressions(), index_scan);
+}
+
+}  // namespace bustub
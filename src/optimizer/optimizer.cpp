@@ -13,7 +13,10 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
     p = OptimizeMergeFilterNLJ(p);
     p = OptimizeNLJAsIndexJoin(p);
     p = OptimizeOrderByAsIndexScan(p);
+    p = OptimizeIndexOnlyScan(p);
+    p = OptimizeFilterAsIndexLookup(p);
     p = OptimizeSortLimitAsTopN(p);
+    p = OptimizeColumnarScan(p);
     return p;
   }
   // By default, use user-defined rules.
@@ -14,7 +14,10 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   p = OptimizeNLJAsIndexJoin(p);
   // p = OptimizeNLJAsHashJoin(p);  // Enable this rule after you have implemented hash join.
   p = OptimizeOrderByAsIndexScan(p);
+  p = OptimizeIndexOnlyScan(p);
+  p = OptimizeFilterAsIndexLookup(p);
   p = OptimizeSortLimitAsTopN(p);
+  p = OptimizeColumnarScan(p);
   return p;
 }
 
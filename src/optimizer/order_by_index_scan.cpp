@@ -8,7 +8,9 @@
 #include "common/exception.h"
 #include "common/macros.h"
 #include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/index_scan_plan.h"
@@ -21,6 +23,93 @@
 
 namespace bustub {
 
+namespace {
+
+/** Narrow `bound` to `candidate` if that is the tighter of the two. `is_lower` tells which end of the range it is. */
+void TightenBound(std::optional<IndexScanBound> *bound, const IndexScanBound &candidate, bool is_lower) {
+  if (!bound->has_value()) {
+    *bound = candidate;
+    return;
+  }
+  const auto &current = (*bound)->key_;
+  bool tighter = is_lower ? candidate.key_.CompareGreaterThan(current) == CmpBool::CmpTrue
+                          : candidate.key_.CompareLessThan(current) == CmpBool::CmpTrue;
+  bool same_but_exclusive = candidate.key_.CompareEquals(current) == CmpBool::CmpTrue && !candidate.inclusive_;
+  if (tighter || same_but_exclusive) {
+    *bound = candidate;
+  }
+}
+
+/** Worker of Optimizer::FoldPredicateIntoIndexRange(). Conjuncts that cannot be folded are appended to `residual`. */
+void FoldPredicateIntoRange(const AbstractExpressionRef &expr, uint32_t col_idx, std::optional<IndexScanBound> *lower,
+                            std::optional<IndexScanBound> *upper, std::vector<AbstractExpressionRef> *residual) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    FoldPredicateIntoRange(logic->GetChildAt(0), col_idx, lower, upper, residual);
+    FoldPredicateIntoRange(logic->GetChildAt(1), col_idx, lower, upper, residual);
+    return;
+  }
+
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison == nullptr || comparison->comp_type_ == ComparisonType::NotEqual) {
+    residual->push_back(expr);
+    return;
+  }
+  // accept both `column op constant` and `constant op column`, flipping the latter
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  bool flipped = false;
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    flipped = true;
+  }
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0 || column->GetColIdx() != col_idx ||
+      constant->val_.GetTypeId() != TypeId::INTEGER || constant->val_.IsNull()) {
+    residual->push_back(expr);
+    return;
+  }
+
+  const auto &key = constant->val_;
+  switch (comparison->comp_type_) {
+    case ComparisonType::Equal:
+      TightenBound(lower, {key, true}, true);
+      TightenBound(upper, {key, true}, false);
+      break;
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual: {
+      IndexScanBound bound{key, comparison->comp_type_ == ComparisonType::LessThanOrEqual};
+      TightenBound(flipped ? lower : upper, bound, flipped);
+      break;
+    }
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual: {
+      IndexScanBound bound{key, comparison->comp_type_ == ComparisonType::GreaterThanOrEqual};
+      TightenBound(flipped ? upper : lower, bound, !flipped);
+      break;
+    }
+    default:
+      residual->push_back(expr);
+  }
+}
+
+}  // namespace
+
+auto Optimizer::FoldPredicateIntoIndexRange(const AbstractExpressionRef &predicate, uint32_t col_idx,
+                                            std::optional<IndexScanBound> *lower, std::optional<IndexScanBound> *upper)
+    -> AbstractExpressionRef {
+  std::vector<AbstractExpressionRef> residual;
+  FoldPredicateIntoRange(predicate, col_idx, lower, upper, &residual);
+  if (residual.empty()) {
+    return nullptr;
+  }
+  AbstractExpressionRef rest = residual[0];
+  for (size_t i = 1; i < residual.size(); i++) {
+    rest = std::make_shared<LogicExpression>(rest, residual[i], LogicType::And);
+  }
+  return rest;
+}
+
 auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   std::vector<AbstractPlanNodeRef> children;
   for (const auto &child : plan->GetChildren()) {
@@ -37,11 +126,12 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       return optimized_plan;
     }
 
-    // Order type is asc or default
+    // Order type is asc, desc or default; descending orders scan the index backwards
     const auto &[order_type, expr] = order_bys[0];
-    if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+    if (order_type == OrderByType::INVALID) {
       return optimized_plan;
     }
+    bool reverse = order_type == OrderByType::DESC;
 
     // Order expression is a column value expression
     const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
@@ -55,17 +145,64 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
     const auto &child_plan = optimized_plan->children_[0];
 
-    if (child_plan->GetType() == PlanType::SeqScan) {
-      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+    // A projection below the sort (any select list other than `*`) stays above the index scan, as long as it passes
+    // the order by column through unchanged
+    const ProjectionPlanNode *projection = nullptr;
+    const AbstractPlanNode *scan_plan = child_plan.get();
+    if (scan_plan->GetType() == PlanType::Projection) {
+      projection = dynamic_cast<const ProjectionPlanNode *>(scan_plan);
+      const auto *passed_column =
+          dynamic_cast<const ColumnValueExpression *>(projection->GetExpressions()[order_by_column_id].get());
+      if (passed_column == nullptr) {
+        return optimized_plan;
+      }
+      order_by_column_id = passed_column->GetColIdx();
+      scan_plan = projection->children_[0].get();
+    }
+
+    // The child is a seq scan, possibly under a filter whose range predicates on the column become scan bounds
+    const FilterPlanNode *filter = nullptr;
+    if (scan_plan->GetType() == PlanType::Filter) {
+      filter = dynamic_cast<const FilterPlanNode *>(scan_plan);
+      scan_plan = filter->children_[0].get();
+    }
+
+    if (scan_plan->GetType() == PlanType::SeqScan) {
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*scan_plan);
+      if (seq_scan.filter_predicate_ != nullptr) {
+        return optimized_plan;
+      }
       const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
+        // a hash index keeps no key order
+        if (index->index_type_ == IndexType::HashTableIndex) {
+          continue;
+        }
         const auto &columns = index->key_schema_.GetColumns();
         if (columns.size() == 1 &&
             columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
           // Index matched, return index scan instead
-          return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+          AbstractPlanNodeRef index_scan;
+          if (filter == nullptr) {
+            index_scan = std::make_shared<IndexScanPlanNode>(scan_plan->output_schema_, index->index_oid_, reverse);
+          } else {
+            std::optional<IndexScanBound> lower;
+            std::optional<IndexScanBound> upper;
+            auto residual = FoldPredicateIntoIndexRange(filter->GetPredicate(), order_by_column_id, &lower, &upper);
+            index_scan = std::make_shared<IndexScanPlanNode>(filter->output_schema_, index->index_oid_, reverse,
+                                                             std::move(lower), std::move(upper));
+            // keep what the range could not absorb in a filter above the scan, which preserves the index order
+            if (residual != nullptr) {
+              index_scan = std::make_shared<FilterPlanNode>(filter->output_schema_, residual, index_scan);
+            }
+          }
+          if (projection == nullptr) {
+            return index_scan;
+          }
+          return std::make_shared<ProjectionPlanNode>(projection->output_schema_, projection->GetExpressions(),
+                                                      index_scan);
         }
       }
     }
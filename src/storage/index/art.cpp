@@ -0,0 +1,966 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art.cpp
+//
+// Identification: src/storage/index/art.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/art.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+constexpr uint64_t OBSOLETE_BIT = 1;
+constexpr uint64_t LOCKED_BIT = 2;
+
+using ChildList = std::vector<std::pair<uint8_t, ARTNode *>>;
+
+auto RidLess(const RID &a, const RID &b) -> bool { return a.Get() < b.Get(); }
+
+/** @return the version to validate reads of node against; restarts if the node has been unlinked */
+auto ReadLockOrRestart(const ARTNode *node, bool *restart) -> uint64_t {
+  uint64_t version = node->version_.load();
+  while ((version & LOCKED_BIT) != 0) {
+    std::this_thread::yield();
+    version = node->version_.load();
+  }
+  if ((version & OBSOLETE_BIT) != 0) {
+    *restart = true;
+  }
+  return version;
+}
+
+/** Restart if node was written since `version` was read. */
+void CheckOrRestart(const ARTNode *node, uint64_t version, bool *restart) {
+  if (node->version_.load() != version) {
+    *restart = true;
+  }
+}
+
+void WriteUnlock(ARTNode *node) { node->version_.fetch_add(LOCKED_BIT); }
+
+void WriteUnlockObsolete(ARTNode *node) { node->version_.fetch_add(LOCKED_BIT + OBSOLETE_BIT); }
+
+/** Write lock node unless it was written since `version` was read. Otherwise unlock `locked`, if set, and restart. */
+void UpgradeToWriteLockOrRestart(ARTNode *node, uint64_t version, bool *restart, ARTNode *locked = nullptr) {
+  if (!node->version_.compare_exchange_strong(version, version + LOCKED_BIT)) {
+    if (locked != nullptr) {
+      WriteUnlock(locked);
+    }
+    *restart = true;
+  }
+}
+
+void DeleteNode(ARTNode *node) {
+  switch (node->type_) {
+    case ARTNodeType::Leaf:
+      delete static_cast<ARTLeaf *>(node);
+      break;
+    case ARTNodeType::Node4:
+      delete static_cast<ARTNode4 *>(node);
+      break;
+    case ARTNodeType::Node16:
+      delete static_cast<ARTNode16 *>(node);
+      break;
+    case ARTNodeType::Node48:
+      delete static_cast<ARTNode48 *>(node);
+      break;
+    case ARTNodeType::Node256:
+      delete static_cast<ARTNode256 *>(node);
+      break;
+  }
+}
+
+auto NewNode(ARTNodeType type) -> ARTNode * {
+  switch (type) {
+    case ARTNodeType::Node4:
+      return new ARTNode4();
+    case ARTNodeType::Node16:
+      return new ARTNode16();
+    case ARTNodeType::Node48:
+      return new ARTNode48();
+    default:
+      return new ARTNode256();
+  }
+}
+
+/** @return the smallest node type holding `count` children */
+auto NodeTypeFor(size_t count) -> ARTNodeType {
+  if (count <= 4) {
+    return ARTNodeType::Node4;
+  }
+  if (count <= 16) {
+    return ARTNodeType::Node16;
+  }
+  if (count <= 48) {
+    return ARTNodeType::Node48;
+  }
+  return ARTNodeType::Node256;
+}
+
+auto IsFull(const ARTNode *node) -> bool {
+  switch (node->type_) {
+    case ARTNodeType::Node4:
+      return node->count_ == 4;
+    case ARTNodeType::Node16:
+      return node->count_ == 16;
+    case ARTNodeType::Node48:
+      return node->count_ == 48;
+    default:
+      return false;
+  }
+}
+
+/** @return whether removing a child leaves node small enough for the next smaller node type */
+auto ShrinksOnRemove(const ARTNode *node) -> bool {
+  switch (node->type_) {
+    case ARTNodeType::Node4:
+      return node->count_ <= 2;
+    case ARTNodeType::Node16:
+      return node->count_ <= 4;
+    case ARTNodeType::Node48:
+      return node->count_ <= 13;
+    case ARTNodeType::Node256:
+      return node->count_ <= 38;
+    default:
+      return false;
+  }
+}
+
+/** @return the slot holding the child for byte, or nullptr if there is none */
+auto ChildSlot(ARTNode *node, uint8_t byte) -> ARTNode ** {
+  switch (node->type_) {
+    case ARTNodeType::Node4: {
+      auto *n = static_cast<ARTNode4 *>(node);
+      for (int i = 0; i < std::min<int>(n->count_, 4); i++) {
+        if (n->keys_[i] == byte) {
+          return &n->children_[i];
+        }
+      }
+      return nullptr;
+    }
+    case ARTNodeType::Node16: {
+      auto *n = static_cast<ARTNode16 *>(node);
+      for (int i = 0; i < std::min<int>(n->count_, 16); i++) {
+        if (n->keys_[i] == byte) {
+          return &n->children_[i];
+        }
+      }
+      return nullptr;
+    }
+    case ARTNodeType::Node48: {
+      auto *n = static_cast<ARTNode48 *>(node);
+      uint8_t slot = n->child_index_[byte];
+      return slot < ARTNode48::EMPTY_SLOT ? &n->children_[slot] : nullptr;
+    }
+    case ARTNodeType::Node256:
+      return &static_cast<ARTNode256 *>(node)->children_[byte];
+    default:
+      return nullptr;
+  }
+}
+
+auto FindChild(ARTNode *node, uint8_t byte) -> ARTNode * {
+  auto **slot = ChildSlot(node, byte);
+  return slot == nullptr ? nullptr : *slot;
+}
+
+void ChangeChild(ARTNode *node, uint8_t byte, ARTNode *child) { *ChildSlot(node, byte) = child; }
+
+/** @return the children of node in key byte order */
+auto Children(const ARTNode *node) -> ChildList {
+  ChildList children;
+  switch (node->type_) {
+    case ARTNodeType::Node4: {
+      const auto *n = static_cast<const ARTNode4 *>(node);
+      for (int i = 0; i < std::min<int>(n->count_, 4); i++) {
+        children.emplace_back(n->keys_[i], n->children_[i]);
+      }
+      break;
+    }
+    case ARTNodeType::Node16: {
+      const auto *n = static_cast<const ARTNode16 *>(node);
+      for (int i = 0; i < std::min<int>(n->count_, 16); i++) {
+        children.emplace_back(n->keys_[i], n->children_[i]);
+      }
+      break;
+    }
+    case ARTNodeType::Node48: {
+      const auto *n = static_cast<const ARTNode48 *>(node);
+      for (int byte = 0; byte < 256; byte++) {
+        uint8_t slot = n->child_index_[byte];
+        if (slot < ARTNode48::EMPTY_SLOT && n->children_[slot] != nullptr) {
+          children.emplace_back(byte, n->children_[slot]);
+        }
+      }
+      break;
+    }
+    case ARTNodeType::Node256: {
+      const auto *n = static_cast<const ARTNode256 *>(node);
+      for (int byte = 0; byte < 256; byte++) {
+        if (n->children_[byte] != nullptr) {
+          children.emplace_back(byte, n->children_[byte]);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return children;
+}
+
+/** Add a child to a Node4 or Node16 that is not full, keeping its key bytes sorted. */
+template <typename SmallNode>
+void InsertSorted(SmallNode *n, uint8_t byte, ARTNode *child) {
+  int pos = 0;
+  while (pos < n->count_ && n->keys_[pos] < byte) {
+    pos++;
+  }
+  std::move_backward(n->keys_ + pos, n->keys_ + n->count_, n->keys_ + n->count_ + 1);
+  std::move_backward(n->children_ + pos, n->children_ + n->count_, n->children_ + n->count_ + 1);
+  n->keys_[pos] = byte;
+  n->children_[pos] = child;
+  n->count_++;
+}
+
+template <typename SmallNode>
+void RemoveSorted(SmallNode *n, uint8_t byte) {
+  int pos = std::find(n->keys_, n->keys_ + n->count_, byte) - n->keys_;
+  std::move(n->keys_ + pos + 1, n->keys_ + n->count_, n->keys_ + pos);
+  std::move(n->children_ + pos + 1, n->children_ + n->count_, n->children_ + pos);
+  n->count_--;
+}
+
+/** Add a child to a node that is not full. */
+void InsertChild(ARTNode *node, uint8_t byte, ARTNode *child) {
+  switch (node->type_) {
+    case ARTNodeType::Node4:
+      InsertSorted(static_cast<ARTNode4 *>(node), byte, child);
+      break;
+    case ARTNodeType::Node16:
+      InsertSorted(static_cast<ARTNode16 *>(node), byte, child);
+      break;
+    case ARTNodeType::Node48: {
+      auto *n = static_cast<ARTNode48 *>(node);
+      uint8_t slot = 0;
+      while (n->children_[slot] != nullptr) {
+        slot++;
+      }
+      n->children_[slot] = child;
+      n->child_index_[byte] = slot;
+      n->count_++;
+      break;
+    }
+    case ARTNodeType::Node256:
+      static_cast<ARTNode256 *>(node)->children_[byte] = child;
+      node->count_++;
+      break;
+    default:
+      UNREACHABLE("leaves have no children");
+  }
+}
+
+void RemoveChild(ARTNode *node, uint8_t byte) {
+  switch (node->type_) {
+    case ARTNodeType::Node4:
+      RemoveSorted(static_cast<ARTNode4 *>(node), byte);
+      break;
+    case ARTNodeType::Node16:
+      RemoveSorted(static_cast<ARTNode16 *>(node), byte);
+      break;
+    case ARTNodeType::Node48: {
+      auto *n = static_cast<ARTNode48 *>(node);
+      n->children_[n->child_index_[byte]] = nullptr;
+      n->child_index_[byte] = ARTNode48::EMPTY_SLOT;
+      n->count_--;
+      break;
+    }
+    case ARTNodeType::Node256:
+      static_cast<ARTNode256 *>(node)->children_[byte] = nullptr;
+      node->count_--;
+      break;
+    default:
+      UNREACHABLE("leaves have no children");
+  }
+}
+
+void SetPrefix(ARTNode *node, const char *prefix, uint32_t len) {
+  node->prefix_len_ = len;
+  memcpy(node->prefix_, prefix, std::min(len, ART_MAX_PREFIX));
+}
+
+/** @return a copy of node as `type`, without the child for `skip` if set */
+auto CopyNode(ARTNode *node, ARTNodeType type, std::optional<uint8_t> skip = std::nullopt) -> ARTNode * {
+  auto *copy = NewNode(type);
+  copy->prefix_len_ = node->prefix_len_;
+  memcpy(copy->prefix_, node->prefix_, ART_MAX_PREFIX);
+  for (const auto &[byte, child] : Children(node)) {
+    if (!skip.has_value() || byte != *skip) {
+      InsertChild(copy, byte, child);
+    }
+  }
+  return copy;
+}
+
+/**
+ * @return the whole compressed path of node, which starts at byte `level` of its keys. Bytes past the ones the node
+ * keeps are read from the smallest key below it.
+ */
+auto FullPrefix(ARTNode *node, uint32_t level, bool *restart) -> ARTKey {
+  if (node->prefix_len_ <= ART_MAX_PREFIX) {
+    return {reinterpret_cast<const char *>(node->prefix_), node->prefix_len_};
+  }
+  uint32_t prefix_len = node->prefix_len_;
+  ARTNode *below = node;
+  while (below != nullptr && below->type_ != ARTNodeType::Leaf) {
+    auto children = Children(below);
+    below = children.empty() ? nullptr : children[0].second;
+  }
+  // a concurrent writer got in the way; the caller validates its version and would restart anyway
+  if (below == nullptr || static_cast<ARTLeaf *>(below)->key_.size() < level + prefix_len) {
+    *restart = true;
+    return {};
+  }
+  return static_cast<ARTLeaf *>(below)->key_.substr(level, prefix_len);
+}
+
+void FreeSubtree(ARTNode *node) {
+  for (const auto &[byte, child] : Children(node)) {
+    FreeSubtree(child);
+  }
+  DeleteNode(node);
+}
+
+}  // namespace
+
+/*****************************************************************************
+ * EPOCHS
+ *****************************************************************************/
+ARTEpochManager::~ARTEpochManager() { ReclaimAll(); }
+
+auto ARTEpochManager::Enter() -> uint64_t {
+  while (true) {
+    auto epoch = epoch_.load();
+    active_[epoch % 3].fetch_add(1);
+    // the epoch may have moved on before we were counted in it
+    if (epoch_.load() == epoch) {
+      return epoch;
+    }
+    active_[epoch % 3].fetch_sub(1);
+  }
+}
+
+void ARTEpochManager::Exit(uint64_t epoch) {
+  active_[epoch % 3].fetch_sub(1);
+  if (retired_count_.load() == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(latch_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
+  }
+  auto current = epoch_.load();
+  // slot (current + 2) % 3 is the previous epoch
+  if (active_[(current + 2) % 3].load() != 0) {
+    return;
+  }
+  epoch_.store(current + 1);
+  // Operations of the previous epoch are gone, and so were those of the one before when the epoch last moved on, so
+  // nothing can reach the nodes retired in the previous epoch any more.
+  auto &retired = retired_[(current + 2) % 3];
+  for (auto *node : retired) {
+    DeleteNode(node);
+  }
+  retired_count_.fetch_sub(retired.size());
+  retired.clear();
+}
+
+void ARTEpochManager::Retire(ARTNode *node) {
+  std::scoped_lock lock(latch_);
+  retired_[epoch_.load() % 3].push_back(node);
+  retired_count_.fetch_add(1);
+}
+
+void ARTEpochManager::ReclaimAll() {
+  std::scoped_lock lock(latch_);
+  for (auto &retired : retired_) {
+    for (auto *node : retired) {
+      DeleteNode(node);
+    }
+    retired.clear();
+  }
+  retired_count_.store(0);
+}
+
+/*****************************************************************************
+ * TREE
+ *****************************************************************************/
+AdaptiveRadixTree::AdaptiveRadixTree(bool unique) : root_(new ARTNode256()), unique_(unique) {}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() { FreeSubtree(root_); }
+
+template <typename Op>
+auto AdaptiveRadixTree::Retry(Op &&op) -> decltype(op(nullptr)) {
+  auto epoch = epoch_manager_.Enter();
+  while (true) {
+    bool restart = false;
+    auto result = op(&restart);
+    if (!restart) {
+      epoch_manager_.Exit(epoch);
+      return result;
+    }
+  }
+}
+
+auto AdaptiveRadixTree::Insert(const ARTKey &key, const RID &value, bool allow_duplicate) -> bool {
+  return Retry([&](bool *restart) { return TryInsert(key, value, allow_duplicate, restart); });
+}
+
+auto AdaptiveRadixTree::Remove(const ARTKey &key, const RID &value) -> bool {
+  return Retry([&](bool *restart) { return TryRemove(key, &value, restart); });
+}
+
+auto AdaptiveRadixTree::Remove(const ARTKey &key) -> bool {
+  return Retry([&](bool *restart) { return TryRemove(key, nullptr, restart); });
+}
+
+auto AdaptiveRadixTree::GetValue(const ARTKey &key, std::vector<RID> *result) -> bool {
+  size_t size = result->size();
+  return Retry([&](bool *restart) {
+    result->resize(size);
+    return TryGetValue(key, result, restart);
+  });
+}
+
+auto AdaptiveRadixTree::IsEmpty() -> bool {
+  return Retry([&](bool *restart) {
+    auto version = ReadLockOrRestart(root_, restart);
+    bool empty = root_->count_ == 0;
+    CheckOrRestart(root_, version, restart);
+    return empty;
+  });
+}
+
+auto AdaptiveRadixTree::TryInsert(const ARTKey &key, const RID &value, bool allow_duplicate, bool *restart) -> bool {
+  ARTNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  ARTNode *node = root_;
+  uint64_t version = ReadLockOrRestart(node, restart);
+  if (*restart) {
+    return false;
+  }
+  uint32_t level = 0;
+
+  while (true) {
+    if (node->prefix_len_ > 0) {
+      auto prefix = FullPrefix(node, level, restart);
+      CheckOrRestart(node, version, restart);
+      if (*restart) {
+        return false;
+      }
+      uint32_t match = 0;
+      while (match < prefix.size() && level + match < key.size() && prefix[match] == key[level + match]) {
+        match++;
+      }
+      if (match < prefix.size()) {
+        BUSTUB_ASSERT(level + match < key.size(), "keys must be prefix free");
+        // The key leaves the path inside the prefix: a new node takes the matching part, with the old node and the
+        // new key below it.
+        UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+        if (*restart) {
+          return false;
+        }
+        UpgradeToWriteLockOrRestart(node, version, restart, parent);
+        if (*restart) {
+          return false;
+        }
+        auto *split = new ARTNode4();
+        SetPrefix(split, prefix.data(), match);
+        InsertChild(split, prefix[match], node);
+        InsertChild(split, key[level + match], new ARTLeaf(key, {value}));
+        SetPrefix(node, prefix.data() + match + 1, prefix.size() - match - 1);
+        ChangeChild(parent, parent_byte, split);
+        WriteUnlock(node);
+        WriteUnlock(parent);
+        return true;
+      }
+      level += prefix.size();
+    }
+    BUSTUB_ASSERT(level < key.size(), "keys must be prefix free");
+
+    uint8_t byte = key[level];
+    ARTNode *child = FindChild(node, byte);
+    CheckOrRestart(node, version, restart);
+    if (*restart) {
+      return false;
+    }
+
+    if (child == nullptr) {
+      if (!IsFull(node)) {
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (*restart) {
+          return false;
+        }
+        InsertChild(node, byte, new ARTLeaf(key, {value}));
+        WriteUnlock(node);
+        return true;
+      }
+      // replace the node with a larger one, which takes the new key as well
+      UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+      UpgradeToWriteLockOrRestart(node, version, restart, parent);
+      if (*restart) {
+        return false;
+      }
+      auto *larger = CopyNode(node, static_cast<ARTNodeType>(static_cast<uint8_t>(node->type_) + 1));
+      InsertChild(larger, byte, new ARTLeaf(key, {value}));
+      ChangeChild(parent, parent_byte, larger);
+      WriteUnlockObsolete(node);
+      WriteUnlock(parent);
+      epoch_manager_.Retire(node);
+      return true;
+    }
+
+    if (child->type_ == ARTNodeType::Leaf) {
+      auto *leaf = static_cast<ARTLeaf *>(child);
+      bool unique = unique_ && !allow_duplicate;
+      if (leaf->key_ == key &&
+          (unique || std::binary_search(leaf->values_.begin(), leaf->values_.end(), value, RidLess))) {
+        return false;
+      }
+      UpgradeToWriteLockOrRestart(node, version, restart);
+      if (*restart) {
+        return false;
+      }
+      if (leaf->key_ == key) {
+        std::vector<RID> values = leaf->values_;
+        values.insert(std::upper_bound(values.begin(), values.end(), value, RidLess), value);
+        ChangeChild(node, byte, new ARTLeaf(key, std::move(values)));
+        WriteUnlock(node);
+        epoch_manager_.Retire(leaf);
+        return true;
+      }
+      // the two keys part further down: a new node holds both leaves under their common bytes
+      uint32_t depth = level + 1;
+      uint32_t common = 0;
+      while (depth + common < key.size() && depth + common < leaf->key_.size() &&
+             key[depth + common] == leaf->key_[depth + common]) {
+        common++;
+      }
+      BUSTUB_ASSERT(depth + common < key.size() && depth + common < leaf->key_.size(), "keys must be prefix free");
+      auto *split = new ARTNode4();
+      SetPrefix(split, key.data() + depth, common);
+      InsertChild(split, leaf->key_[depth + common], leaf);
+      InsertChild(split, key[depth + common], new ARTLeaf(key, {value}));
+      ChangeChild(node, byte, split);
+      WriteUnlock(node);
+      return true;
+    }
+
+    // The child may have been changed before its version was read, e.g. by taking over a path it was under, so the
+    // node is checked once more.
+    auto child_version = ReadLockOrRestart(child, restart);
+    CheckOrRestart(node, version, restart);
+    if (*restart) {
+      return false;
+    }
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = child;
+    version = child_version;
+    level++;
+  }
+}
+
+auto AdaptiveRadixTree::TryRemove(const ARTKey &key, const RID *value, bool *restart) -> bool {
+  ARTNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  ARTNode *node = root_;
+  uint64_t version = ReadLockOrRestart(node, restart);
+  if (*restart) {
+    return false;
+  }
+  uint32_t level = 0;
+
+  while (true) {
+    // Only the kept prefix bytes are compared; the leaf has the whole key to settle the rest.
+    uint32_t kept = std::min(node->prefix_len_, ART_MAX_PREFIX);
+    for (uint32_t i = 0; i < kept; i++) {
+      if (level + i >= key.size() || node->prefix_[i] != static_cast<uint8_t>(key[level + i])) {
+        CheckOrRestart(node, version, restart);
+        return false;
+      }
+    }
+    level += node->prefix_len_;
+    if (level >= key.size()) {
+      CheckOrRestart(node, version, restart);
+      return false;
+    }
+
+    uint8_t byte = key[level];
+    ARTNode *child = FindChild(node, byte);
+    CheckOrRestart(node, version, restart);
+    if (*restart || child == nullptr) {
+      return false;
+    }
+
+    if (child->type_ == ARTNodeType::Leaf) {
+      auto *leaf = static_cast<ARTLeaf *>(child);
+      if (leaf->key_ != key) {
+        return false;
+      }
+      std::vector<RID> values;
+      if (value != nullptr) {
+        auto it = std::lower_bound(leaf->values_.begin(), leaf->values_.end(), *value, RidLess);
+        if (it == leaf->values_.end() || !(*it == *value)) {
+          return false;
+        }
+        values = leaf->values_;
+        values.erase(values.begin() + (it - leaf->values_.begin()));
+      }
+
+      if (!values.empty()) {
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (*restart) {
+          return false;
+        }
+        ChangeChild(node, byte, new ARTLeaf(key, std::move(values)));
+        WriteUnlock(node);
+        epoch_manager_.Retire(leaf);
+        return true;
+      }
+
+      if (parent == nullptr || !ShrinksOnRemove(node)) {
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (*restart) {
+          return false;
+        }
+        RemoveChild(node, byte);
+        WriteUnlock(node);
+        epoch_manager_.Retire(leaf);
+        return true;
+      }
+
+      UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+      UpgradeToWriteLockOrRestart(node, version, restart, parent);
+      if (*restart) {
+        return false;
+      }
+      if (node->type_ == ARTNodeType::Node4) {
+        // A single child is left; it takes the node's place, with the node's path prepended to its own.
+        auto children = Children(node);
+        auto [other_byte, other] = children[0].first == byte ? children[1] : children[0];
+        if (other->type_ != ARTNodeType::Leaf) {
+          auto other_version = ReadLockOrRestart(other, restart);
+          if (!*restart) {
+            UpgradeToWriteLockOrRestart(other, other_version, restart);
+          }
+          if (*restart) {
+            WriteUnlock(node);
+            WriteUnlock(parent);
+            return false;
+          }
+          uint8_t prefix[ART_MAX_PREFIX];
+          uint32_t len = std::min(node->prefix_len_, ART_MAX_PREFIX);
+          memcpy(prefix, node->prefix_, len);
+          if (len < ART_MAX_PREFIX) {
+            prefix[len++] = other_byte;
+          }
+          memcpy(prefix + len, other->prefix_, std::min(other->prefix_len_, ART_MAX_PREFIX - len));
+          other->prefix_len_ += node->prefix_len_ + 1;
+          memcpy(other->prefix_, prefix, ART_MAX_PREFIX);
+          WriteUnlock(other);
+        }
+        ChangeChild(parent, parent_byte, other);
+      } else {
+        auto *smaller = CopyNode(node, static_cast<ARTNodeType>(static_cast<uint8_t>(node->type_) - 1), byte);
+        ChangeChild(parent, parent_byte, smaller);
+      }
+      WriteUnlockObsolete(node);
+      WriteUnlock(parent);
+      epoch_manager_.Retire(node);
+      epoch_manager_.Retire(leaf);
+      return true;
+    }
+
+    // The child may have been changed before its version was read, e.g. by taking over a path it was under, so the
+    // node is checked once more.
+    auto child_version = ReadLockOrRestart(child, restart);
+    CheckOrRestart(node, version, restart);
+    if (*restart) {
+      return false;
+    }
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = child;
+    version = child_version;
+    level++;
+  }
+}
+
+auto AdaptiveRadixTree::TryGetValue(const ARTKey &key, std::vector<RID> *result, bool *restart) -> bool {
+  ARTNode *node = root_;
+  uint64_t version = ReadLockOrRestart(node, restart);
+  uint32_t level = 0;
+
+  while (!*restart) {
+    // Only the kept prefix bytes are compared; the leaf has the whole key to settle the rest.
+    uint32_t kept = std::min(node->prefix_len_, ART_MAX_PREFIX);
+    for (uint32_t i = 0; i < kept; i++) {
+      if (level + i >= key.size() || node->prefix_[i] != static_cast<uint8_t>(key[level + i])) {
+        CheckOrRestart(node, version, restart);
+        return false;
+      }
+    }
+    level += node->prefix_len_;
+    if (level >= key.size()) {
+      CheckOrRestart(node, version, restart);
+      return false;
+    }
+
+    ARTNode *child = FindChild(node, key[level]);
+    CheckOrRestart(node, version, restart);
+    if (*restart || child == nullptr) {
+      return false;
+    }
+    if (child->type_ == ARTNodeType::Leaf) {
+      auto *leaf = static_cast<ARTLeaf *>(child);
+      if (leaf->key_ != key) {
+        return false;
+      }
+      result->insert(result->end(), leaf->values_.begin(), leaf->values_.end());
+      return true;
+    }
+    auto child_version = ReadLockOrRestart(child, restart);
+    CheckOrRestart(node, version, restart);
+    node = child;
+    version = child_version;
+    level++;
+  }
+  return false;
+}
+
+void AdaptiveRadixTree::Scan(const std::optional<ARTKey> &start, bool start_inclusive,
+                             const std::optional<ARTKey> &stop, bool reverse, size_t limit,
+                             std::vector<std::pair<ARTKey, std::vector<RID>>> *result) {
+  size_t size = result->size();
+  Retry([&](bool *restart) {
+    result->resize(size);
+    return ScanNode(root_, nullptr, 0, 0, start.has_value() ? &*start : nullptr, start_inclusive, stop, reverse,
+                    size + limit, result, restart);
+  });
+}
+
+auto AdaptiveRadixTree::ScanNode(ARTNode *node, const ARTNode *parent, uint64_t parent_version, uint32_t level,
+                                 const ARTKey *start, bool start_inclusive, const std::optional<ARTKey> &stop,
+                                 bool reverse, size_t limit, std::vector<std::pair<ARTKey, std::vector<RID>>> *result,
+                                 bool *restart) -> bool {
+  if (node->type_ == ARTNodeType::Leaf) {
+    auto *leaf = static_cast<ARTLeaf *>(node);
+    if (start != nullptr) {
+      int cmp = leaf->key_.compare(*start);
+      if ((reverse ? cmp > 0 : cmp < 0) || (cmp == 0 && !start_inclusive)) {
+        return false;
+      }
+    }
+    if (stop.has_value() && (reverse ? leaf->key_ < *stop : leaf->key_ > *stop)) {
+      return true;
+    }
+    result->emplace_back(leaf->key_, leaf->values_);
+    return result->size() >= limit;
+  }
+
+  auto version = ReadLockOrRestart(node, restart);
+  if (parent != nullptr) {
+    CheckOrRestart(parent, parent_version, restart);
+  }
+  if (*restart) {
+    return true;
+  }
+  uint32_t prefix_len = node->prefix_len_;
+  auto prefix = start != nullptr && prefix_len > 0 ? FullPrefix(node, level, restart) : ARTKey{};
+  auto children = Children(node);
+  CheckOrRestart(node, version, restart);
+  if (*restart) {
+    return true;
+  }
+
+  if (start != nullptr && prefix_len > 0) {
+    // a start key that ends inside the prefix sorts before every key of the subtree
+    int cmp = prefix.compare(0, prefix_len, *start, std::min<size_t>(level, start->size()), prefix_len);
+    if (reverse ? cmp > 0 : cmp < 0) {
+      return false;
+    }
+    if (cmp != 0) {
+      start = nullptr;
+    }
+  }
+  level += prefix_len;
+  if (start != nullptr && level >= start->size()) {
+    if (reverse) {
+      return false;
+    }
+    start = nullptr;
+  }
+
+  if (reverse) {
+    std::reverse(children.begin(), children.end());
+  }
+  for (const auto &[byte, child] : children) {
+    const ARTKey *child_start = nullptr;
+    if (start != nullptr) {
+      auto start_byte = static_cast<uint8_t>((*start)[level]);
+      if (reverse ? byte > start_byte : byte < start_byte) {
+        continue;
+      }
+      if (byte == start_byte) {
+        child_start = start;
+      }
+    }
+    if (ScanNode(child, node, version, level + 1, child_start, start_inclusive, stop, reverse, limit, result,
+                 restart)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto AdaptiveRadixTree::BulkLoad(std::vector<std::pair<ARTKey, RID>> entries) -> bool {
+  BUSTUB_ENSURE(IsEmpty(), "bulk load needs an empty tree");
+  std::stable_sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+  if (unique_ && std::adjacent_find(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+                   return a.first == b.first;
+                 }) != entries.end()) {
+    return false;
+  }
+
+  std::vector<ARTLeaf *> leaves;
+  for (size_t begin = 0; begin < entries.size();) {
+    size_t end = begin + 1;
+    while (end < entries.size() && entries[end].first == entries[begin].first) {
+      end++;
+    }
+    std::vector<RID> values;
+    for (size_t i = begin; i < end; i++) {
+      values.push_back(entries[i].second);
+    }
+    std::sort(values.begin(), values.end(), RidLess);
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    leaves.push_back(new ARTLeaf(std::move(entries[begin].first), std::move(values)));
+    begin = end;
+  }
+
+  // the root is never replaced, so its children are filled in directly
+  for (size_t begin = 0; begin < leaves.size();) {
+    size_t end = begin + 1;
+    while (end < leaves.size() && leaves[end]->key_[0] == leaves[begin]->key_[0]) {
+      end++;
+    }
+    InsertChild(root_, leaves[begin]->key_[0], Build(&leaves, begin, end, 1));
+    begin = end;
+  }
+  return true;
+}
+
+auto AdaptiveRadixTree::Build(std::vector<ARTLeaf *> *leaves, size_t begin, size_t end, uint32_t level) -> ARTNode * {
+  if (end - begin == 1) {
+    return (*leaves)[begin];
+  }
+  // the leaves are sorted, so the first and last key share what all of them share
+  const auto &first = (*leaves)[begin]->key_;
+  const auto &last = (*leaves)[end - 1]->key_;
+  uint32_t common = 0;
+  while (level + common < first.size() && level + common < last.size() &&
+         first[level + common] == last[level + common]) {
+    common++;
+  }
+  uint32_t depth = level + common;
+  BUSTUB_ASSERT(depth < first.size() && depth < last.size(), "keys must be prefix free");
+
+  std::vector<size_t> group_starts;
+  for (size_t i = begin; i < end; i++) {
+    if (i == begin || (*leaves)[i]->key_[depth] != (*leaves)[i - 1]->key_[depth]) {
+      group_starts.push_back(i);
+    }
+  }
+  auto *node = NewNode(NodeTypeFor(group_starts.size()));
+  SetPrefix(node, first.data() + level, common);
+  for (size_t g = 0; g < group_starts.size(); g++) {
+    size_t group_end = g + 1 < group_starts.size() ? group_starts[g + 1] : end;
+    InsertChild(node, (*leaves)[group_starts[g]]->key_[depth], Build(leaves, group_starts[g], group_end, depth + 1));
+  }
+  return node;
+}
+
+/*****************************************************************************
+ * ITERATOR
+ *****************************************************************************/
+ARTIterator::ARTIterator(AdaptiveRadixTree *tree, std::optional<ARTKey> start, std::optional<ARTKey> stop,
+                         bool reverse)
+    : tree_(tree), start_(std::move(start)), stop_(std::move(stop)), reverse_(reverse) {
+  Refill(true);
+}
+
+auto ARTIterator::operator*() -> std::pair<const ARTKey &, RID> {
+  const auto &[key, values] = batch_[key_index_];
+  // the values of a key come backwards too
+  return {key, values[reverse_ ? values.size() - 1 - value_index_ : value_index_]};
+}
+
+auto ARTIterator::operator++() -> ARTIterator & {
+  if (++value_index_ < batch_[key_index_].second.size()) {
+    return *this;
+  }
+  value_index_ = 0;
+  if (++key_index_ < batch_.size()) {
+    return *this;
+  }
+  // a short batch means the scan ran out of keys
+  if (batch_.size() < BATCH_SIZE) {
+    *this = ARTIterator();
+    return *this;
+  }
+  start_ = batch_.back().first;
+  Refill(false);
+  return *this;
+}
+
+auto ARTIterator::operator==(const ARTIterator &itr) const -> bool {
+  if (IsEnd() || itr.IsEnd()) {
+    return IsEnd() && itr.IsEnd();
+  }
+  return tree_ == itr.tree_ && batch_[key_index_].first == itr.batch_[itr.key_index_].first &&
+         value_index_ == itr.value_index_;
+}
+
+void ARTIterator::Refill(bool start_inclusive) {
+  batch_.clear();
+  key_index_ = 0;
+  value_index_ = 0;
+  tree_->Scan(start_, start_inclusive, stop_, reverse_, BATCH_SIZE, &batch_);
+  if (batch_.empty()) {
+    *this = ARTIterator();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.cpp
+//
+// Identification: src/storage/index/art_index.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/art_index.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Append the low `bytes` bytes of bits, most significant first. */
+void AppendBigEndian(uint64_t bits, int bytes, ARTKey *out) {
+  for (int i = bytes - 1; i >= 0; i--) {
+    out->push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+  }
+}
+
+/** Append a signed integer so that the bytes compare like the numbers. */
+void AppendSigned(int64_t value, int bytes, ARTKey *out) {
+  uint64_t sign = uint64_t{1} << (8 * bytes - 1);
+  AppendBigEndian(static_cast<uint64_t>(value) ^ sign, bytes, out);
+}
+
+}  // namespace
+
+ARTIndex::ARTIndex(std::unique_ptr<IndexMetadata> &&metadata)
+    : Index(std::move(metadata)), container_(GetMetadata()->IsUnique()) {
+  BUSTUB_ENSURE(GetMetadata()->GetIncludeAttrs().empty(), "ART indexes have no included columns");
+}
+
+auto ARTIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  // NULL never equals another key, so even a unique index keeps every tuple with a NULL key
+  bool has_null = false;
+  ARTKey art_key = NormalizeKey(key, &has_null);
+  return container_.Insert(art_key, rid, has_null);
+}
+
+void ARTIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // only this tuple's entry goes; other tuples may share the key
+  container_.Remove(NormalizeKey(key), rid);
+}
+
+void ARTIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_.GetValue(NormalizeKey(key), result);
+}
+
+auto ARTIndex::BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries) -> bool {
+  std::vector<std::pair<ARTKey, RID>> keys;
+  std::vector<std::pair<ARTKey, RID>> null_keys;
+  keys.reserve(entries.size());
+  for (const auto &[key, rid] : entries) {
+    bool has_null = false;
+    ARTKey art_key = NormalizeKey(key, &has_null);
+    (has_null && container_.IsUnique() ? null_keys : keys).emplace_back(std::move(art_key), rid);
+  }
+  if (!container_.BulkLoad(std::move(keys))) {
+    return false;
+  }
+  // the bulk load would count repeated NULL keys as duplicates
+  for (const auto &[key, rid] : null_keys) {
+    container_.Insert(key, rid, true);
+  }
+  return true;
+}
+
+auto ARTIndex::GetBeginIterator() -> ARTIterator { return {&container_, std::nullopt, std::nullopt, false}; }
+
+auto ARTIndex::GetBeginIterator(const Tuple &key, const Tuple &stop_key) -> ARTIterator {
+  return {&container_, NormalizeKey(key), NormalizeKey(stop_key), false};
+}
+
+auto ARTIndex::GetReverseBeginIterator(const Tuple &key, const Tuple &stop_key) -> ARTIterator {
+  return {&container_, NormalizeKey(key), NormalizeKey(stop_key), true};
+}
+
+auto ARTIndex::GetEndIterator() -> ARTIterator { return {}; }
+
+auto ARTIndex::NormalizeKey(const Tuple &key, bool *has_null) const -> ARTKey {
+  const auto *schema = GetKeySchema();
+  ARTKey out;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    auto value = key.GetValue(schema, i);
+    if (value.IsNull()) {
+      if (has_null != nullptr) {
+        *has_null = true;
+      }
+      out.push_back(0);
+      continue;
+    }
+    out.push_back(1);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendSigned(value.GetAs<int8_t>(), 1, &out);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned(value.GetAs<int16_t>(), 2, &out);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned(value.GetAs<int32_t>(), 4, &out);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned(value.GetAs<int64_t>(), 8, &out);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), 8, &out);
+        break;
+      case TypeId::DECIMAL: {
+        auto number = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
+        bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63);
+        AppendBigEndian(bits, 8, &out);
+        break;
+      }
+      case TypeId::VARCHAR:
+        for (char c : value.ToString()) {
+          out.push_back(c);
+          if (c == 0) {
+            out.push_back(static_cast<char>(0xff));
+          }
+        }
+        out.push_back(0);
+        out.push_back(0);
+        break;
+      default:
+        throw NotImplementedException("unsupported type in an ART index key");
+    }
+  }
+  return out;
+}
+
+}  // namespace bustub
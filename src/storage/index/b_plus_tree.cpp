@@ -1,4 +1,5 @@
 #include <string>
+#include <thread>  // NOLINT
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -10,33 +11,209 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
+                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size, bool unique)
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size),
-      header_page_id_(header_page_id) {}
+      header_page_id_(header_page_id),
+      unique_(unique) {
+  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
+  auto root_page = guard.AsMut<BPlusTreeRootPage>();
+  root_page->root_page_id_ = INVALID_PAGE_ID;
+}
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeRootPage>()->root_page_id_ == INVALID_PAGE_ID;
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values associated with input key: the only one of a key that
+ * does not allow duplicates, and every one in its posting list otherwise
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
-  return false;
+  auto guard = FindLeafRead(&key);
+  if (!guard.has_value()) {
+    return false;
+  }
+  ValueType value;
+  if (!guard->template As<LeafPage>()->Lookup(key, &value, comparator_)) {
+    return false;
+  }
+  if (AllowsDuplicates(key) && BPlusTreePostingPage::IsPostingList(value)) {
+    CollectPostingList(value.GetPageId(), result);
+  } else {
+    result->push_back(value);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType *key) -> std::optional<ReadPageGuard> {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeRootPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  // Assigning the child guard latches the child before the parent is released.
+  guard = bpm_->FetchPageRead(page_id);
+  while (true) {
+    if (key != nullptr) {
+      MoveRight(&guard, *key);
+    }
+    auto page = guard.As<BPlusTreePage>();
+    if (page->IsLeafPage()) {
+      return guard;
+    }
+    auto internal = reinterpret_cast<const InternalPage *>(page);
+    page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_);
+    guard = bpm_->FetchPageRead(page_id);
+  }
+}
+
+/*****************************************************************************
+ * LATCHING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+template <typename Guard>
+void BPLUSTREE_TYPE::MoveRight(Guard *guard, const KeyType &key) {
+  while (true) {
+    KeyType high_key;
+    page_id_t next_page_id = RightLink(guard->template As<BPlusTreePage>(), &high_key);
+    if (next_page_id == INVALID_PAGE_ID || comparator_(key, high_key) < 0) {
+      return;
+    }
+    // the right-hand side latches the sibling before the assignment releases this page
+    if constexpr (std::is_same_v<Guard, WritePageGuard>) {
+      *guard = bpm_->FetchPageWrite(next_page_id);
+    } else {
+      *guard = bpm_->FetchPageRead(next_page_id);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RightLink(const BPlusTreePage *page, KeyType *high_key) const -> page_id_t {
+  page_id_t next_page_id;
+  if (page->IsLeafPage()) {
+    auto leaf = reinterpret_cast<const LeafPage *>(page);
+    next_page_id = leaf->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      *high_key = leaf->GetHighKey();
+    }
+  } else {
+    auto internal = reinterpret_cast<const InternalPage *>(page);
+    next_page_id = internal->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      *high_key = internal->GetHighKey();
+    }
+  }
+  return next_page_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FixPrevLink(const LeafPage *leaf, page_id_t leaf_page_id) {
+  // latched left to right, with the page on the left still held
+  if (leaf->GetNextPageId() != INVALID_PAGE_ID) {
+    WritePageGuard next_guard = bpm_->FetchPageWrite(leaf->GetNextPageId());
+    next_guard.AsMut<LeafPage>()->SetPrevPageId(leaf_page_id);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafeToRemove(const BPlusTreePage *page, bool is_root, bool lazy_merge) const -> bool {
+  if (is_root) {
+    // the root leaf may shrink to one entry, the root internal page to two children
+    return page->IsLeafPage() ? page->GetSize() > 1 : page->GetSize() > 2;
+  }
+  return page->GetSize() > UnderflowSize(page, lazy_merge);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::UnderflowSize(const BPlusTreePage *page, bool lazy_merge) const -> int {
+  if (lazy_merge) {
+    // an empty leaf, or an internal page left with one child and no key
+    return page->IsLeafPage() ? 1 : 2;
+  }
+  return page->GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseAncestors(Context *ctx) {
+  ctx->header_page_ = std::nullopt;
+  while (ctx->write_set_.size() > 1) {
+    ctx->write_set_.pop_front();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, Context *ctx) -> bool {
+  ctx->header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  ctx->root_page_id_ = ctx->header_page_->template As<BPlusTreeRootPage>()->root_page_id_;
+  if (ctx->root_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  page_id_t page_id = ctx->root_page_id_;
+  while (true) {
+    ctx->write_set_.push_back(bpm_->FetchPageWrite(page_id));
+    auto page = ctx->write_set_.back().template As<BPlusTreePage>();
+    if (IsSafeToRemove(page, ctx->IsRootPage(page_id), ctx->lazy_merge_)) {
+      ReleaseAncestors(ctx);
+    }
+    if (page->IsLeafPage()) {
+      return true;
+    }
+    page_id = reinterpret_cast<const InternalPage *>(page)->Lookup(key, comparator_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key, Context *ctx, bool latch_leaf) -> bool {
+  ctx->read_set_.push_back(bpm_->FetchPageRead(header_page_id_));
+  ctx->root_page_id_ = ctx->read_set_.back().template As<BPlusTreeRootPage>()->root_page_id_;
+  if (ctx->root_page_id_ == INVALID_PAGE_ID) {
+    ctx->read_set_.clear();
+    return false;
+  }
+  page_id_t page_id = ctx->root_page_id_;
+  while (true) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      guard.Drop();
+      if (latch_leaf) {
+        // The page we hold still points at the leaf, and merges write latch it, so the leaf cannot be freed while
+        // we trade its read latch for a write latch. It can split in between, hence the move right.
+        ctx->write_set_.push_back(bpm_->FetchPageWrite(page_id));
+        MoveRight(&ctx->write_set_.back(), key);
+      }
+      ctx->read_set_.clear();
+      return true;
+    }
+    MoveRight(&guard, key);
+    ctx->path_.push_back(guard.PageId());
+    page_id = guard.As<InternalPage>()->Lookup(key, comparator_);
+    ctx->read_set_.clear();
+    ctx->read_set_.push_back(std::move(guard));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewTreePage(page_id_t *page_id) -> BasicPageGuard {
+  *page_id = INVALID_PAGE_ID;
+  auto guard = bpm_->NewPageGuarded(page_id);
+  BUSTUB_ENSURE(*page_id != INVALID_PAGE_ID, "buffer pool has no free frame");
+  return guard;
 }
 
 /*****************************************************************************
@@ -46,15 +223,224 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * Inserts descend with read latches and write latch only the leaf. A split
+ * links the new page in through the right link first, so readers can already
+ * find it, and then pushes the separator up one level at a time.
+ * A non-unique tree adds the value of a key that is already present to the
+ * key's posting list instead, which leaves the leaf size unchanged, and a
+ * unique tree does the same for a key with a NULL column.
+ * @return: false if the tree is unique and the key (without NULLs) is
+ * present, or if the pair is present; otherwise true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  std::shared_lock<std::shared_mutex> structure_lock(structure_latch_);
   Context ctx;
-  (void)ctx;
-  return false;
+  while (!FindLeafOptimistic(key, &ctx)) {
+    // start a new tree, unless another insert got there first
+    WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+    if (header_guard.As<BPlusTreeRootPage>()->root_page_id_ == INVALID_PAGE_ID) {
+      page_id_t root_page_id;
+      BasicPageGuard root_guard = NewTreePage(&root_page_id);
+      auto root = root_guard.AsMut<LeafPage>();
+      root->Init(root_page_id, INVALID_PAGE_ID, leaf_max_size_);
+      root->Insert(key, value, comparator_);
+      header_guard.AsMut<BPlusTreeRootPage>()->root_page_id_ = root_page_id;
+      return true;
+    }
+  }
+
+  auto &leaf_guard = ctx.write_set_.back();
+  page_id_t leaf_page_id = leaf_guard.PageId();
+  auto leaf = leaf_guard.AsMut<LeafPage>();
+  if (AllowsDuplicates(key)) {
+    int index = leaf->KeyIndex(key, comparator_);
+    if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+      return InsertIntoPostingList(leaf, index, value);
+    }
+  }
+  if (!leaf->Insert(key, value, comparator_)) {
+    return false;
+  }
+  if (leaf->GetSize() < leaf->GetMaxSize()) {
+    return true;
+  }
+
+  // split the leaf; the new page is complete before the right link makes it reachable
+  page_id_t new_page_id;
+  BasicPageGuard new_guard = NewTreePage(&new_page_id);
+  auto new_leaf = new_guard.AsMut<LeafPage>();
+  new_leaf->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->MoveHalfTo(new_leaf, new_page_id);
+  FixPrevLink(new_leaf, new_page_id);
+  splits_++;
+  KeyType separator = new_leaf->KeyAt(0);
+  new_guard.Drop();
+
+  InsertIntoParent(&ctx, leaf_page_id, 0, separator, new_page_id);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(Context *ctx, page_id_t old_page_id, int height, const KeyType &key,
+                                      page_id_t new_page_id) {
+  // Latches are only taken top down and left to right, so the split page is released before the level above is
+  // latched. The new page stays reachable through the right link meanwhile.
+  ctx->write_set_.clear();
+
+  while (ctx->path_.empty()) {
+    WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+    if (header_guard.As<BPlusTreeRootPage>()->root_page_id_ == old_page_id) {
+      page_id_t root_page_id;
+      BasicPageGuard root_guard = NewTreePage(&root_page_id);
+      auto root = root_guard.AsMut<InternalPage>();
+      root->Init(root_page_id, INVALID_PAGE_ID, internal_max_size_);
+      root->PopulateNewRoot(old_page_id, key, new_page_id);
+      header_guard.AsMut<BPlusTreeRootPage>()->root_page_id_ = root_page_id;
+      return;
+    }
+    // The old page was at the top of the tree when we passed it, and the tree has grown since or is about to. Find
+    // the pages above it again; if the insert that split the old root has not put up the new root yet, wait for it.
+    header_guard.Drop();
+    FindLeafOptimistic(key, ctx, false);
+    if (ctx->path_.size() > static_cast<size_t>(height)) {
+      ctx->path_.resize(ctx->path_.size() - height);
+      break;
+    }
+    ctx->path_.clear();
+    std::this_thread::yield();
+  }
+
+  WritePageGuard parent_guard = bpm_->FetchPageWrite(ctx->path_.back());
+  ctx->path_.pop_back();
+  MoveRight(&parent_guard, key);
+  page_id_t parent_page_id = parent_guard.PageId();
+  auto parent = parent_guard.AsMut<InternalPage>();
+  parent->InsertNode(key, new_page_id, comparator_);
+  if (parent->GetSize() <= parent->GetMaxSize()) {
+    return;
+  }
+
+  page_id_t sibling_page_id;
+  BasicPageGuard sibling_guard = NewTreePage(&sibling_page_id);
+  auto sibling = sibling_guard.AsMut<InternalPage>();
+  sibling->Init(sibling_page_id, INVALID_PAGE_ID, internal_max_size_);
+  parent->MoveHalfTo(sibling, sibling_page_id);
+  splits_++;
+  KeyType separator = sibling->KeyAt(0);
+  sibling_guard.Drop();
+
+  ctx->write_set_.push_back(std::move(parent_guard));
+  InsertIntoParent(ctx, parent_page_id, height + 1, separator, sibling_page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertIntoPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool {
+  ValueType existing = leaf->ValueAt(index);
+  if (!BPlusTreePostingPage::IsPostingList(existing)) {
+    if (existing == value) {
+      return false;
+    }
+    page_id_t head_page_id;
+    BasicPageGuard head_guard = NewTreePage(&head_page_id);
+    auto head = head_guard.AsMut<BPlusTreePostingPage>();
+    head->Init();
+    head->Insert(existing);
+    head->Insert(value);
+    leaf->SetValueAt(index, BPlusTreePostingPage::PostingListRid(head_page_id));
+    return true;
+  }
+
+  // the value goes to the first page whose last value is not smaller, or to the last page
+  WritePageGuard guard = bpm_->FetchPageWrite(existing.GetPageId());
+  while (guard.As<BPlusTreePostingPage>()->GetNextPageId() != INVALID_PAGE_ID &&
+         guard.As<BPlusTreePostingPage>()->LastRid().Get() < value.Get()) {
+    guard = bpm_->FetchPageWrite(guard.As<BPlusTreePostingPage>()->GetNextPageId());
+  }
+  auto page = guard.AsMut<BPlusTreePostingPage>();
+  if (!page->IsFull()) {
+    return page->Insert(value);
+  }
+  int slot = page->RidIndex(value);
+  if (slot < page->GetSize() && page->RidAt(slot) == value) {
+    return false;
+  }
+  page_id_t new_page_id;
+  BasicPageGuard new_guard = NewTreePage(&new_page_id);
+  auto new_page = new_guard.AsMut<BPlusTreePostingPage>();
+  new_page->Init();
+  page->MoveHalfTo(new_page, new_page_id);
+  return value.Get() > page->LastRid().Get() ? new_page->Insert(value) : page->Insert(value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveFromPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool {
+  page_id_t head_page_id = leaf->ValueAt(index).GetPageId();
+  WritePageGuard prev_guard;
+  WritePageGuard guard = bpm_->FetchPageWrite(head_page_id);
+  while (guard.As<BPlusTreePostingPage>()->GetNextPageId() != INVALID_PAGE_ID &&
+         guard.As<BPlusTreePostingPage>()->LastRid().Get() < value.Get()) {
+    page_id_t next_page_id = guard.As<BPlusTreePostingPage>()->GetNextPageId();
+    prev_guard = std::move(guard);
+    guard = bpm_->FetchPageWrite(next_page_id);
+  }
+  auto page = guard.AsMut<BPlusTreePostingPage>();
+  if (!page->Remove(value)) {
+    return false;
+  }
+  if (page->GetSize() == 0) {
+    page_id_t empty_page_id = guard.PageId();
+    if (empty_page_id == head_page_id) {
+      head_page_id = page->GetNextPageId();
+      leaf->SetValueAt(index, BPlusTreePostingPage::PostingListRid(head_page_id));
+    } else {
+      prev_guard.AsMut<BPlusTreePostingPage>()->SetNextPageId(page->GetNextPageId());
+    }
+    guard.Drop();
+    FreePage(empty_page_id);
+  }
+  guard.Drop();
+  prev_guard.Drop();
+
+  // a list always holds at least two values, otherwise the value goes back into the leaf
+  ReadPageGuard head_guard = bpm_->FetchPageRead(head_page_id);
+  auto head = head_guard.As<BPlusTreePostingPage>();
+  if (head->GetNextPageId() == INVALID_PAGE_ID && head->GetSize() == 1) {
+    leaf->SetValueAt(index, head->RidAt(0));
+    head_guard.Drop();
+    FreePage(head_page_id);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectPostingList(page_id_t head_page_id, std::vector<ValueType> *result) {
+  for (page_id_t page_id = head_page_id; page_id != INVALID_PAGE_ID;) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<BPlusTreePostingPage>();
+    page->CollectRids(result);
+    page_id = page->GetNextPageId();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FreePage(page_id_t page_id) {
+  std::scoped_lock latch(pending_deletes_latch_);
+  pending_deletes_.erase(std::remove_if(pending_deletes_.begin(), pending_deletes_.end(),
+                                        [this](page_id_t pending) { return bpm_->DeletePage(pending); }),
+                         pending_deletes_.end());
+  if (!bpm_->DeletePage(page_id)) {
+    pending_deletes_.push_back(page_id);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePostingList(page_id_t head_page_id) {
+  for (page_id_t page_id = head_page_id; page_id != INVALID_PAGE_ID;) {
+    page_id_t next_page_id = bpm_->FetchPageRead(page_id).template As<BPlusTreePostingPage>()->GetNextPageId();
+    FreePage(page_id);
+    page_id = next_page_id;
+  }
 }
 
 /*****************************************************************************
@@ -66,12 +452,240 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * If not, User needs to first find the right leaf page as deletion target, then
  * delete entry from leaf page. Remember to deal with redistribute or merge if
  * necessary.
+ * Like inserts, removes first write latch only the leaf. A remove that may
+ * underflow the leaf waits for in-flight splits to finish and restarts with
+ * write latch crabbing from the header page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) -> bool { return RemoveEntry(key, nullptr); }
+
+/*
+ * Delete one key & value pair. In a non-unique tree, a key with a posting list
+ * only loses that value, which leaves the leaf size unchanged.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
+auto BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
+  return RemoveEntry(key, &value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value) -> bool {
+  // Finds the entry in a write latched leaf and removes value from its posting list if it has one. Returns the
+  // entry's index if the whole entry is to go, or -1 if there is nothing more to do. Sets `removed` if either of
+  // them takes something out of the tree.
+  bool removed = false;
+  auto find_entry = [&](LeafPage *leaf) -> int {
+    int index = leaf->KeyIndex(key, comparator_);
+    if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+      return -1;
+    }
+    ValueType existing = leaf->ValueAt(index);
+    bool posting_list = AllowsDuplicates(key) && BPlusTreePostingPage::IsPostingList(existing);
+    if (value == nullptr) {
+      if (posting_list) {
+        DeletePostingList(existing.GetPageId());
+      }
+      removed = true;
+      return index;
+    }
+    if (posting_list) {
+      removed = RemoveFromPostingList(leaf, index, *value);
+      return -1;
+    }
+    removed = existing == *value;
+    return removed ? index : -1;
+  };
+
+  bool lazy_merge = lazy_merge_;
+  {
+    Context optimistic_ctx;
+    if (!FindLeafOptimistic(key, &optimistic_ctx)) {
+      return removed;
+    }
+    auto &leaf_guard = optimistic_ctx.write_set_.back();
+    auto leaf = leaf_guard.AsMut<LeafPage>();
+    if (IsSafeToRemove(leaf, optimistic_ctx.IsRootPage(leaf_guard.PageId()), lazy_merge)) {
+      if (find_entry(leaf) >= 0) {
+        leaf->Remove(key, comparator_);
+      }
+      return removed;
+    }
+    ValueType existing;
+    if (!leaf->Lookup(key, &existing, comparator_)) {
+      return removed;
+    }
+    if (value != nullptr && AllowsDuplicates(key) && BPlusTreePostingPage::IsPostingList(existing)) {
+      // taking a value out of a posting list never shrinks the leaf
+      find_entry(leaf);
+      return removed;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> structure_lock(structure_latch_);
   Context ctx;
-  (void)ctx;
+  ctx.lazy_merge_ = lazy_merge;
+  if (!FindLeafPessimistic(key, &ctx)) {
+    return removed;
+  }
+
+  auto &leaf_guard = ctx.write_set_.back();
+  page_id_t leaf_page_id = leaf_guard.PageId();
+  auto leaf = leaf_guard.AsMut<LeafPage>();
+  if (find_entry(leaf) < 0) {
+    return removed;
+  }
+  leaf->Remove(key, comparator_);
+
+  if (ctx.IsRootPage(leaf_page_id)) {
+    if (leaf->GetSize() == 0) {
+      ctx.header_page_->template AsMut<BPlusTreeRootPage>()->root_page_id_ = INVALID_PAGE_ID;
+      ctx.write_set_.clear();
+      FreePage(leaf_page_id);
+    }
+    return removed;
+  }
+  if (leaf->GetSize() < UnderflowSize(leaf, ctx.lazy_merge_)) {
+    HandleUnderflow(&ctx);
+  }
+  return removed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::HandleUnderflow(Context *ctx) {
+  auto &parent_guard = ctx->write_set_[ctx->write_set_.size() - 2];
+  page_id_t node_page_id = ctx->write_set_.back().PageId();
+  page_id_t parent_page_id = parent_guard.PageId();
+  auto parent = parent_guard.AsMut<InternalPage>();
+
+  // prefer the left sibling; the leftmost child borrows from or merges with its right sibling
+  int index = parent->ValueIndex(node_page_id);
+  int sibling_index = index == 0 ? 1 : index - 1;
+  bool sibling_is_left = sibling_index < index;
+  // separator between the two siblings in the parent
+  int separator_index = sibling_is_left ? index : sibling_index;
+  WritePageGuard sibling_guard;
+  if (sibling_is_left) {
+    // Siblings are latched left to right everywhere else, so let go of this page and take both in that order. The
+    // parent stays latched, and only removes that cannot underflow a page run meanwhile.
+    ctx->write_set_.pop_back();
+    sibling_guard = bpm_->FetchPageWrite(parent->ValueAt(sibling_index));
+    ctx->write_set_.push_back(bpm_->FetchPageWrite(node_page_id));
+  } else {
+    sibling_guard = bpm_->FetchPageWrite(parent->ValueAt(sibling_index));
+  }
+
+  auto node = ctx->write_set_.back().AsMut<BPlusTreePage>();
+  auto sibling = sibling_guard.AsMut<BPlusTreePage>();
+
+  bool merge = node->IsLeafPage() ? node->GetSize() + sibling->GetSize() < node->GetMaxSize()
+                                  : node->GetSize() + sibling->GetSize() <= node->GetMaxSize();
+  if (!merge) {
+    // the left page of the pair takes the new separator as its high key
+    if (node->IsLeafPage()) {
+      auto leaf = reinterpret_cast<LeafPage *>(node);
+      auto sibling_leaf = reinterpret_cast<LeafPage *>(sibling);
+      if (sibling_is_left) {
+        sibling_leaf->MoveLastToFrontOf(leaf);
+        parent->SetKeyAt(separator_index, leaf->KeyAt(0));
+        sibling_leaf->SetHighKey(leaf->KeyAt(0));
+      } else {
+        sibling_leaf->MoveFirstToEndOf(leaf);
+        parent->SetKeyAt(separator_index, sibling_leaf->KeyAt(0));
+        leaf->SetHighKey(sibling_leaf->KeyAt(0));
+      }
+    } else {
+      auto internal = reinterpret_cast<InternalPage *>(node);
+      auto sibling_internal = reinterpret_cast<InternalPage *>(sibling);
+      if (sibling_is_left) {
+        sibling_internal->MoveLastToFrontOf(internal, parent->KeyAt(separator_index));
+        parent->SetKeyAt(separator_index, internal->KeyAt(0));
+        sibling_internal->SetHighKey(internal->KeyAt(0));
+      } else {
+        sibling_internal->MoveFirstToEndOf(internal, parent->KeyAt(separator_index));
+        parent->SetKeyAt(separator_index, sibling_internal->KeyAt(0));
+        internal->SetHighKey(sibling_internal->KeyAt(0));
+      }
+    }
+    redistributions_++;
+    return;
+  }
+
+  // merge the right page of the pair into the left one and drop it from the parent
+  BPlusTreePage *left = sibling_is_left ? sibling : node;
+  BPlusTreePage *right = sibling_is_left ? node : sibling;
+  page_id_t right_page_id = sibling_is_left ? node_page_id : sibling_guard.PageId();
+  if (node->IsLeafPage()) {
+    reinterpret_cast<LeafPage *>(right)->MoveAllTo(reinterpret_cast<LeafPage *>(left));
+    // before the right page goes away, so a reverse iterator holding the next leaf never sees a freed back link
+    FixPrevLink(reinterpret_cast<LeafPage *>(left), sibling_is_left ? sibling_guard.PageId() : node_page_id);
+  } else {
+    reinterpret_cast<InternalPage *>(right)->MoveAllTo(reinterpret_cast<InternalPage *>(left),
+                                                       parent->KeyAt(separator_index));
+  }
+  parent->Remove(separator_index);
+  merges_++;
+  sibling_guard.Drop();
+  ctx->write_set_.pop_back();
+  FreePage(right_page_id);
+
+  if (ctx->IsRootPage(parent_page_id)) {
+    if (parent->GetSize() == 1) {
+      // the root has a single child left; that child becomes the new root
+      ctx->header_page_->template AsMut<BPlusTreeRootPage>()->root_page_id_ = parent->ValueAt(0);
+      ctx->write_set_.pop_back();
+      FreePage(parent_page_id);
+    }
+    return;
+  }
+  if (parent->GetSize() < UnderflowSize(parent, ctx->lazy_merge_)) {
+    HandleUnderflow(ctx);
+  }
+}
+
+/*
+ * Compaction finds the underfull leaves with read latches first, then fixes
+ * each one like an eager remove that just made it underflow.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Compact() -> int {
+  std::vector<KeyType> underfull;
+  auto guard = FindLeafRead(nullptr);
+  while (guard.has_value()) {
+    auto leaf = guard->template As<LeafPage>();
+    if (leaf->GetSize() > 0 && leaf->GetSize() < leaf->GetMinSize()) {
+      underfull.push_back(leaf->KeyAt(0));
+    }
+    if (leaf->GetNextPageId() == INVALID_PAGE_ID) {
+      break;
+    }
+    guard = bpm_->FetchPageRead(leaf->GetNextPageId());
+  }
+  guard = std::nullopt;
+
+  int fixed = 0;
+  for (const auto &key : underfull) {
+    // a redistribution moves a single entry, so a leaf far below its minimum size takes a few rounds
+    for (bool first = true;; first = false) {
+      std::unique_lock<std::shared_mutex> structure_lock(structure_latch_);
+      Context ctx;
+      if (!FindLeafPessimistic(key, &ctx)) {
+        return fixed;
+      }
+      auto &leaf_guard = ctx.write_set_.back();
+      auto leaf = leaf_guard.As<LeafPage>();
+      if (ctx.IsRootPage(leaf_guard.PageId()) || leaf->GetSize() == 0 || leaf->GetSize() >= leaf->GetMinSize()) {
+        break;
+      }
+      HandleUnderflow(&ctx);
+      fixed += first ? 1 : 0;
+    }
+  }
+  return fixed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetStats() const -> BPlusTreeStats {
+  return {splits_.load(), merges_.load(), redistributions_.load()};
 }
 
 /*****************************************************************************
@@ -83,7 +697,13 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  auto guard = FindLeafRead(nullptr);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  return INDEXITERATOR_TYPE(this, std::move(*guard), 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -91,7 +711,215 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  auto guard = FindLeafRead(&key);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = guard->template As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(this, std::move(*guard), index);
+}
+
+/*
+ * Like Begin(key), but the iterator reaches the end after the last key that
+ * is not greater than stop_key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE {
+  auto guard = FindLeafRead(&key);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = guard->template As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(this, std::move(*guard), index, false, stop_key);
+}
+
+/*
+ * Reverse iterators walk the prev links of the leaves from the largest key
+ * down.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin() -> INDEXITERATOR_TYPE {
+  auto guard = FindLastLeaf();
+  if (!guard.has_value() || guard->template As<LeafPage>()->GetSize() == 0) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = guard->template As<LeafPage>()->GetSize() - 1;
+  return INDEXITERATOR_TYPE(this, std::move(*guard), index, true);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key) -> INDEXITERATOR_TYPE { return ReverseBegin(key, std::nullopt); }
+
+/*
+ * Like RBegin(key), but the iterator reaches the end after the last key that
+ * is not less than stop_key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE {
+  return ReverseBegin(key, stop_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ReverseBegin(const KeyType &key, std::optional<KeyType> stop_key) -> INDEXITERATOR_TYPE {
+  auto guard = FindLeafRead(&key);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  auto leaf = guard->template As<LeafPage>();
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) > 0) {
+    index--;
+  }
+  if (index < 0) {
+    // every key in this leaf is greater than key; the start is further left
+    guard->Drop();
+    guard = FindLeafBefore(key, &index);
+    if (!guard.has_value()) {
+      return INDEXITERATOR_TYPE();
+    }
+  }
+  return INDEXITERATOR_TYPE(this, std::move(*guard), index, true, std::move(stop_key));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLastLeaf() -> std::optional<ReadPageGuard> {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeRootPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  guard = bpm_->FetchPageRead(page_id);
+  while (true) {
+    // a split may not have reached the parent yet, so the last child is not necessarily the rightmost page
+    KeyType high_key;
+    while ((page_id = RightLink(guard.As<BPlusTreePage>(), &high_key)) != INVALID_PAGE_ID) {
+      guard = bpm_->FetchPageRead(page_id);
+    }
+    auto page = guard.As<BPlusTreePage>();
+    if (page->IsLeafPage()) {
+      return guard;
+    }
+    auto internal = reinterpret_cast<const InternalPage *>(page);
+    guard = bpm_->FetchPageRead(internal->ValueAt(internal->GetSize() - 1));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectLeavesAhead(const KeyType &key, page_id_t leaf_page_id, bool reverse, int count,
+                                        std::vector<page_id_t> *leaves) {
+  // Waiting for a latch above a latched leaf could deadlock with a remove crabbing down to it.
+  auto try_fetch = [this](page_id_t page_id) -> std::optional<ReadPageGuard> {
+    Page *page = bpm_->FetchPage(page_id);
+    if (page == nullptr) {
+      return std::nullopt;
+    }
+    if (!page->TryRLatch()) {
+      bpm_->UnpinPage(page_id, false);
+      return std::nullopt;
+    }
+    return ReadPageGuard(bpm_, page);
+  };
+
+  auto guard = try_fetch(header_page_id_);
+  if (!guard.has_value()) {
+    return;
+  }
+  page_id_t page_id = guard->template As<BPlusTreeRootPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  guard = try_fetch(page_id);
+  int index;
+  while (true) {
+    if (!guard.has_value() || guard->template As<BPlusTreePage>()->IsLeafPage()) {
+      // the leaf is the root, or the tree changed under us
+      return;
+    }
+    KeyType high_key;
+    page_id_t next_page_id = RightLink(guard->template As<BPlusTreePage>(), &high_key);
+    if (next_page_id != INVALID_PAGE_ID && comparator_(key, high_key) >= 0) {
+      guard = try_fetch(next_page_id);
+      continue;
+    }
+    auto internal = guard->template As<InternalPage>();
+    index = internal->LookupIndex(key, comparator_);
+    if (internal->ValueAt(index) == leaf_page_id) {
+      break;
+    }
+    guard = try_fetch(internal->ValueAt(index));
+  }
+
+  if (reverse) {
+    auto parent = guard->template As<InternalPage>();
+    for (int i = index - 1; i >= 0 && static_cast<int>(leaves->size()) < count; i--) {
+      leaves->push_back(parent->ValueAt(i));
+    }
+    return;
+  }
+  while (true) {
+    auto parent = guard->template As<InternalPage>();
+    for (int i = index + 1; i < parent->GetSize() && static_cast<int>(leaves->size()) < count; i++) {
+      leaves->push_back(parent->ValueAt(i));
+    }
+    if (static_cast<int>(leaves->size()) >= count || parent->GetNextPageId() == INVALID_PAGE_ID) {
+      return;
+    }
+    guard = try_fetch(parent->GetNextPageId());
+    if (!guard.has_value()) {
+      return;
+    }
+    index = -1;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafBefore(const KeyType &key, int *index) -> std::optional<ReadPageGuard> {
+  KeyType bound = key;
+  while (true) {
+    ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+    page_id_t page_id = guard.As<BPlusTreeRootPage>()->root_page_id_;
+    if (page_id == INVALID_PAGE_ID) {
+      return std::nullopt;
+    }
+    guard = bpm_->FetchPageRead(page_id);
+    // smallest key the current page may hold; none for the leftmost page of a level
+    std::optional<KeyType> low_key;
+    while (true) {
+      // unlike MoveRight, stay on a page whose high key equals bound: every key to its right is >= bound
+      KeyType high_key;
+      while ((page_id = RightLink(guard.As<BPlusTreePage>(), &high_key)) != INVALID_PAGE_ID &&
+             comparator_(high_key, bound) < 0) {
+        low_key = high_key;
+        guard = bpm_->FetchPageRead(page_id);
+      }
+      auto page = guard.As<BPlusTreePage>();
+      if (page->IsLeafPage()) {
+        break;
+      }
+      // the last child whose separator is < bound
+      auto internal = reinterpret_cast<const InternalPage *>(page);
+      int child = internal->LookupIndex(bound, comparator_);
+      if (child > 0 && comparator_(internal->KeyAt(child), bound) == 0) {
+        child--;
+      }
+      if (child > 0) {
+        low_key = internal->KeyAt(child);
+      }
+      guard = bpm_->FetchPageRead(internal->ValueAt(child));
+    }
+    *index = guard.As<LeafPage>()->KeyIndex(bound, comparator_) - 1;
+    if (*index >= 0) {
+      return guard;
+    }
+    if (!low_key.has_value()) {
+      return std::nullopt;
+    }
+    // the leaf holds nothing below bound (it may have been emptied by merges while we were away); retry from the
+    // smallest key it could hold, whose predecessor is the answer as well
+    bound = *low_key;
+  }
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -105,7 +933,27 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE();
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeRootPage>()->root_page_id_;
+}
+
+/**
+ * @return Number of levels in this tree, counting the leaves; 0 if it is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetHeight() -> int {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeRootPage>()->root_page_id_;
+  int height = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    guard = bpm_->FetchPageRead(page_id);
+    height++;
+    auto page = guard.As<BPlusTreePage>();
+    page_id = page->IsLeafPage() ? INVALID_PAGE_ID : reinterpret_cast<const InternalPage *>(page)->ValueAt(0);
+  }
+  return height;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
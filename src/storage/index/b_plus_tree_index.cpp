@@ -11,6 +11,8 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+
 namespace bustub {
 /*
  * Constructor
@@ -19,18 +21,46 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
   page_id_t header_page_id;
-  buffer_pool_manager->NewPage(&header_page_id);
-  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
-                                                                              buffer_pool_manager, comparator_);
+  buffer_pool_manager->NewPageGuarded(&header_page_id);
+  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(
+      GetMetadata()->GetName(), header_page_id, buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+      GetMetadata()->IsUnique());
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
   // construct insert index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_->Insert(index_key, rid, transaction);
+  if (!container_->Insert(index_key, rid, transaction)) {
+    return false;
+  }
+  FilterInsert(key);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids,
+                                         Transaction *transaction) -> bool {
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+    order[i] = i;
+  }
+  // a stable sort keeps the RIDs of equal keys in table order
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t a, size_t b) { return comparator_(index_keys[a], index_keys[b]) < 0; });
+  bool inserted = true;
+  for (auto i : order) {
+    if (container_->Insert(index_keys[i], rids[i], transaction)) {
+      FilterInsert(keys[i]);
+    } else {
+      inserted = false;
+    }
+  }
+  return inserted;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -39,16 +69,30 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_->Remove(index_key, transaction);
+  // only this tuple's entry goes; other tuples may share the key
+  if (container_->Remove(index_key, rid, transaction)) {
+    FilterRemove(key);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  if (!FilterMayContain(key)) {
+    return;
+  }
   // construct scan index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_->GetValue(index_key, result, transaction);
+  if (!container_->GetValue(index_key, result, transaction)) {
+    FilterMissed();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::LookupPageCount() -> size_t {
+  // the header page and one page per level
+  return container_->GetHeight() + 1;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -57,6 +101,24 @@ auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return con
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE { return container_->Begin(key); }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE {
+  return container_->Begin(key, stop_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() -> INDEXITERATOR_TYPE { return container_->RBegin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE {
+  return container_->RBegin(key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &key, const KeyType &stop_key) -> INDEXITERATOR_TYPE {
+  return container_->RBegin(key, stop_key);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return container_->End(); }
 
@@ -12,15 +12,19 @@ HASH_TABLE_INDEX_TYPE::ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &
                                                 const HashFunction<KeyType> &hash_fn)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn) {}
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn, GetMetadata()->IsUnique()) {}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+auto HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
   // construct insert index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Insert(transaction, index_key, rid);
+  if (!container_.Insert(transaction, index_key, rid)) {
+    return false;
+  }
+  FilterInsert(key);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -29,17 +33,31 @@ void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Remove(transaction, index_key, rid);
+  if (container_.Remove(transaction, index_key, rid)) {
+    FilterRemove(key);
+  }
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  if (!FilterMayContain(key)) {
+    return;
+  }
   // construct scan index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.GetValue(transaction, index_key, result);
+  if (!container_.GetValue(transaction, index_key, result)) {
+    FilterMissed();
+  }
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_INDEX_TYPE::LookupPageCount() -> size_t {
+  // the header, directory and bucket pages
+  return 3;
+}
+
 template class ExtendibleHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class ExtendibleHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
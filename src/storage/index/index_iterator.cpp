@@ -1,8 +1,10 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
 
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
@@ -15,16 +17,226 @@ INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, ReadPageGuard guard, int index,
+                                  bool reverse, std::optional<KeyType> stop_key)
+    : tree_(tree),
+      bpm_(tree->bpm_),
+      guard_(std::move(guard)),
+      page_id_(guard_.PageId()),
+      index_(index),
+      reverse_(reverse),
+      stop_key_(std::move(stop_key)) {
+  if (reverse_) {
+    BUSTUB_ASSERT(index_ >= 0 && index_ < guard_.template As<LeafPage>()->GetSize(), "reverse start out of range");
+    SkipExhaustedLeavesBackward(guard_.template As<LeafPage>()->KeyAt(index_));
+  } else {
+    SkipExhaustedLeaves();
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE::~IndexIterator() { ReleasePrefetched(); }  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&that) noexcept -> IndexIterator & {
+  if (this != &that) {
+    ReleasePrefetched();
+    tree_ = that.tree_;
+    bpm_ = that.bpm_;
+    guard_ = std::move(that.guard_);
+    page_id_ = that.page_id_;
+    index_ = that.index_;
+    reverse_ = that.reverse_;
+    stop_key_ = std::move(that.stop_key_);
+    item_ = that.item_;
+    posting_list_ = std::move(that.posting_list_);
+    posting_index_ = that.posting_index_;
+    prefetched_for_ = that.prefetched_for_;
+    prefetched_ = std::move(that.prefetched_);
+    that.prefetched_.clear();
+  }
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  BUSTUB_ASSERT(!IsEnd(), "dereferencing the end iterator");
+  item_ = guard_.template As<LeafPage>()->GetItem(index_);
+  if (!posting_list_.empty()) {
+    item_.second = posting_list_[posting_index_];
+  }
+  return item_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  BUSTUB_ASSERT(!IsEnd(), "incrementing the end iterator");
+  if (!posting_list_.empty() &&
+      (reverse_ ? posting_index_ > 0 : posting_index_ + 1 < static_cast<int>(posting_list_.size()))) {
+    posting_index_ += reverse_ ? -1 : 1;
+    return *this;
+  }
+  if (reverse_) {
+    KeyType bound = guard_.template As<LeafPage>()->KeyAt(index_);
+    index_--;
+    SkipExhaustedLeavesBackward(bound);
+  } else {
+    index_++;
+    SkipExhaustedLeaves();
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (page_id_ != INVALID_PAGE_ID) {
+    auto leaf = guard_.template As<LeafPage>();
+    if (index_ < leaf->GetSize()) {
+      if (stop_key_.has_value() && tree_->comparator_(leaf->KeyAt(index_), *stop_key_) > 0) {
+        SetEnd();
+      }
+      PrefetchAhead();
+      break;
+    }
+    index_ = 0;
+    page_id_ = leaf->GetNextPageId();
+    if (page_id_ == INVALID_PAGE_ID) {
+      guard_.Drop();
+    } else {
+      // Leaf latches are always taken left to right, so the next leaf is latched before this one is released. A
+      // concurrent split only adds pages to the right of this one, and a merge cannot free the next leaf meanwhile.
+      guard_ = bpm_->FetchPageRead(page_id_);
+    }
+  }
+  LoadPostingList();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeavesBackward(KeyType bound) {
+  while (index_ < 0) {
+    page_id_t prev_page_id = guard_.template As<LeafPage>()->GetPrevPageId();
+    if (prev_page_id == INVALID_PAGE_ID) {
+      SetEnd();
+      return;
+    }
+    // Waiting for the left neighbour while holding this leaf would go against the left to right latch order and
+    // could deadlock, so only take its latch if it is free. While this leaf is latched, the neighbour cannot be
+    // split or merged away, since either would have to update our back link.
+    Page *prev_page = bpm_->FetchPage(prev_page_id);
+    if (prev_page != nullptr && prev_page->TryRLatch()) {
+      guard_ = ReadPageGuard(bpm_, prev_page);
+      page_id_ = prev_page_id;
+      index_ = guard_.template As<LeafPage>()->GetSize() - 1;
+      continue;
+    }
+    if (prev_page != nullptr) {
+      bpm_->UnpinPage(prev_page_id, false);
+    }
+    // Otherwise let go of this leaf and look up the entry before bound from the root.
+    guard_.Drop();
+    auto guard = tree_->FindLeafBefore(bound, &index_);
+    if (!guard.has_value()) {
+      SetEnd();
+      return;
+    }
+    guard_ = std::move(*guard);
+    page_id_ = guard_.PageId();
+  }
+  if (stop_key_.has_value() && tree_->comparator_(guard_.template As<LeafPage>()->KeyAt(index_), *stop_key_) < 0) {
+    SetEnd();
+  }
+  PrefetchAhead();
+  LoadPostingList();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadPostingList() {
+  posting_list_.clear();
+  posting_index_ = 0;
+  if (IsEnd() || !tree_->AllowsDuplicates(guard_.template As<LeafPage>()->KeyAt(index_))) {
+    return;
+  }
+  ValueType value = guard_.template As<LeafPage>()->ValueAt(index_);
+  if (!BPlusTreePostingPage::IsPostingList(value)) {
+    return;
+  }
+  // the leaf latch keeps writers off the posting pages
+  tree_->CollectPostingList(value.GetPageId(), &posting_list_);
+  if (reverse_) {
+    posting_index_ = static_cast<int>(posting_list_.size()) - 1;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::PrefetchAhead() {
+  int depth = tree_->iterator_prefetch_depth_;
+  if (depth <= 0 || page_id_ == INVALID_PAGE_ID || page_id_ == prefetched_for_) {
+    return;
+  }
+  prefetched_for_ = page_id_;
+
+  // let go of the leaves up to this one; if this leaf was not among them, the iteration took another way
+  auto reached = std::find(prefetched_.begin(), prefetched_.end(), page_id_);
+  if (reached == prefetched_.end()) {
+    ReleasePrefetched();
+  } else {
+    for (auto it = prefetched_.begin(); it != reached + 1; ++it) {
+      bpm_->UnpinPrefetchedPage(*it);
+    }
+    prefetched_.erase(prefetched_.begin(), reached + 1);
+  }
+  if (static_cast<int>(prefetched_.size()) > depth / 2) {
+    return;
+  }
+
+  // nothing past this leaf is needed if the stop key is in it
+  auto leaf = guard_.template As<LeafPage>();
+  const KeyType &last = leaf->KeyAt(reverse_ ? 0 : leaf->GetSize() - 1);
+  if (stop_key_.has_value() &&
+      (reverse_ ? tree_->comparator_(last, *stop_key_) <= 0 : tree_->comparator_(last, *stop_key_) >= 0)) {
+    return;
+  }
+
+  std::vector<page_id_t> ahead;
+  tree_->CollectLeavesAhead(leaf->KeyAt(0), page_id_, reverse_, depth, &ahead);
+  if (ahead.empty()) {
+    return;
+  }
+  // keep the pins already held on leaves that are still ahead, and take new ones for the rest
+  std::vector<page_id_t> pinned;
+  for (page_id_t leaf_page_id : ahead) {
+    auto held = std::find(prefetched_.begin(), prefetched_.end(), leaf_page_id);
+    if (held != prefetched_.end()) {
+      prefetched_.erase(held);
+      pinned.push_back(leaf_page_id);
+    } else if (bpm_->PrefetchPage(leaf_page_id)) {
+      pinned.push_back(leaf_page_id);
+    }
+  }
+  ReleasePrefetched();
+  prefetched_ = std::move(pinned);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::ReleasePrefetched() {
+  for (page_id_t leaf_page_id : prefetched_) {
+    bpm_->UnpinPrefetchedPage(leaf_page_id);
+  }
+  prefetched_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SetEnd() {
+  guard_.Drop();
+  ReleasePrefetched();
+  page_id_ = INVALID_PAGE_ID;
+  index_ = 0;
+  posting_list_.clear();
+  posting_index_ = 0;
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_filter.cpp
+//
+// Identification: src/storage/index/key_filter.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/key_filter.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace bustub {
+
+KeyFilter::KeyFilter(size_t expected_keys) {
+  size_t min_blocks = (std::max<size_t>(expected_keys, 1) * COUNTERS_PER_KEY + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  num_blocks_ = 1;
+  while (num_blocks_ < min_blocks) {
+    num_blocks_ *= 2;
+  }
+  counters_ = std::make_unique<std::atomic<uint8_t>[]>(num_blocks_ * BLOCK_SIZE);
+  for (size_t i = 0; i < num_blocks_ * BLOCK_SIZE; i++) {
+    counters_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+auto KeyFilter::Locate(uint64_t hash, uint32_t offsets[NUM_PROBES]) const -> std::atomic<uint8_t> * {
+  // the hashes of index keys are weak, so mix all of their bits first (MurmurHash3's finalizer)
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  // the high bits pick the block and the low bits the counters in it
+  for (uint32_t i = 0; i < NUM_PROBES; i++) {
+    offsets[i] = (hash >> (6 * i)) % BLOCK_SIZE;
+  }
+  return &counters_[((hash >> 32) & (num_blocks_ - 1)) * BLOCK_SIZE];
+}
+
+void KeyFilter::Insert(uint64_t hash) {
+  uint32_t offsets[NUM_PROBES];
+  auto *block = Locate(hash, offsets);
+  for (auto offset : offsets) {
+    auto count = block[offset].load(std::memory_order_relaxed);
+    while (count != std::numeric_limits<uint8_t>::max() &&
+           !block[offset].compare_exchange_weak(count, count + 1, std::memory_order_relaxed)) {
+    }
+  }
+}
+
+void KeyFilter::Remove(uint64_t hash) {
+  uint32_t offsets[NUM_PROBES];
+  auto *block = Locate(hash, offsets);
+  for (auto offset : offsets) {
+    auto count = block[offset].load(std::memory_order_relaxed);
+    // a saturated counter has lost count of its keys, so it can never go down again
+    while (count != 0 && count != std::numeric_limits<uint8_t>::max() &&
+           !block[offset].compare_exchange_weak(count, count - 1, std::memory_order_relaxed)) {
+    }
+  }
+}
+
+auto KeyFilter::MayContain(uint64_t hash) -> bool {
+  lookups_.fetch_add(1, std::memory_order_relaxed);
+  uint32_t offsets[NUM_PROBES];
+  auto *block = Locate(hash, offsets);
+  for (auto offset : offsets) {
+    if (block[offset].load(std::memory_order_relaxed) == 0) {
+      skipped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  return true;
+}
+
+auto KeyFilter::GetStats() const -> KeyFilterStats {
+  KeyFilterStats stats;
+  stats.lookups_ = lookups_.load(std::memory_order_relaxed);
+  stats.skipped_ = skipped_.load(std::memory_order_relaxed);
+  stats.false_positives_ = false_positives_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace bustub
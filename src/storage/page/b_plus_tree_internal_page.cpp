@@ -9,10 +9,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "storage/index/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -25,27 +27,194 @@ namespace bustub {
  * max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  static_assert(sizeof(B_PLUS_TREE_INTERNAL_PAGE_TYPE) <= BUSTUB_PAGE_SIZE, "internal page does not fit in a page");
+  BUSTUB_ASSERT(max_size > 2 && static_cast<size_t>(max_size) <= INTERNAL_PAGE_SIZE, "invalid internal max size");
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
+  SetLSN();
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+/*
+ * Helper methods to get/set the right link and high key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> KeyType { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsPastHighKey(const KeyType &key, const KeyComparator &comparator) const
+    -> bool {
+  return next_page_id_ != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
+}
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key{};
-  return key;
-}
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return key_array_[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { key_array_[index] = key; }
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return 0; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return page_id_array_[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { page_id_array_[index] = value; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  auto it = std::find(page_id_array_, page_id_array_ + GetSize(), value);
+  return it == page_id_array_ + GetSize() ? -1 : static_cast<int>(it - page_id_array_);
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * Find the child whose range covers key: the last index i such that
+ * KeyAt(i) <= key, where the invalid key 0 counts as negative infinity.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::LookupIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int index = BPlusTreeKeySearch<KeyType, KeyComparator>::LowerBound(key_array_, 1, GetSize(), key, comparator);
+  if (index < GetSize() && comparator(key_array_[index], key) == 0) {
+    return index;
+  }
+  return index - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  return page_id_array_[LookupIndex(key, comparator)];
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  page_id_array_[0] = old_value;
+  key_array_[1] = new_key;
+  page_id_array_[1] = new_value;
+  SetSize(2);
+}
+
+/*
+ * Separators are placed by key rather than next to the page that split: with
+ * B-link splits, a page can split again before its first separator reaches
+ * this page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNode(const KeyType &new_key, const ValueType &new_value,
+                                                const KeyComparator &comparator) {
+  BUSTUB_ASSERT(static_cast<size_t>(GetSize()) < INTERNAL_PAGE_SLOT_CNT, "internal page overflow");
+  int index = LookupIndex(new_key, comparator) + 1;
+  std::copy_backward(key_array_ + index, key_array_ + GetSize(), key_array_ + GetSize() + 1);
+  std::copy_backward(page_id_array_ + index, page_id_array_ + GetSize(), page_id_array_ + GetSize() + 1);
+  key_array_[index] = new_key;
+  page_id_array_[index] = new_value;
+  IncreaseSize(1);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+  std::copy(key_array_ + index + 1, key_array_ + GetSize(), key_array_ + index);
+  std::copy(page_id_array_ + index + 1, page_id_array_ + GetSize(), page_id_array_ + index);
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * SPLIT AND MERGE
+ *****************************************************************************/
+/*
+ * Move the upper half of this page to the (empty) recipient, whose page id is
+ * recipient_page_id, and link it in as the right sibling of this page. The
+ * recipient's key 0 is the separator that the caller must push up into the
+ * parent; it also becomes this page's high key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient, page_id_t recipient_page_id) {
+  int keep = GetSize() - GetSize() / 2;
+  recipient->CopyNFrom(key_array_ + keep, page_id_array_ + keep, GetSize() - keep);
+  SetSize(keep);
+  recipient->next_page_id_ = next_page_id_;
+  recipient->high_key_ = high_key_;
+  next_page_id_ = recipient_page_id;
+  high_key_ = recipient->key_array_[0];
+}
+
+/*
+ * Append every child of this page to the recipient (its left sibling). The
+ * separator between the two pages comes down from the parent as middle_key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  key_array_[0] = middle_key;
+  recipient->CopyNFrom(key_array_, page_id_array_, GetSize());
+  recipient->next_page_id_ = next_page_id_;
+  recipient->high_key_ = high_key_;
+  SetSize(0);
+}
+
+/*
+ * Move the first child of this page to the end of the recipient (its left
+ * sibling). The caller replaces the parent separator with the new KeyAt(0).
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  key_array_[0] = middle_key;
+  recipient->CopyNFrom(key_array_, page_id_array_, 1);
+  Remove(0);
+}
+
+/*
+ * Move the last child of this page to the front of the recipient (its right
+ * sibling). The caller replaces the parent separator with recipient's new KeyAt(0).
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  int last = GetSize() - 1;
+  recipient->key_array_[0] = middle_key;
+  std::copy_backward(recipient->key_array_, recipient->key_array_ + recipient->GetSize(),
+                     recipient->key_array_ + recipient->GetSize() + 1);
+  std::copy_backward(recipient->page_id_array_, recipient->page_id_array_ + recipient->GetSize(),
+                     recipient->page_id_array_ + recipient->GetSize() + 1);
+  recipient->key_array_[0] = key_array_[last];
+  recipient->page_id_array_[0] = page_id_array_[last];
+  recipient->IncreaseSize(1);
+  IncreaseSize(-1);
+}
+
+/* Append `size` keys and children to the end of this page. */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const KeyType *keys, const ValueType *values, int size) {
+  BUSTUB_ASSERT(static_cast<size_t>(GetSize() + size) <= INTERNAL_PAGE_SLOT_CNT, "internal page overflow");
+  std::copy(keys, keys + size, key_array_ + GetSize());
+  std::copy(values, values + size, page_id_array_ + GetSize());
+  IncreaseSize(size);
+}
 
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
@@ -9,10 +9,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
 #include "common/rid.h"
+#include "storage/index/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -27,26 +29,188 @@ namespace bustub {
  * next page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  static_assert(sizeof(B_PLUS_TREE_LEAF_PAGE_TYPE) <= BUSTUB_PAGE_SIZE, "leaf page does not fit in a page");
+  BUSTUB_ASSERT(max_size > 1 && static_cast<size_t>(max_size) <= LEAF_PAGE_SIZE, "invalid leaf max size");
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
+  SetLSN();
+  next_page_id_ = INVALID_PAGE_ID;
+  prev_page_id_ = INVALID_PAGE_ID;
+}
 
 /**
- * Helper methods to set/get next page id
+ * Helper methods to set/get next and previous page id
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return INVALID_PAGE_ID; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const -> KeyType { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {}
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsPastHighKey(const KeyType &key, const KeyComparator &comparator) const -> bool {
+  return next_page_id_ != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
+}
 
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key{};
-  return key;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return key_array_[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return rid_array_[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { rid_array_[index] = value; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const -> MappingType {
+  return {key_array_[index], rid_array_[index]};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  return BPlusTreeKeySearch<KeyType, KeyComparator>::LowerBound(key_array_, 0, GetSize(), key, comparator);
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const
+    -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(key_array_[index], key) != 0) {
+    return false;
+  }
+  *value = rid_array_[index];
+  return true;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
+    -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index < GetSize() && comparator(key_array_[index], key) == 0) {
+    return false;
+  }
+  BUSTUB_ASSERT(static_cast<size_t>(GetSize()) < LEAF_PAGE_SIZE, "leaf page overflow");
+  ShiftRight(index);
+  key_array_[index] = key;
+  rid_array_[index] = value;
+  IncreaseSize(1);
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &comparator) -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(key_array_[index], key) != 0) {
+    return false;
+  }
+  ShiftLeft(index + 1);
+  IncreaseSize(-1);
+  return true;
+}
+
+/*****************************************************************************
+ * SPLIT AND MERGE
+ *****************************************************************************/
+/*
+ * Move the upper half of this page to the (empty) recipient, whose page id is
+ * recipient_page_id, and link the recipient in as the right sibling of this
+ * page. The recipient's first key becomes this page's high key. The caller
+ * points the back link of the page after the recipient at the recipient.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient, page_id_t recipient_page_id) {
+  int keep = GetSize() - GetSize() / 2;
+  recipient->CopyNFrom(key_array_ + keep, rid_array_ + keep, GetSize() - keep);
+  SetSize(keep);
+  recipient->next_page_id_ = next_page_id_;
+  recipient->prev_page_id_ = GetPageId();
+  recipient->high_key_ = high_key_;
+  next_page_id_ = recipient_page_id;
+  high_key_ = recipient->key_array_[0];
+}
+
+/*
+ * Append every entry of this page to the recipient, which must be the left
+ * sibling of this page, and unlink this page from the sibling list. The caller
+ * points the back link of the next page at the recipient.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  recipient->CopyNFrom(key_array_, rid_array_, GetSize());
+  recipient->next_page_id_ = next_page_id_;
+  recipient->high_key_ = high_key_;
+  SetSize(0);
+}
+
+/* Move the first entry of this page to the end of the recipient (its left sibling). */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->CopyNFrom(key_array_, rid_array_, 1);
+  ShiftLeft(1);
+  IncreaseSize(-1);
+}
+
+/* Move the last entry of this page to the front of the recipient (its right sibling). */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  int last = GetSize() - 1;
+  recipient->ShiftRight(0);
+  recipient->key_array_[0] = key_array_[last];
+  recipient->rid_array_[0] = rid_array_[last];
+  recipient->IncreaseSize(1);
+  IncreaseSize(-1);
+}
+
+/* Append `size` entries to the end of this page. */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const KeyType *keys, const ValueType *values, int size) {
+  BUSTUB_ASSERT(static_cast<size_t>(GetSize() + size) <= LEAF_PAGE_SIZE, "leaf page overflow");
+  std::copy(keys, keys + size, key_array_ + GetSize());
+  std::copy(values, values + size, rid_array_ + GetSize());
+  IncreaseSize(size);
+}
+
+/* Open a hole at `from` by moving entries [from, size) one slot to the right. Size is left unchanged. */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::ShiftRight(int from) {
+  std::copy_backward(key_array_ + from, key_array_ + GetSize(), key_array_ + GetSize() + 1);
+  std::copy_backward(rid_array_ + from, rid_array_ + GetSize(), rid_array_ + GetSize() + 1);
+}
+
+/* Close the hole before `from` by moving entries [from, size) one slot to the left. Size is left unchanged. */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::ShiftLeft(int from) {
+  std::copy(key_array_ + from, key_array_ + GetSize(), key_array_ + from - 1);
+  std::copy(rid_array_ + from, rid_array_ + GetSize(), rid_array_ + from - 1);
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_posting_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+void BPlusTreePostingPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+}
+
+auto BPlusTreePostingPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+void BPlusTreePostingPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+auto BPlusTreePostingPage::GetSize() const -> int { return size_; }
+
+auto BPlusTreePostingPage::IsFull() const -> bool { return static_cast<size_t>(size_) == POSTING_PAGE_SIZE; }
+
+auto BPlusTreePostingPage::RidAt(int index) const -> RID { return rid_array_[index]; }
+
+auto BPlusTreePostingPage::LastRid() const -> RID { return rid_array_[size_ - 1]; }
+
+auto BPlusTreePostingPage::RidIndex(const RID &rid) const -> int {
+  auto it = std::lower_bound(rid_array_, rid_array_ + size_, rid,
+                             [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+  return static_cast<int>(it - rid_array_);
+}
+
+auto BPlusTreePostingPage::Insert(const RID &rid) -> bool {
+  int index = RidIndex(rid);
+  if (index < size_ && rid_array_[index] == rid) {
+    return false;
+  }
+  BUSTUB_ASSERT(!IsFull(), "posting page overflow");
+  std::move_backward(rid_array_ + index, rid_array_ + size_, rid_array_ + size_ + 1);
+  rid_array_[index] = rid;
+  size_++;
+  return true;
+}
+
+auto BPlusTreePostingPage::Remove(const RID &rid) -> bool {
+  int index = RidIndex(rid);
+  if (index == size_ || !(rid_array_[index] == rid)) {
+    return false;
+  }
+  std::move(rid_array_ + index + 1, rid_array_ + size_, rid_array_ + index);
+  size_--;
+  return true;
+}
+
+void BPlusTreePostingPage::CollectRids(std::vector<RID> *result) const {
+  result->insert(result->end(), rid_array_, rid_array_ + size_);
+}
+
+void BPlusTreePostingPage::MoveHalfTo(BPlusTreePostingPage *recipient, page_id_t recipient_page_id) {
+  int keep = size_ / 2;
+  std::copy(rid_array_ + keep, rid_array_ + size_, recipient->rid_array_);
+  recipient->size_ = size_ - keep;
+  size_ = keep;
+  recipient->next_page_id_ = next_page_id_;
+  next_page_id_ = recipient_page_id;
+}
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.cpp
+//
+// Identification: src/storage/page/free_space_map_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/free_space_map_page.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void FreeSpaceMapPage::Init(page_id_t page_id) {
+  page_id_ = page_id;
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+}
+
+auto FreeSpaceMapPage::GetPageId() const -> page_id_t { return page_id_; }
+
+auto FreeSpaceMapPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+void FreeSpaceMapPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+auto FreeSpaceMapPage::GetSize() const -> uint32_t { return size_; }
+
+auto FreeSpaceMapPage::IsFull() const -> bool { return size_ == ARRAY_SIZE; }
+
+auto FreeSpaceMapPage::Append(page_id_t table_page_id, uint8_t category) -> uint32_t {
+  BUSTUB_ASSERT(!IsFull(), "free-space map page is full");
+  table_page_ids_[size_] = table_page_id;
+  categories_[size_] = category;
+  return size_++;
+}
+
+auto FreeSpaceMapPage::GetTablePageId(uint32_t slot) const -> page_id_t { return table_page_ids_[slot]; }
+
+auto FreeSpaceMapPage::GetCategory(uint32_t slot) const -> uint8_t { return categories_[slot]; }
+
+void FreeSpaceMapPage::SetCategory(uint32_t slot, uint8_t category) { categories_[slot] = category; }
+
+auto FreeSpaceMapPage::MaxCategory() const -> uint8_t {
+  return size_ == 0 ? 0 : *std::max_element(categories_, categories_ + size_);
+}
+
+auto FreeSpaceMapPage::FindSlot(uint8_t min_category) const -> uint32_t {
+  return std::find_if(categories_, categories_ + size_, [&](uint8_t category) { return category >= min_category; }) -
+         categories_;
+}
+
+}  // namespace bustub
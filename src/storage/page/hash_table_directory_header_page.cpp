@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_header_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_header_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_directory_header_page.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void HashTableDirectoryHeaderPage::Init(page_id_t page_id, uint32_t max_depth) {
+  BUSTUB_ASSERT(max_depth <= DIRECTORY_HEADER_MAX_DEPTH, "header page cannot hold that many directories");
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  max_depth_ = max_depth;
+  for (auto &directory_page_id : directory_page_ids_) {
+    directory_page_id = INVALID_PAGE_ID;
+  }
+}
+
+auto HashTableDirectoryHeaderPage::GetPageId() const -> page_id_t { return page_id_; }
+
+auto HashTableDirectoryHeaderPage::GetLSN() const -> lsn_t { return lsn_; }
+
+void HashTableDirectoryHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+auto HashTableDirectoryHeaderPage::GetMaxDepth() const -> uint32_t { return max_depth_; }
+
+auto HashTableDirectoryHeaderPage::MaxSize() const -> uint32_t { return 1U << max_depth_; }
+
+auto HashTableDirectoryHeaderPage::HashToDirectoryIndex(uint32_t hash) const -> uint32_t {
+  // shifting a 32-bit value by 32 is undefined
+  return max_depth_ == 0 ? 0 : hash >> (32 - max_depth_);
+}
+
+auto HashTableDirectoryHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t {
+  return directory_page_ids_[directory_idx];
+}
+
+void HashTableDirectoryHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
+
+}  // namespace bustub
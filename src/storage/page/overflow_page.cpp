@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.cpp
+//
+// Identification: src/storage/page/overflow_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/overflow_page.h"
+
+#include <cstring>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void OverflowPage::Init(page_id_t next_page_id, const char *data, uint32_t size) {
+  BUSTUB_ASSERT(size <= DATA_SIZE, "piece does not fit an overflow page");
+  next_page_id_ = next_page_id;
+  size_ = size;
+  memcpy(data_, data, size);
+}
+
+auto OverflowPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+auto OverflowPage::GetSize() const -> uint32_t { return size_; }
+
+auto OverflowPage::GetData() const -> const char * { return data_; }
+
+}  // namespace bustub
@@ -14,13 +14,19 @@ BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept {
 }
 
 void BasicPageGuard::Drop() {
-  if (bpm_ == nullptr || page_ == nullptr) return;
+  if (bpm_ == nullptr || page_ == nullptr) {
+    return;
+  }
   bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
   bpm_ = nullptr;
   page_ = nullptr;
+  is_dirty_ = false;
 }
 
 auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
+  if (this == &that) {
+    return *this;
+  }
   Drop();
   page_ = that.page_;
   bpm_ = that.bpm_;
@@ -34,35 +40,44 @@ auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard
 
 BasicPageGuard::~BasicPageGuard() { Drop(); }
 
-ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept {
-  guard_ = std::move(that.guard_);
-  that.Drop();
-}
+ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept : guard_(std::move(that.guard_)) {}
 
 auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
-  // page is still in RLock
-  guard_.Drop();
+  if (this == &that) {
+    return *this;
+  }
+  // release the latch we are still holding before taking over the other guard
+  Drop();
   guard_ = std::move(that.guard_);
   return *this;
 }
 
 void ReadPageGuard::Drop() {
+  if (guard_.page_ == nullptr) {
+    return;
+  }
   guard_.page_->RUnlatch();
   guard_.Drop();
 }
 
 ReadPageGuard::~ReadPageGuard() { Drop(); }
 
-WritePageGuard::WritePageGuard(WritePageGuard &&that) noexcept { guard_ = std::move(that.guard_); }
+WritePageGuard::WritePageGuard(WritePageGuard &&that) noexcept : guard_(std::move(that.guard_)) {}
 
 auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard & {
-  // page is still in WLock
-  guard_.Drop();
+  if (this == &that) {
+    return *this;
+  }
+  // release the latch we are still holding before taking over the other guard
+  Drop();
   guard_ = std::move(that.guard_);
   return *this;
 }
 
 void WritePageGuard::Drop() {
+  if (guard_.page_ == nullptr) {
+    return;
+  }
   guard_.page_->WUnlatch();
   guard_.Drop();
 }
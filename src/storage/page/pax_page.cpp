@@ -0,0 +1,504 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+#include <algorithm>
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the size of a variable-length value as a tuple stores it: its length word, then its bytes or page ID */
+auto VarlenEntrySize(const char *storage) -> uint32_t {
+  uint32_t len = *reinterpret_cast<const uint32_t *>(storage);
+  if (len == BUSTUB_VALUE_NULL) {
+    return sizeof(uint32_t);
+  }
+  if ((len & TOAST_MASK) != 0) {
+    return sizeof(uint32_t) + sizeof(page_id_t);
+  }
+  return sizeof(uint32_t) + len;
+}
+
+/** @return whether the native value lhs of a column type is less than rhs */
+template <typename T>
+auto IsLess(const char *lhs, const char *rhs) -> bool {
+  T lhs_value;
+  T rhs_value;
+  memcpy(&lhs_value, lhs, sizeof(T));
+  memcpy(&rhs_value, rhs, sizeof(T));
+  return lhs_value < rhs_value;
+}
+
+}  // namespace
+
+void PaxPage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_id, LogManager *log_manager,
+                   Transaction *txn, const Schema &schema) {
+  // Set the page ID.
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  // Log that we are creating a new page.
+  if (enable_logging) {
+    LogRecord log_record =
+        LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id, page_id);
+    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+  // Set the previous and next page IDs.
+  SetPrevPageId(prev_page_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetFreeSpacePointer(page_size);
+  SetRowCount(0);
+
+  // Lay out the minipages, and free every slot.
+  uint32_t capacity = CapacityFor(schema);
+  BUSTUB_ASSERT(capacity > 0, "A PAX page cannot hold a single row of this schema.");
+  std::vector<ColumnEntry> entries;
+  LayOut(schema, capacity, &entries);
+  uint32_t column_count = entries.size();
+  memcpy(GetData() + OFFSET_CAPACITY, &capacity, sizeof(uint32_t));
+  memcpy(GetData() + OFFSET_COLUMN_COUNT, &column_count, sizeof(uint32_t));
+  memcpy(GetColumns(), entries.data(), sizeof(ColumnEntry) * column_count);
+  memset(GetRowStates(), EMPTY, capacity);
+}
+
+auto PaxPage::LayOut(const Schema &schema, uint32_t capacity, std::vector<ColumnEntry> *entries) -> uint32_t {
+  uint32_t offset = SIZE_PAX_PAGE_HEADER + sizeof(ColumnEntry) * schema.GetColumnCount() + capacity;
+  for (const auto &col : schema.GetColumns()) {
+    // Align every minipage to 8 bytes, so that its values are aligned too.
+    offset = (offset + 7) / 8 * 8;
+    if (entries != nullptr) {
+      ColumnEntry entry{};
+      entry.minipage_offset_ = offset;
+      entry.width_ = col.GetFixedLength();
+      entry.type_ = col.GetType();
+      entries->push_back(entry);
+    }
+    offset += col.GetFixedLength() * capacity + (capacity + 7) / 8;
+  }
+  return offset;
+}
+
+auto PaxPage::CapacityFor(const Schema &schema) -> uint32_t {
+  uint32_t header_size = SIZE_PAX_PAGE_HEADER + sizeof(ColumnEntry) * schema.GetColumnCount();
+  if (header_size >= BUSTUB_PAGE_SIZE) {
+    return 0;
+  }
+  // Plan for every row to take a slot in each minipage, and about as much for its variable-length values.
+  uint32_t row_size = sizeof(RowState);
+  uint32_t varlen_size = 0;
+  for (const auto &col : schema.GetColumns()) {
+    row_size += col.GetFixedLength();
+    if (!col.IsInlined()) {
+      varlen_size += sizeof(uint32_t) + std::min(col.GetVariableLength(), EXPECTED_VARLEN_SIZE);
+    }
+  }
+  uint32_t min_varlen_space = varlen_size > 0 ? MIN_VARLEN_SPACE : 0;
+  // Start from an estimate that leaves out alignment, and step down until the layout fits.
+  uint32_t capacity =
+      (BUSTUB_PAGE_SIZE - header_size) * 8 / ((row_size + varlen_size) * 8 + schema.GetColumnCount()) + 1;
+  while (capacity > 0 &&
+         LayOut(schema, capacity, nullptr) + std::max(capacity * varlen_size, min_varlen_space) > BUSTUB_PAGE_SIZE) {
+    capacity--;
+  }
+  return capacity;
+}
+
+auto PaxPage::EmptyPageSpace(const Schema &schema) -> uint32_t {
+  uint32_t capacity = CapacityFor(schema);
+  if (capacity == 0) {
+    return 0;
+  }
+  return schema.GetLength() + Tuple::NullBitmapSize(&schema) + BUSTUB_PAGE_SIZE - LayOut(schema, capacity, nullptr);
+}
+
+auto PaxPage::GetMinipagesEnd() -> uint32_t {
+  const auto &last = GetColumns()[GetColumnCount() - 1];
+  return last.minipage_offset_ + last.width_ * GetCapacity() + (GetCapacity() + 7) / 8;
+}
+
+auto PaxPage::GetFixedRowSize() -> uint32_t {
+  uint32_t size = (GetColumnCount() + 7) / 8;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    size += GetColumns()[i].width_;
+  }
+  return size;
+}
+
+auto PaxPage::GetFreeSpaceRemaining() -> uint32_t {
+  if (GetRowCount() == GetCapacity() && memchr(GetRowStates(), EMPTY, GetRowCount()) == nullptr) {
+    return 0;
+  }
+  return GetFixedRowSize() + GetFreeSpacePointer() - GetMinipagesEnd();
+}
+
+auto PaxPage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager,
+                          LogManager *log_manager) -> bool {
+  BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+  // Reuse a free slot in between, or else take the one after the last used slot.
+  auto *row_states = GetRowStates();
+  auto *empty = static_cast<uint8_t *>(memchr(row_states, EMPTY, GetRowCount()));
+  uint32_t slot_num = empty != nullptr ? empty - row_states : GetRowCount();
+  if (slot_num == GetCapacity() || GetFreeSpacePointer() - GetMinipagesEnd() < tuple.size_ - GetFixedRowSize()) {
+    return false;
+  }
+  WriteRow(slot_num, tuple);
+  rid->Set(GetTablePageId(), slot_num);
+  if (slot_num == GetRowCount()) {
+    SetRowCount(slot_num + 1);
+  }
+  return true;
+}
+
+auto PaxPage::AppendTuple(const Tuple &tuple, RID *rid) -> bool {
+  BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+  uint32_t slot_num = GetRowCount();
+  if (slot_num == GetCapacity() || GetFreeSpacePointer() - GetMinipagesEnd() < tuple.size_ - GetFixedRowSize()) {
+    return false;
+  }
+  WriteRow(slot_num, tuple);
+  SetRowCount(slot_num + 1);
+  rid->Set(GetTablePageId(), slot_num);
+  return true;
+}
+
+auto PaxPage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
+    -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot is invalid, or its tuple is already deleted, abort the transaction.
+  if (slot_num >= GetRowCount() || GetRowStates()[slot_num] != LIVE) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+  GetRowStates()[slot_num] = DELETED;
+  return true;
+}
+
+auto PaxPage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
+                          LockManager *lock_manager, LogManager *log_manager) -> bool {
+  BUSTUB_ASSERT(new_tuple.size_ > 0, "Cannot have empty tuples.");
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot is invalid, or its tuple is deleted, abort the transaction.
+  if (slot_num >= GetRowCount() || GetRowStates()[slot_num] != LIVE) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+  // If the variable-length values do not fit in place of the old ones, the update becomes a delete and an insert.
+  uint32_t old_size = GetRowSize(slot_num);
+  if (GetFreeSpacePointer() - GetMinipagesEnd() + old_size < new_tuple.size_) {
+    return false;
+  }
+
+  // Copy out the old value.
+  if (old_tuple->allocated_) {
+    delete[] old_tuple->data_;
+  }
+  old_tuple->size_ = old_size;
+  old_tuple->data_ = new char[old_size];
+  old_tuple->allocated_ = true;
+  old_tuple->rid_ = rid;
+  ReadRow(slot_num, old_tuple->data_);
+
+  // Perform the update.
+  FreeVarlenValues(slot_num);
+  WriteRow(slot_num, new_tuple);
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *removed_tuple) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetRowCount() && GetRowStates()[slot_num] != EMPTY, "Cannot delete an empty slot.");
+
+  if (removed_tuple != nullptr) {
+    Tuple delete_tuple;
+    delete_tuple.size_ = GetRowSize(slot_num);
+    delete_tuple.data_ = new char[delete_tuple.size_];
+    delete_tuple.allocated_ = true;
+    delete_tuple.rid_ = rid;
+    ReadRow(slot_num, delete_tuple.data_);
+    *removed_tuple = std::move(delete_tuple);
+  }
+
+  FreeVarlenValues(slot_num);
+  auto *row_states = GetRowStates();
+  row_states[slot_num] = EMPTY;
+
+  // Free the empty slots at the end. Once the page is empty, its zone maps start over.
+  uint32_t row_count = GetRowCount();
+  while (row_count > 0 && row_states[row_count - 1] == EMPTY) {
+    row_count--;
+  }
+  SetRowCount(row_count);
+  if (row_count == 0) {
+    for (uint32_t i = 0; i < GetColumnCount(); i++) {
+      GetColumns()[i].has_range_ = 0;
+    }
+  }
+}
+
+void PaxPage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetRowCount(), "We can't have more slots than tuples.");
+  if (GetRowStates()[slot_num] == DELETED) {
+    GetRowStates()[slot_num] = LIVE;
+  }
+}
+
+auto PaxPage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot is invalid, or its tuple is deleted, abort the transaction.
+  if (slot_num >= GetRowCount() || GetRowStates()[slot_num] != LIVE) {
+    if (enable_logging) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return false;
+  }
+  tuple->Allocate(GetRowSize(slot_num));
+  ReadRow(slot_num, tuple->data_);
+  tuple->rid_ = rid;
+  return true;
+}
+
+void PaxPage::CopyTuples(char *copy, std::vector<Tuple> *tuples, const std::vector<uint32_t> *columns) {
+  // The columns left out read as NULL, from a row of NULL values of their types built once.
+  std::vector<bool> is_read;
+  std::vector<char> null_values;
+  if (columns != nullptr) {
+    is_read.assign(GetColumnCount(), false);
+    for (auto column_idx : *columns) {
+      is_read[column_idx] = true;
+    }
+    null_values.resize(GetFixedRowSize());
+    uint32_t row_offset = 0;
+    for (uint32_t i = 0; i < GetColumnCount(); i++) {
+      const auto &column = GetColumns()[i];
+      if (!is_read[i] && column.type_ != TypeId::VARCHAR) {
+        ValueFactory::GetNullValueByType(static_cast<TypeId>(column.type_)).SerializeTo(&null_values[row_offset]);
+      }
+      row_offset += column.width_;
+    }
+  }
+
+  // A row takes no more bytes as a tuple than it does in the page, so the tuples of a page fit a page.
+  uint32_t offset = 0;
+  const auto *read = columns != nullptr ? &is_read : nullptr;
+  for (uint32_t i = 0; i < GetRowCount(); i++) {
+    if (GetRowStates()[i] != LIVE) {
+      continue;
+    }
+    auto size = GetRowSize(i, read);
+    BUSTUB_ASSERT(offset + size <= BUSTUB_PAGE_SIZE, "The tuples of a page should fit a page.");
+    ReadRow(i, copy + offset, read, null_values.data());
+    tuples->push_back(Tuple::View(copy + offset, size, RID(GetTablePageId(), i)));
+    offset += size;
+  }
+}
+
+auto PaxPage::MayMatch(const std::vector<ColumnRange> &ranges) -> bool {
+  for (const auto &range : ranges) {
+    const auto &column = GetColumns()[range.column_idx_];
+    if (column.has_range_ == 0) {
+      continue;
+    }
+    auto type = static_cast<TypeId>(column.type_);
+    if (range.upper_.has_value() &&
+        Value::DeserializeFrom(column.min_, type).CompareGreaterThan(*range.upper_) == CmpBool::CmpTrue) {
+      return false;
+    }
+    if (range.lower_.has_value() &&
+        Value::DeserializeFrom(column.max_, type).CompareLessThan(*range.lower_) == CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto PaxPage::GetFirstTupleRid(RID *first_rid) -> bool {
+  // Find and return the first valid tuple.
+  for (uint32_t i = 0; i < GetRowCount(); ++i) {
+    if (GetRowStates()[i] == LIVE) {
+      first_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+auto PaxPage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  // Find and return the first valid tuple after our current slot number.
+  for (auto i = cur_rid.GetSlotNum() + 1; i < GetRowCount(); ++i) {
+    if (GetRowStates()[i] == LIVE) {
+      next_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  // Otherwise return false as there are no more tuples.
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+auto PaxPage::GetRowSize(uint32_t slot_num, const std::vector<bool> *is_read) -> uint32_t {
+  uint32_t size = GetFixedRowSize();
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    const auto &column = GetColumns()[i];
+    if (column.type_ != TypeId::VARCHAR) {
+      continue;
+    }
+    if (is_read != nullptr && !(*is_read)[i]) {
+      size += sizeof(uint32_t);
+      continue;
+    }
+    size += VarlenEntrySize(GetData() + *reinterpret_cast<uint32_t *>(GetValueAt(column, slot_num)));
+  }
+  return size;
+}
+
+void PaxPage::ReadRow(uint32_t slot_num, char *storage, const std::vector<bool> *is_read, const char *null_values) {
+  uint32_t column_count = GetColumnCount();
+  uint32_t bitmap_offset = GetFixedRowSize() - (column_count + 7) / 8;
+  auto *null_bitmap = reinterpret_cast<uint8_t *>(storage + bitmap_offset);
+  memset(null_bitmap, 0, (column_count + 7) / 8);
+  uint32_t row_offset = 0;
+  uint32_t varlen_offset = bitmap_offset + (column_count + 7) / 8;
+  for (uint32_t i = 0; i < column_count; i++) {
+    const auto &column = GetColumns()[i];
+    bool read = is_read == nullptr || (*is_read)[i];
+    if (!read || (GetNullBits(column)[slot_num / 8] >> (slot_num % 8) & 1) != 0) {
+      null_bitmap[i / 8] |= 1U << (i % 8);
+    }
+    if (column.type_ == TypeId::VARCHAR) {
+      memcpy(storage + row_offset, &varlen_offset, sizeof(uint32_t));
+      if (read) {
+        const char *value = GetData() + *reinterpret_cast<uint32_t *>(GetValueAt(column, slot_num));
+        auto size = VarlenEntrySize(value);
+        memcpy(storage + varlen_offset, value, size);
+        varlen_offset += size;
+      } else {
+        uint32_t null_len = BUSTUB_VALUE_NULL;
+        memcpy(storage + varlen_offset, &null_len, sizeof(uint32_t));
+        varlen_offset += sizeof(uint32_t);
+      }
+    } else {
+      memcpy(storage + row_offset, read ? GetValueAt(column, slot_num) : null_values + row_offset, column.width_);
+    }
+    row_offset += column.width_;
+  }
+}
+
+void PaxPage::WriteRow(uint32_t slot_num, const Tuple &tuple) {
+  uint32_t column_count = GetColumnCount();
+  const char *data = tuple.GetData();
+  const auto *null_bitmap = reinterpret_cast<const uint8_t *>(data + GetFixedRowSize() - (column_count + 7) / 8);
+  uint32_t row_offset = 0;
+  for (uint32_t i = 0; i < column_count; i++) {
+    auto &column = GetColumns()[i];
+    bool is_null = (null_bitmap[i / 8] >> (i % 8) & 1) != 0;
+    auto *null_bits = GetNullBits(column);
+    if (is_null) {
+      null_bits[slot_num / 8] |= 1U << (slot_num % 8);
+    } else {
+      null_bits[slot_num / 8] &= ~(1U << (slot_num % 8));
+    }
+    char *value = GetValueAt(column, slot_num);
+    if (column.type_ == TypeId::VARCHAR) {
+      // Claim free space for the value, with its length word.
+      const char *storage = data + *reinterpret_cast<const uint32_t *>(data + row_offset);
+      auto size = VarlenEntrySize(storage);
+      SetFreeSpacePointer(GetFreeSpacePointer() - size);
+      memcpy(GetData() + GetFreeSpacePointer(), storage, size);
+      uint32_t page_offset = GetFreeSpacePointer();
+      memcpy(value, &page_offset, sizeof(uint32_t));
+    } else {
+      memcpy(value, data + row_offset, column.width_);
+      if (!is_null) {
+        WidenRange(&column, value);
+      }
+    }
+    row_offset += column.width_;
+  }
+  GetRowStates()[slot_num] = LIVE;
+}
+
+void PaxPage::FreeVarlenValues(uint32_t slot_num) {
+  auto *columns = GetColumns();
+  auto *row_states = GetRowStates();
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    if (columns[i].type_ != TypeId::VARCHAR) {
+      continue;
+    }
+    uint32_t value_offset = *reinterpret_cast<uint32_t *>(GetValueAt(columns[i], slot_num));
+    uint32_t size = VarlenEntrySize(GetData() + value_offset);
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    BUSTUB_ASSERT(value_offset >= free_space_pointer, "Free space appears before values.");
+    memmove(GetData() + free_space_pointer + size, GetData() + free_space_pointer, value_offset - free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer + size);
+
+    // Update the offsets of the values that moved.
+    for (uint32_t j = 0; j < GetColumnCount(); j++) {
+      if (columns[j].type_ != TypeId::VARCHAR) {
+        continue;
+      }
+      for (uint32_t slot = 0; slot < GetRowCount(); slot++) {
+        auto *offset = reinterpret_cast<uint32_t *>(GetValueAt(columns[j], slot));
+        if (row_states[slot] != EMPTY && *offset < value_offset) {
+          *offset += size;
+        }
+      }
+    }
+  }
+}
+
+void PaxPage::WidenRange(ColumnEntry *column, const char *value) {
+  bool (*is_less)(const char *, const char *);
+  switch (column->type_) {
+    case TypeId::TINYINT:
+      is_less = IsLess<int8_t>;
+      break;
+    case TypeId::SMALLINT:
+      is_less = IsLess<int16_t>;
+      break;
+    case TypeId::INTEGER:
+      is_less = IsLess<int32_t>;
+      break;
+    case TypeId::BIGINT:
+      is_less = IsLess<int64_t>;
+      break;
+    case TypeId::DECIMAL:
+      is_less = IsLess<double>;
+      break;
+    default:
+      return;
+  }
+  if (column->has_range_ == 0) {
+    memcpy(column->min_, value, column->width_);
+    memcpy(column->max_, value, column->width_);
+    column->has_range_ = 1;
+    return;
+  }
+  if (is_less(value, column->min_)) {
+    memcpy(column->min_, value, column->width_);
+  }
+  if (is_less(column->max_, value)) {
+    memcpy(column->max_, value, column->width_);
+  }
+}
+
+}  // namespace bustub
@@ -38,12 +38,12 @@ void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_
 auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager,
                             LogManager *log_manager) -> bool {
   BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
-  // If there is not enough space, then return false.
-  if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+  // If there is not enough space even for the tuple alone, then return false.
+  if (GetFreeSpaceRemaining() < tuple.size_) {
     return false;
   }
 
-  // Try to find a free slot to reuse.
+  // Try to find a free slot to reuse; a reused slot costs no header bytes.
   uint32_t i;
   for (i = 0; i < GetTupleCount(); i++) {
     // If the slot is empty, i.e. its tuple has size 0,
@@ -89,6 +89,21 @@ auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
   return true;
 }
 
+auto TablePage::AppendTuple(const Tuple &tuple, RID *rid) -> bool {
+  BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+  if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+    return false;
+  }
+  uint32_t slot_num = GetTupleCount();
+  SetFreeSpacePointer(GetFreeSpacePointer() - tuple.size_);
+  memcpy(GetData() + GetFreeSpacePointer(), tuple.data_, tuple.size_);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
+  SetTupleSize(slot_num, tuple.size_);
+  SetTupleCount(slot_num + 1);
+  rid->Set(GetTablePageId(), slot_num);
+  return true;
+}
+
 auto TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
     -> bool {
   uint32_t slot_num = rid.GetSlotNum();
@@ -208,7 +223,7 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   return true;
 }
 
-void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *removed_tuple) {
   uint32_t slot_num = rid.GetSlotNum();
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
@@ -257,6 +272,17 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
       SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
     }
   }
+
+  // Give the empty slots at the end of the slot array back to the free space. No RID can point at them any more.
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetTupleSize(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+
+  if (removed_tuple != nullptr) {
+    *removed_tuple = delete_tuple;
+  }
 }
 
 void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
@@ -315,17 +341,22 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
 
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
-  }
-  tuple->data_ = new char[tuple->size_];
+  tuple->Allocate(tuple_size);
   memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
   tuple->rid_ = rid;
-  tuple->allocated_ = true;
   return true;
 }
 
+void TablePage::CopyTuples(char *copy, std::vector<Tuple> *tuples) {
+  memcpy(copy, GetData(), BUSTUB_PAGE_SIZE);
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    auto tuple_size = GetTupleSize(i);
+    if (!IsDeleted(tuple_size)) {
+      tuples->push_back(Tuple::View(copy + GetTupleOffsetAtSlot(i), tuple_size, RID(GetTablePageId(), i)));
+    }
+  }
+}
+
 auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
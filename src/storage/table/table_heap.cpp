@@ -10,91 +10,528 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 
 #include "common/logger.h"
 #include "fmt/format.h"
+#include "storage/page/free_space_map_page.h"
+#include "storage/page/overflow_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
+// A toasted tuple fits an empty PAX page, which keeps that much room for its variable-length values.
+static_assert(TableHeap::TOAST_THRESHOLD <= PaxPage::MIN_VARLEN_SPACE);
+
+namespace {
+
+/** @return a copy of schema for a heap that toasts or stores PAX pages, nullptr if the heap needs none */
+auto HeapSchema(const Schema *schema, TableFormat format) -> std::unique_ptr<Schema> {
+  if (schema == nullptr || (schema->GetUnlinedColumns().empty() && format == TableFormat::ROW)) {
+    return nullptr;
+  }
+  return std::make_unique<Schema>(*schema);
+}
+
+/** @return the size of the largest tuple an empty page of a heap takes */
+auto MaxTupleSize(const Schema *schema, TableFormat format) -> uint32_t {
+  if (format == TableFormat::PAX) {
+    BUSTUB_ASSERT(schema != nullptr, "A PAX heap needs the schema of its tuples.");
+    return PaxPage::EmptyPageSpace(*schema);
+  }
+  return BUSTUB_PAGE_SIZE - 32;
+}
+
+/** @return true if the length word of a variable-length value says it is toasted */
+auto IsToastedLength(uint32_t len) -> bool { return len != BUSTUB_VALUE_NULL && (len & TOAST_MASK) != 0; }
+
+}  // namespace
+
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, const Schema *schema, TableFormat format)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      format_(format),
+      schema_(HeapSchema(schema, format)),
+      max_tuple_size_(MaxTupleSize(schema, format)) {
+  // The free-space map is not persisted with the table, so list every page again.
+  std::scoped_lock latch(insert_latch_);
+  ListPages();
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, const Schema *schema, TableFormat format)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      format_(format),
+      schema_(HeapSchema(schema, format)),
+      max_tuple_size_(MaxTupleSize(schema, format)) {
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
+  auto first_page = buffer_pool_manager_->NewPage(&first_page_id_);
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  InitPage(first_page, first_page_id_, INVALID_LSN, txn);
+  AddToFreeSpaceMap(first_page_id_, GetFreeSpace(first_page));
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  last_page_id_ = first_page_id_;
+  last_insert_page_id_ = first_page_id_;
+}
+
+void TableHeap::InitPage(Page *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn) {
+  if (format_ == TableFormat::PAX) {
+    static_cast<PaxPage *>(page)->Init(page_id, BUSTUB_PAGE_SIZE, prev_page_id, log_manager_, txn, *schema_);
+    return;
+  }
+  static_cast<TablePage *>(page)->Init(page_id, BUSTUB_PAGE_SIZE, prev_page_id, log_manager_, txn);
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
-  if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+  Tuple toasted;
+  if (tuple.size_ > TOAST_THRESHOLD && Toast(tuple, &toasted)) {
+    if (InsertStoredTuple(toasted, rid, txn)) {
+      return true;
+    }
+    FreeOverflowPages(toasted);
+    return false;
+  }
+  return InsertStoredTuple(tuple, rid, txn);
+}
+
+auto TableHeap::InsertStoredTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+  if (tuple.size_ > max_tuple_size_) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
+  std::scoped_lock latch(insert_latch_);
+  // Most inserts fit into the page the previous insert went to.
+  if (InsertIntoPage(last_insert_page_id_, tuple, rid, txn)) {
+    RecordWrite(txn, *rid, WType::INSERT);
+    return true;
+  }
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+  // Otherwise ask the free-space map. Every miss lowers the category of the page that missed, so this terminates.
+  auto space_needed = VisitPage(nullptr, [&](auto *table_page) {
+    return std::remove_pointer_t<decltype(table_page)>::SpaceNeeded(tuple);
+  });
+  for (auto page_id = FindPageWithSpace(space_needed); page_id != INVALID_PAGE_ID;
+       page_id = FindPageWithSpace(space_needed)) {
+    if (InsertIntoPage(page_id, tuple, rid, txn)) {
+      last_insert_page_id_ = page_id;
+      RecordWrite(txn, *rid, WType::INSERT);
+      return true;
+    }
+    if (txn->GetState() == TransactionState::ABORTED) {
+      return false;
+    }
+  }
+  // No page has room: grow the table.
+  auto new_page = NewLastPage(txn);
+  if (new_page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  BUSTUB_ENSURE(VisitPage(new_page,
+                          [&](auto *table_page) {
+                            return table_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+                          }),
+                "tuple must fit an empty page");
+  SetFreeSpace(new_page->GetPageId(), GetFreeSpace(new_page), false);
+  new_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(new_page->GetPageId(), true);
+  RecordWrite(txn, *rid, WType::INSERT);
+  return true;
+}
+
+auto TableHeap::AppendTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool {
+  auto is_large = [](const Tuple &tuple) { return tuple.size_ > TOAST_THRESHOLD; };
+  if (schema_ == nullptr || std::none_of(tuples.begin(), tuples.end(), is_large)) {
+    return AppendStoredTuples(tuples, rids, txn);
+  }
+  std::vector<Tuple> stored_tuples(tuples);
+  for (auto &tuple : stored_tuples) {
+    Tuple toasted;
+    if (is_large(tuple) && Toast(tuple, &toasted)) {
+      tuple = toasted;
+    }
+  }
+  auto num_rids = rids->size();
+  if (AppendStoredTuples(stored_tuples, rids, txn)) {
+    return true;
+  }
+  // Rolling back frees the overflow pages of the tuples that went in, but not of the ones that did not.
+  for (auto i = rids->size() - num_rids; i < stored_tuples.size(); i++) {
+    FreeOverflowPages(stored_tuples[i]);
+  }
+  return false;
+}
+
+auto TableHeap::AppendStoredTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn)
+    -> bool {
+  for (const auto &tuple : tuples) {
+    if (tuple.size_ > max_tuple_size_) {  // larger than one page size
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
 
-  cur_page->WLatch();
-
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      next_page->WLatch();
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+  std::scoped_lock latch(insert_latch_);
+  auto page = buffer_pool_manager_->FetchPage(last_page_id_);
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  page->WLatch();
+  rids->reserve(rids->size() + tuples.size());
+  for (const auto &tuple : tuples) {
+    RID rid;
+    while (!VisitPage(page, [&](auto *table_page) { return table_page->AppendTuple(tuple, &rid); })) {
+      // The page is full: record its free space once, then move on to a fresh page.
+      SetFreeSpace(page->GetPageId(), GetFreeSpace(page), false);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      page = NewLastPage(txn);
+      if (page == nullptr) {
         txn->SetState(TransactionState::ABORTED);
         return false;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
-    }
-  }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-  // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+    }
+    rids->push_back(rid);
+    RecordWrite(txn, rid, WType::INSERT);
+  }
+  SetFreeSpace(page->GetPageId(), GetFreeSpace(page), false);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  last_insert_page_id_ = last_page_id_;
+  return true;
+}
+
+auto TableHeap::Toast(const Tuple &tuple, Tuple *toasted) -> bool {
+  if (schema_ == nullptr) {
+    return false;
+  }
+  // Pick the values to move, largest first, until the rest of the tuple fits. A value no larger than the page ID
+  // that would replace it stays.
+  std::vector<std::pair<uint32_t, uint32_t>> candidates;
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    uint32_t len = *reinterpret_cast<const uint32_t *>(tuple.GetDataPtr(schema_.get(), column_idx));
+    if (len != BUSTUB_VALUE_NULL && !IsToastedLength(len) && len > sizeof(page_id_t)) {
+      candidates.emplace_back(len, column_idx);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), std::greater<>());
+  std::vector<bool> is_moved(schema_->GetColumnCount(), false);
+  uint32_t size = tuple.size_;
+  for (auto [len, column_idx] : candidates) {
+    if (size <= TOAST_THRESHOLD) {
+      break;
+    }
+    is_moved[column_idx] = true;
+    size -= len - sizeof(page_id_t);
+  }
+  if (size == tuple.size_) {
+    return false;
+  }
+
+  // Lay the tuple out again: the fixed-size part and the null bitmap as they are, then the variable-length values in
+  // column order.
+  if (toasted->allocated_) {
+    delete[] toasted->data_;
+  }
+  toasted->size_ = size;
+  toasted->data_ = new char[size];
+  toasted->allocated_ = true;
+  uint32_t offset = schema_->GetLength() + Tuple::NullBitmapSize(schema_.get());
+  memcpy(toasted->data_, tuple.data_, offset);
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    const char *storage = tuple.GetDataPtr(schema_.get(), column_idx);
+    uint32_t len = *reinterpret_cast<const uint32_t *>(storage);
+    memcpy(toasted->data_ + schema_->GetColumn(column_idx).GetOffset(), &offset, sizeof(uint32_t));
+    if (is_moved[column_idx]) {
+      auto first_page_id = WriteOverflowPages(storage + sizeof(uint32_t), len);
+      uint32_t toasted_len = len | TOAST_MASK;
+      memcpy(toasted->data_ + offset, &toasted_len, sizeof(uint32_t));
+      memcpy(toasted->data_ + offset + sizeof(uint32_t), &first_page_id, sizeof(page_id_t));
+      offset += sizeof(uint32_t) + sizeof(page_id_t);
+      continue;
+    }
+    uint32_t entry_size = sizeof(uint32_t);
+    if (IsToastedLength(len)) {
+      entry_size += sizeof(page_id_t);
+    } else if (len != BUSTUB_VALUE_NULL) {
+      entry_size += len;
+    }
+    memcpy(toasted->data_ + offset, storage, entry_size);
+    offset += entry_size;
+  }
+  BUSTUB_ASSERT(offset == size, "toasted tuple size mismatch");
   return true;
 }
 
+auto TableHeap::WriteOverflowPages(const char *data, uint32_t size) -> page_id_t {
+  // Write the chain from its end, so that every page knows its successor when it is filled.
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  for (auto i = (size + OverflowPage::DATA_SIZE - 1) / OverflowPage::DATA_SIZE; i-- > 0;) {
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(&page_id);
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    auto start = i * OverflowPage::DATA_SIZE;
+    reinterpret_cast<OverflowPage *>(page->GetData())
+        ->Init(next_page_id, data + start, std::min(OverflowPage::DATA_SIZE, size - start));
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    next_page_id = page_id;
+  }
+  return next_page_id;
+}
+
+void TableHeap::FreeOverflowPages(const Tuple &tuple) {
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    const char *storage = tuple.GetDataPtr(schema_.get(), column_idx);
+    if (!IsToastedLength(*reinterpret_cast<const uint32_t *>(storage))) {
+      continue;
+    }
+    auto page_id = *reinterpret_cast<const page_id_t *>(storage + sizeof(uint32_t));
+    while (page_id != INVALID_PAGE_ID) {
+      auto next_page_id = buffer_pool_manager_->FetchPageRead(page_id).As<OverflowPage>()->GetNextPageId();
+      buffer_pool_manager_->DeletePage(page_id);
+      page_id = next_page_id;
+    }
+  }
+}
+
+auto TableHeap::ReadToastedValue(const char *storage, TypeId type) const -> Value {
+  uint32_t len = *reinterpret_cast<const uint32_t *>(storage) & ~TOAST_MASK;
+  auto page_id = *reinterpret_cast<const page_id_t *>(storage + sizeof(uint32_t));
+  std::vector<char> data;
+  data.reserve(len);
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    auto page = guard.As<OverflowPage>();
+    data.insert(data.end(), page->GetData(), page->GetData() + page->GetSize());
+    page_id = page->GetNextPageId();
+  }
+  BUSTUB_ASSERT(data.size() == len, "overflow pages do not add up to the value");
+  return {type, data.data(), len, true};
+}
+
+auto TableHeap::InsertIntoPage(page_id_t page_id, const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+  auto page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  page->WLatch();
+  bool inserted = VisitPage(
+      page, [&](auto *table_page) { return table_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_); });
+  if (!inserted) {
+    SetFreeSpace(page_id, GetFreeSpace(page), false);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, inserted);
+  return inserted;
+}
+
+auto TableHeap::NewLastPage(Transaction *txn) -> Page * {
+  auto last_page = buffer_pool_manager_->FetchPage(last_page_id_);
+  if (last_page == nullptr) {
+    return nullptr;
+  }
+  page_id_t new_page_id;
+  auto new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (new_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(last_page_id_, false);
+    return nullptr;
+  }
+  new_page->WLatch();
+  InitPage(new_page, new_page_id, last_page_id_, txn);
+  AddToFreeSpaceMap(new_page_id, GetFreeSpace(new_page));
+
+  // Iterators that step onto the new page wait for its latch, and find it empty or filled.
+  last_page->WLatch();
+  VisitPage(last_page, [&](auto *table_page) { table_page->SetNextPageId(new_page_id); });
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+  last_page_id_ = new_page_id;
+  last_insert_page_id_ = new_page_id;
+  return new_page;
+}
+
+void TableHeap::AddToFreeSpaceMap(page_id_t page_id, uint32_t free_space) {
+  // Map pages are only touched under insert_latch_, so they need no page latches.
+  auto category = FreeSpaceMapPage::CategoryOf(free_space);
+  BasicPageGuard fsm_guard;
+  if (!fsm_page_ids_.empty()) {
+    fsm_guard = buffer_pool_manager_->FetchPageBasic(fsm_page_ids_.back());
+  }
+  if (fsm_page_ids_.empty() || fsm_guard.As<FreeSpaceMapPage>()->IsFull()) {
+    page_id_t fsm_page_id;
+    auto new_guard = buffer_pool_manager_->NewPageGuarded(&fsm_page_id);
+    new_guard.AsMut<FreeSpaceMapPage>()->Init(fsm_page_id);
+    if (!fsm_page_ids_.empty()) {
+      fsm_guard.AsMut<FreeSpaceMapPage>()->SetNextPageId(fsm_page_id);
+    }
+    fsm_guard = std::move(new_guard);
+    fsm_page_ids_.push_back(fsm_page_id);
+    fsm_max_categories_.push_back(0);
+  }
+  auto slot = fsm_guard.AsMut<FreeSpaceMapPage>()->Append(page_id, category);
+  fsm_slots_[page_id] = (fsm_page_ids_.size() - 1) * FreeSpaceMapPage::ARRAY_SIZE + slot;
+  fsm_max_categories_.back() = std::max(fsm_max_categories_.back(), category);
+}
+
+void TableHeap::SetFreeSpace(page_id_t page_id, uint32_t free_space, bool raise_only) {
+  auto category = FreeSpaceMapPage::CategoryOf(free_space);
+  auto slot = fsm_slots_.at(page_id);
+  auto fsm_idx = slot / FreeSpaceMapPage::ARRAY_SIZE;
+  auto fsm_guard = buffer_pool_manager_->FetchPageBasic(fsm_page_ids_[fsm_idx]);
+  auto fsm_page = fsm_guard.AsMut<FreeSpaceMapPage>();
+  auto old_category = fsm_page->GetCategory(slot % FreeSpaceMapPage::ARRAY_SIZE);
+  if (category == old_category || (raise_only && category < old_category)) {
+    return;
+  }
+  fsm_page->SetCategory(slot % FreeSpaceMapPage::ARRAY_SIZE, category);
+  fsm_max_categories_[fsm_idx] =
+      category > old_category ? std::max(fsm_max_categories_[fsm_idx], category) : fsm_page->MaxCategory();
+}
+
+auto TableHeap::FindPageWithSpace(uint32_t needed_bytes) -> page_id_t {
+  auto min_category = FreeSpaceMapPage::CategoryFor(needed_bytes);
+  for (size_t fsm_idx = 0; fsm_idx < fsm_page_ids_.size(); fsm_idx++) {
+    if (fsm_max_categories_[fsm_idx] < min_category) {
+      continue;
+    }
+    auto fsm_guard = buffer_pool_manager_->FetchPageBasic(fsm_page_ids_[fsm_idx]);
+    auto fsm_page = fsm_guard.As<FreeSpaceMapPage>();
+    auto slot = fsm_page->FindSlot(min_category);
+    if (slot < fsm_page->GetSize()) {
+      return fsm_page->GetTablePageId(slot);
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+auto TableHeap::GetNumPages() -> size_t {
+  std::scoped_lock latch(insert_latch_);
+  return fsm_slots_.size();
+}
+
+auto TableHeap::Vacuum(const std::function<void(const Tuple &, const RID &, const RID &)> &on_move, Transaction *txn)
+    -> std::optional<size_t> {
+  // Scans hold the latch for a whole statement, so give up on an open one like on uncommitted changes.
+  std::unique_lock vacuum_latch(vacuum_latch_, std::try_to_lock);
+  if (!vacuum_latch.owns_lock()) {
+    return std::nullopt;
+  }
+  std::scoped_lock latch(insert_latch_);
+  {
+    std::scoped_lock writers_latch(writers_latch_);
+    for (const auto &[txn_id, num_writes] : writers_) {
+      if (txn_id != txn->GetTransactionId()) {
+        return std::nullopt;
+      }
+    }
+  }
+  std::vector<page_id_t> page_ids;
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page_ids.push_back(page_id);
+    page_id = GetNextPageId(page);
+    buffer_pool_manager_->UnpinPage(page_ids.back(), false);
+  }
+
+  // Empty the pages from the back into the pages from the front, until the two meet.
+  size_t num_dropped = 0;
+  size_t dst = 0;
+  for (size_t src = page_ids.size() - 1; dst < src && txn->GetState() != TransactionState::ABORTED; src--) {
+    auto page = buffer_pool_manager_->FetchPage(page_ids[src]);
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->WLatch();
+    page_id_t prev_page_id;
+    page_id_t next_page_id;
+    bool is_empty = VisitPage(page, [&](auto *src_page) {
+      RID rid;
+      for (bool found = src_page->GetFirstTupleRid(&rid); found; found = src_page->GetNextTupleRid(rid, &rid)) {
+        Tuple tuple;
+        src_page->GetTuple(rid, &tuple, txn, lock_manager_);
+        tuple.heap_ = this;
+        RID new_rid;
+        while (dst < src && !InsertIntoPage(page_ids[dst], tuple, &new_rid, txn)) {
+          dst++;
+        }
+        if (dst == src || txn->GetState() == TransactionState::ABORTED) {
+          break;
+        }
+        on_move(tuple, rid, new_rid);
+        src_page->ApplyDelete(rid, txn, log_manager_);
+      }
+      prev_page_id = src_page->GetPrevPageId();
+      next_page_id = src_page->GetNextPageId();
+      return src_page->IsEmpty();
+    });
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_ids[src], true);
+    if (is_empty) {
+      UnlinkPage(page_ids[src], prev_page_id, next_page_id);
+      num_dropped++;
+    }
+  }
+
+  // Most pages have other free space now, and the dropped ones none at all, so start the free-space map over.
+  ListPages();
+  return num_dropped;
+}
+
+void TableHeap::ListPages() {
+  for (auto fsm_page_id : fsm_page_ids_) {
+    buffer_pool_manager_->DeletePage(fsm_page_id);
+  }
+  fsm_page_ids_.clear();
+  fsm_max_categories_.clear();
+  fsm_slots_.clear();
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->RLatch();
+    AddToFreeSpaceMap(page_id, GetFreeSpace(page));
+    auto next_page_id = GetNextPageId(page);
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    last_page_id_ = page_id;
+    page_id = next_page_id;
+  }
+  last_insert_page_id_ = last_page_id_;
+}
+
+void TableHeap::UnlinkPage(page_id_t page_id, page_id_t prev_page_id, page_id_t next_page_id) {
+  auto prev_page = buffer_pool_manager_->FetchPage(prev_page_id);
+  BUSTUB_ASSERT(prev_page != nullptr, "Couldn't fetch a page of the table heap.");
+  prev_page->WLatch();
+  VisitPage(prev_page, [&](auto *table_page) { table_page->SetNextPageId(next_page_id); });
+  prev_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  if (next_page_id != INVALID_PAGE_ID) {
+    auto next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    BUSTUB_ASSERT(next_page != nullptr, "Couldn't fetch a page of the table heap.");
+    next_page->WLatch();
+    VisitPage(next_page, [&](auto *table_page) { table_page->SetPrevPageId(prev_page_id); });
+    next_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(next_page_id, true);
+  }
+  buffer_pool_manager_->DeletePage(page_id);
+}
+
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
   // TODO(Amadou): remove empty page
+  std::shared_lock vacuum_latch(vacuum_latch_);
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
@@ -102,63 +539,124 @@ auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  VisitPage(page, [&](auto *table_page) { return table_page->MarkDelete(rid, txn, lock_manager_, log_manager_); });
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
   // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
+  RecordWrite(txn, rid, WType::DELETE);
   return true;
 }
 
 auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool {
+  std::shared_lock vacuum_latch(vacuum_latch_);
+  Tuple toasted;
+  bool is_toasted = tuple.size_ > TOAST_THRESHOLD && Toast(tuple, &toasted);
+  // Save the old value for rollbacks.
+  Tuple old_tuple;
+  if (!UpdateStoredTuple(is_toasted ? toasted : tuple, rid, txn, &old_tuple)) {
+    if (is_toasted) {
+      FreeOverflowPages(toasted);
+    }
+    return false;
+  }
+  // Update the transaction's write set.
+  if (txn->GetState() != TransactionState::ABORTED) {
+    RecordWrite(txn, rid, WType::UPDATE, old_tuple);
+  }
+  return true;
+}
+
+void TableHeap::ApplyUpdate(const Tuple &old_tuple) {
+  if (schema_ != nullptr) {
+    FreeOverflowPages(old_tuple);
+  }
+}
+
+void TableHeap::RollbackUpdate(const Tuple &old_tuple, const RID &rid, Transaction *txn) {
+  Tuple replaced;
+  if (UpdateStoredTuple(old_tuple, rid, txn, &replaced) && schema_ != nullptr) {
+    FreeOverflowPages(replaced);
+  }
+}
+
+auto TableHeap::UpdateStoredTuple(const Tuple &tuple, const RID &rid, Transaction *txn, Tuple *old_tuple) -> bool {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
-  // Update the tuple; but first save the old value for rollbacks.
-  Tuple old_tuple;
+  // Update the tuple.
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  bool is_updated = VisitPage(page, [&](auto *table_page) {
+    return table_page->UpdateTuple(tuple, old_tuple, rid, txn, lock_manager_, log_manager_);
+  });
+  auto free_space = GetFreeSpace(page);
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
-  // Update the transaction's write set.
-  if (is_updated && txn->GetState() != TransactionState::ABORTED) {
-    txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), is_updated);
+  if (is_updated) {
+    // Inserts take the page latch under insert_latch_, so never the other way around.
+    std::scoped_lock latch(insert_latch_);
+    SetFreeSpace(rid.GetPageId(), free_space, true);
   }
   return is_updated;
 }
 
 void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
   page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  Tuple removed_tuple;
+  VisitPage(page, [&](auto *table_page) {
+    table_page->ApplyDelete(rid, txn, log_manager_, schema_ != nullptr ? &removed_tuple : nullptr);
+  });
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
+  auto free_space = GetFreeSpace(page);
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+  if (schema_ != nullptr) {
+    FreeOverflowPages(removed_tuple);
+  }
+  // Inserts take the page latch under insert_latch_, so never the other way around.
+  std::scoped_lock latch(insert_latch_);
+  SetFreeSpace(rid.GetPageId(), free_space, true);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Rollback the delete.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  VisitPage(page, [&](auto *table_page) { table_page->RollbackDelete(rid, txn, log_manager_); });
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+}
+
+void TableHeap::RecordWrite(Transaction *txn, const RID &rid, WType wtype, const Tuple &old_tuple) {
+  {
+    std::scoped_lock latch(writers_latch_);
+    writers_[txn->GetTransactionId()]++;
+  }
+  txn->GetWriteSet()->emplace_back(rid, wtype, old_tuple, this);
+}
+
+void TableHeap::ReleaseWrite(Transaction *txn) {
+  std::scoped_lock latch(writers_latch_);
+  auto writer = writers_.find(txn->GetTransactionId());
+  if (writer != writers_.end() && --writer->second == 0) {
+    writers_.erase(writer);
+  }
 }
 
 auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
@@ -168,7 +666,8 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   if (acquire_read_lock) {
     page->RLatch();
   }
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  bool res = VisitPage(page, [&](auto *table_page) { return table_page->GetTuple(rid, tuple, txn, lock_manager_); });
+  tuple->heap_ = this;
   if (acquire_read_lock) {
     page->RUnlatch();
   }
@@ -176,22 +675,45 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   return res;
 }
 
+auto TableHeap::ScanPage(page_id_t page_id, char *copy, std::vector<Tuple> *tuples,
+                         const std::vector<uint32_t> *columns, const std::vector<ColumnRange> *ranges) -> page_id_t {
+  auto page = buffer_pool_manager_->FetchPage(page_id);
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  tuples->clear();
+  page->RLatch();
+  if (format_ == TableFormat::PAX) {
+    auto pax_page = static_cast<PaxPage *>(page);
+    if (ranges == nullptr || pax_page->MayMatch(*ranges)) {
+      pax_page->CopyTuples(copy, tuples, columns);
+    }
+  } else {
+    static_cast<TablePage *>(page)->CopyTuples(copy, tuples);
+  }
+  auto next_page_id = GetNextPageId(page);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  for (auto &tuple : *tuples) {
+    tuple.heap_ = this;
+  }
+  return next_page_id;
+}
+
 auto TableHeap::Begin(Transaction *txn) -> TableIterator {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = buffer_pool_manager_->FetchPage(page_id);
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-    auto found_tuple = page->GetFirstTupleRid(&rid);
+    auto found_tuple = VisitPage(page, [&](auto *table_page) { return table_page->GetFirstTupleRid(&rid); });
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
     if (found_tuple) {
       break;
     }
-    page_id = page->GetNextPageId();
+    page_id = GetNextPageId(page);
   }
   return {this, rid, txn};
 }
@@ -39,20 +39,22 @@ auto TableIterator::operator->() -> Tuple * {
 
 auto TableIterator::operator++() -> TableIterator & {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  auto cur_page = buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId());
   BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
 
   cur_page->RLatch();
   RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+  if (!table_heap_->VisitPage(cur_page, [&](auto *table_page) {
+        return table_page->GetNextTupleRid(tuple_->rid_, &next_tuple_rid);
+      })) {  // end of this page
+    while (table_heap_->GetNextPageId(cur_page) != INVALID_PAGE_ID) {
+      auto next_page = buffer_pool_manager->FetchPage(table_heap_->GetNextPageId(cur_page));
       cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+      buffer_pool_manager->UnpinPage(cur_page->GetPageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
+      if (table_heap_->VisitPage(cur_page,
+                                 [&](auto *table_page) { return table_page->GetFirstTupleRid(&next_tuple_rid); })) {
         break;
       }
     }
@@ -64,13 +66,13 @@ auto TableIterator::operator++() -> TableIterator & {
     // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
     if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
       cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+      buffer_pool_manager->UnpinPage(cur_page->GetPageId(), false);
       throw bustub::Exception("read non-existing tuple");
     }
   }
   // release until copy the tuple
   cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+  buffer_pool_manager->UnpinPage(cur_page->GetPageId(), false);
   return *this;
 }
 
@@ -16,16 +16,34 @@
 #include <string>
 #include <vector>
 
+#include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/arena_pool.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
-// TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
-Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true) {
+Tuple::Tuple(const std::vector<Value> &values, const Schema *schema) {
   assert(values.size() == schema->GetColumnCount());
+  Allocate(SerializedSize(values, schema));
+  SerializeValues(values, schema, data_);
+}
+
+void Tuple::Allocate(uint32_t size) {
+  if (allocated_) {
+    delete[] data_;
+  }
+  size_ = size;
+  auto *arena = ArenaPool::Current();
+  data_ = arena != nullptr ? static_cast<char *>(arena->Allocate(size)) : nullptr;
+  allocated_ = data_ == nullptr;
+  if (allocated_) {
+    data_ = new char[size];
+  }
+}
 
-  // 1. Calculate the size of the tuple.
-  uint32_t tuple_size = schema->GetLength();
+auto Tuple::SerializedSize(const std::vector<Value> &values, const Schema *schema) -> uint32_t {
+  uint32_t tuple_size = schema->GetLength() + NullBitmapSize(schema);
   for (auto &i : schema->GetUnlinedColumns()) {
     auto len = values[i].GetLength();
     if (len == BUSTUB_VALUE_NULL) {
@@ -33,65 +51,113 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
     }
     tuple_size += (len + sizeof(uint32_t));
   }
+  return tuple_size;
+}
 
-  // 2. Allocate memory.
-  size_ = tuple_size;
-  data_ = new char[size_];
-  std::memset(data_, 0, size_);
+void Tuple::SerializeValues(const std::vector<Value> &values, const Schema *schema, char *storage) {
+  std::memset(storage, 0, schema->GetLength() + NullBitmapSize(schema));
 
-  // 3. Serialize each attribute based on the input value.
+  // Serialize each attribute based on the input value.
   uint32_t column_count = schema->GetColumnCount();
-  uint32_t offset = schema->GetLength();
+  auto *null_bitmap = reinterpret_cast<uint8_t *>(storage + schema->GetLength());
+  uint32_t offset = schema->GetLength() + NullBitmapSize(schema);
 
   for (uint32_t i = 0; i < column_count; i++) {
     const auto &col = schema->GetColumn(i);
+    if (values[i].IsNull()) {
+      null_bitmap[i / 8] |= 1U << (i % 8);
+    }
     if (!col.IsInlined()) {
       // Serialize relative offset, where the actual varchar data is stored.
-      *reinterpret_cast<uint32_t *>(data_ + col.GetOffset()) = offset;
+      *reinterpret_cast<uint32_t *>(storage + col.GetOffset()) = offset;
       // Serialize varchar value, in place (size+data).
-      values[i].SerializeTo(data_ + offset);
+      values[i].SerializeTo(storage + offset);
       auto len = values[i].GetLength();
       if (len == BUSTUB_VALUE_NULL) {
         len = 0;
       }
       offset += (len + sizeof(uint32_t));
     } else {
-      values[i].SerializeTo(data_ + col.GetOffset());
+      values[i].SerializeTo(storage + col.GetOffset());
     }
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
-  if (allocated_) {
-    delete[] data_;
+auto Tuple::View(char *data, uint32_t size, RID rid) -> Tuple {
+  Tuple tuple(rid);
+  tuple.size_ = size;
+  tuple.data_ = data;
+  return tuple;
+}
+
+auto Tuple::ViewOf(const std::vector<Value> &values, const Schema *schema, std::vector<char> *buffer) -> Tuple {
+  assert(values.size() == schema->GetColumnCount());
+  auto size = SerializedSize(values, schema);
+  if (buffer->size() < size) {
+    buffer->resize(size);
   }
-  if (allocated_) {
-    // Deep copy.
+  SerializeValues(values, schema, buffer->data());
+  return View(buffer->data(), size);
+}
+
+Tuple::Tuple(const Tuple &other) : rid_(other.rid_), size_(other.size_), heap_(other.heap_) {
+  // Deep copy, which also turns a view into a tuple of its own.
+  if (other.data_ != nullptr) {
+    allocated_ = true;
     data_ = new char[size_];
     memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
   }
 }
 
+Tuple::Tuple(Tuple &&other) noexcept
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), data_(other.data_), heap_(other.heap_) {
+  other.allocated_ = false;
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
 auto Tuple::operator=(const Tuple &other) -> Tuple & {
-  if (allocated_) {
-    delete[] data_;
+  if (this == &other) {
+    return *this;
+  }
+  // Reuse our own buffer when the other tuple fits, so assigning rows of one size over and over allocates once.
+  if (other.data_ != nullptr && !(allocated_ && size_ >= other.size_)) {
+    if (allocated_) {
+      delete[] data_;
+    }
+    data_ = new char[other.size_];
+    allocated_ = true;
+  }
+  if (other.data_ == nullptr) {
+    if (allocated_) {
+      delete[] data_;
+    }
+    data_ = nullptr;
+    allocated_ = false;
+  } else {
+    memcpy(data_, other.data_, other.size_);
   }
-  allocated_ = other.allocated_;
   rid_ = other.rid_;
   size_ = other.size_;
+  heap_ = other.heap_;
+  return *this;
+}
 
+auto Tuple::operator=(Tuple &&other) noexcept -> Tuple & {
+  if (this == &other) {
+    return *this;
+  }
   if (allocated_) {
-    // Deep copy.
-    data_ = new char[size_];
-    memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
+    delete[] data_;
   }
-
+  allocated_ = other.allocated_;
+  rid_ = other.rid_;
+  size_ = other.size_;
+  data_ = other.data_;
+  heap_ = other.heap_;
+  other.allocated_ = false;
+  other.data_ = nullptr;
+  other.size_ = 0;
   return *this;
 }
 
@@ -99,12 +165,32 @@ auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> V
   assert(schema);
   assert(data_);
   const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  if (IsNull(schema, column_idx)) {
+    return ValueFactory::GetNullValueByType(column_type);
+  }
   const char *data_ptr = GetDataPtr(schema, column_idx);
+  if (!schema->GetColumn(column_idx).IsInlined()) {
+    uint32_t len = *reinterpret_cast<const uint32_t *>(data_ptr);
+    if (len != BUSTUB_VALUE_NULL && (len & TOAST_MASK) != 0) {
+      BUSTUB_ASSERT(heap_ != nullptr, "A toasted value can only be read through its table heap.");
+      return heap_->ReadToastedValue(data_ptr, column_type);
+    }
+  }
   // the third parameter "is_inlined" is unused
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
-auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
+auto Tuple::IsToasted(const Schema *schema) const -> bool {
+  for (auto column_idx : schema->GetUnlinedColumns()) {
+    uint32_t len = *reinterpret_cast<const uint32_t *>(GetDataPtr(schema, column_idx));
+    if (len != BUSTUB_VALUE_NULL && (len & TOAST_MASK) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
     -> Tuple {
   std::vector<Value> values;
   values.reserve(key_attrs.size());
@@ -162,13 +248,8 @@ void Tuple::SerializeTo(char *storage) const {
 void Tuple::DeserializeFrom(const char *storage) {
   uint32_t size = *reinterpret_cast<const uint32_t *>(storage);
   // Construct a tuple.
-  this->size_ = size;
-  if (this->allocated_) {
-    delete[] this->data_;
-  }
-  this->data_ = new char[this->size_];
+  Allocate(size);
   memcpy(this->data_, storage + sizeof(int32_t), this->size_);
-  this->allocated_ = true;
 }
 
 }  // namespace bustub
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.cpp
+//
+// Identification: src/type/arena_pool.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/arena_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace bustub {
+
+auto ArenaPool::Allocate(size_t size) -> void * {
+  if (bytes_used_ + size > budget_) {
+    return nullptr;
+  }
+  bytes_used_ += size;
+  return AllocateAligned(size, alignof(std::max_align_t));
+}
+
+auto ArenaPool::AllocateAligned(size_t size, size_t align) -> void * {
+  auto aligned = (reinterpret_cast<uintptr_t>(next_) + align - 1) & ~(align - 1);
+  if (next_ == nullptr || aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+    // A request larger than a block gets a block of its own. The rest of the current block is lost, which wastes
+    // little as long as requests are small next to BLOCK_SIZE.
+    auto block_size = std::max(BLOCK_SIZE, size + align);
+    blocks_.emplace_back(new char[block_size]);
+    bytes_reserved_ += block_size;
+    next_ = blocks_.back().get();
+    end_ = next_ + block_size;
+    aligned = (reinterpret_cast<uintptr_t>(next_) + align - 1) & ~(align - 1);
+  }
+  next_ = reinterpret_cast<char *>(aligned + size);
+  return reinterpret_cast<void *>(aligned);
+}
+
+}  // namespace bustub
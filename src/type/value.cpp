@@ -15,9 +15,28 @@
 #include <utility>
 
 #include "common/exception.h"
+#include "type/arena_pool.h"
 #include "type/value.h"
 
 namespace bustub {
+
+namespace {
+
+/** @return len bytes for varlen data, from the arena of this thread if it has room, and whether they came from it */
+auto AllocateVarlen(uint32_t len, bool *pooled) -> char * {
+  auto *arena = ArenaPool::Current();
+  if (arena != nullptr) {
+    if (auto *data = static_cast<char *>(arena->Allocate(len)); data != nullptr) {
+      *pooled = true;
+      return data;
+    }
+  }
+  *pooled = false;
+  return new char[len];
+}
+
+}  // namespace
+
 Value::Value(const Value &other) {
   type_id_ = other.type_id_;
   size_ = other.size_;
@@ -29,7 +48,9 @@ Value::Value(const Value &other) {
         value_.varlen_ = nullptr;
       } else {
         if (manage_data_) {
-          value_.varlen_ = new char[size_.len_];
+          // The copy comes from the arena of this thread, not necessarily the one of the other value, so that a
+          // value copied out of a query outlives it.
+          value_.varlen_ = AllocateVarlen(size_.len_, &pooled_);
           memcpy(value_.varlen_, other.value_.varlen_, size_.len_);
         } else {
           value_ = other.value_;
@@ -221,7 +242,7 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
         manage_data_ = manage_data;
         if (manage_data_) {
           assert(len < BUSTUB_VARCHAR_MAX_LEN);
-          value_.varlen_ = new char[len];
+          value_.varlen_ = AllocateVarlen(len, &pooled_);
           assert(value_.varlen_ != nullptr);
           size_.len_ = len;
           memcpy(value_.varlen_, data, len);
@@ -243,7 +264,7 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
       manage_data_ = true;
       // TODO(TAs): How to represent a null string here?
       uint32_t len = static_cast<uint32_t>(data.length()) + 1;
-      value_.varlen_ = new char[len];
+      value_.varlen_ = AllocateVarlen(len, &pooled_);
       assert(value_.varlen_ != nullptr);
       size_.len_ = len;
       memcpy(value_.varlen_, data.c_str(), len);
@@ -258,7 +279,7 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
 Value::~Value() {
   switch (type_id_) {
     case TypeId::VARCHAR:
-      if (manage_data_) {
+      if (manage_data_ && !pooled_) {
         delete[] value_.varlen_;
       }
       break;
@@ -12,11 +12,14 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -144,4 +147,75 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager.get(), k);
+
+  // Fill twice as many pages as the pool holds, so the first ones are only on disk afterwards.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: prefetched pages are read in the background, so fetching them later does not wait for the disk.
+  const size_t latency_ms = 20;
+  disk_manager->SetLatency(latency_ms);
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    EXPECT_TRUE(bpm->PrefetchPage(page_id));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms * 10));
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(latency_ms));
+
+  // Scenario: the prefetch pin keeps the pages in the pool until the caller lets go of it.
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    EXPECT_TRUE(bpm->UnpinPrefetchedPage(page_id));
+    EXPECT_FALSE(bpm->UnpinPrefetchedPage(page_id));
+  }
+
+  // Scenario: a fetch that arrives while the page is still being read waits for the read to finish.
+  EXPECT_TRUE(bpm->PrefetchPage(4));
+  auto *page = bpm->FetchPage(4);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 4", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(4, false));
+  EXPECT_TRUE(bpm->UnpinPrefetchedPage(4));
+
+  // Scenario: prefetch pins stop at half of the pool, and never take the last frame fetches could use.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size / 2); ++page_id) {
+    EXPECT_TRUE(bpm->PrefetchPage(page_id));
+  }
+  EXPECT_FALSE(bpm->PrefetchPage(buffer_pool_size / 2));
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size / 2); ++page_id) {
+    EXPECT_TRUE(bpm->UnpinPrefetchedPage(page_id));
+  }
+  std::vector<page_id_t> pinned;
+  for (size_t i = 0; i < buffer_pool_size - 1; ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(static_cast<page_id_t>(i)));
+    pinned.push_back(static_cast<page_id_t>(i));
+  }
+  EXPECT_FALSE(bpm->PrefetchPage(buffer_pool_size + 1));
+  for (auto page_id : pinned) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: ids that were never allocated are rejected.
+  EXPECT_FALSE(bpm->PrefetchPage(INVALID_PAGE_ID));
+  EXPECT_FALSE(bpm->PrefetchPage(static_cast<page_id_t>(buffer_pool_size * 4)));
+
+  delete bpm;
+}
+
 }  // namespace bustub
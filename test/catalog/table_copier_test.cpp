@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_copier_test.cpp
+//
+// Identification: test/catalog/table_copier_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "catalog/table_copier.h"
+#include "common/exception.h"
+#include "execution/executor_context.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class TableCopierTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    disk_manager_ = std::make_unique<DiskManagerUnlimitedMemory>();
+    bpm_ = std::make_unique<BufferPoolManager>(64, disk_manager_.get());
+    catalog_ = std::make_unique<Catalog>(bpm_.get(), nullptr, nullptr);
+    txn_ = std::make_unique<Transaction>(0);
+    exec_ctx_ = std::make_unique<ExecutorContext>(txn_.get(), catalog_.get(), bpm_.get(), nullptr, nullptr);
+  }
+
+  void TearDown() override { remove(FILE_NAME); }
+
+  auto CreateTable(const std::string &name) -> TableInfo * {
+    Schema schema({Column("a", TypeId::BIGINT), Column("b", TypeId::VARCHAR, 32), Column("c", TypeId::BOOLEAN)});
+    auto *table_info = catalog_->CreateTable(txn_.get(), name, schema);
+    Schema key_schema({Column("a", TypeId::BIGINT)});
+    catalog_->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(txn_.get(), name + "_a", name, schema, key_schema,
+                                                                     {0}, 8, HashFunction<GenericKey<8>>{});
+    return table_info;
+  }
+
+  static void WriteFile(const std::string &content) {
+    std::ofstream out(FILE_NAME, std::ios::binary);
+    out << content;
+  }
+
+  auto ReadRows(const TableInfo *table_info) -> std::vector<std::vector<Value>> {
+    std::vector<std::vector<Value>> rows;
+    for (auto iter = table_info->table_->Begin(txn_.get()); iter != table_info->table_->End(); ++iter) {
+      std::vector<Value> row;
+      for (uint32_t i = 0; i < table_info->schema_.GetColumnCount(); i++) {
+        row.push_back(iter->GetValue(&table_info->schema_, i));
+      }
+      rows.push_back(std::move(row));
+    }
+    return rows;
+  }
+
+  auto LookUp(const TableInfo *table_info, int64_t a) -> std::vector<RID> {
+    auto *index = catalog_->GetIndex(table_info->name_ + "_a", table_info->name_)->index_.get();
+    std::vector<RID> rids;
+    index->ScanKey(Tuple({ValueFactory::GetBigIntValue(a)}, index->GetKeySchema()), &rids, txn_.get());
+    return rids;
+  }
+
+  static constexpr const char *FILE_NAME = "table_copier_test.csv";
+
+  std::unique_ptr<DiskManagerUnlimitedMemory> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+  std::unique_ptr<Catalog> catalog_;
+  std::unique_ptr<Transaction> txn_;
+  std::unique_ptr<ExecutorContext> exec_ctx_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(TableCopierTest, CsvTest) {
+  auto *table_info = CreateTable("t");
+  WriteFile("a|b|c\n1|plain|true\n2|\"with | and \"\"quotes\"\"\"|f\n3||\n4|\"\"|t\n5|\"two\nlines\"|0\n");
+
+  TableCopier copier(exec_ctx_.get(), CopyFormat::CSV, '|', true);
+  ASSERT_EQ(5, copier.CopyFrom(table_info, FILE_NAME));
+  auto rows = ReadRows(table_info);
+  ASSERT_EQ(5, rows.size());
+  for (int64_t i = 0; i < 5; i++) {
+    EXPECT_EQ(i + 1, rows[i][0].GetAs<int64_t>());
+    ASSERT_EQ(1, LookUp(table_info, i + 1).size());
+  }
+  EXPECT_EQ("plain", rows[0][1].ToString());
+  EXPECT_EQ("with | and \"quotes\"", rows[1][1].ToString());
+  EXPECT_FALSE(rows[1][2].IsNull());
+  // an empty field is NULL unless quoted
+  EXPECT_TRUE(rows[2][1].IsNull());
+  EXPECT_TRUE(rows[2][2].IsNull());
+  EXPECT_FALSE(rows[3][1].IsNull());
+  EXPECT_EQ("", rows[3][1].ToString());
+  EXPECT_EQ("two\nlines", rows[4][1].ToString());
+
+  // what COPY TO writes, COPY FROM reads back the same
+  ASSERT_EQ(5, copier.CopyTo(table_info, FILE_NAME));
+  auto *copy_info = CreateTable("u");
+  TableCopier reader(exec_ctx_.get(), CopyFormat::CSV, '|', true);
+  ASSERT_EQ(5, reader.CopyFrom(copy_info, FILE_NAME));
+  auto copied = ReadRows(copy_info);
+  ASSERT_EQ(rows.size(), copied.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    for (size_t j = 0; j < rows[i].size(); j++) {
+      EXPECT_EQ(rows[i][j].IsNull(), copied[i][j].IsNull()) << i << " " << j;
+      EXPECT_EQ(rows[i][j].ToString(), copied[i][j].ToString()) << i << " " << j;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableCopierTest, ErrorTest) {
+  auto *table_info = CreateTable("t");
+  TableCopier copier(exec_ctx_.get(), CopyFormat::CSV, ',', false);
+  auto expect_error = [&](const std::string &content, const std::string &message) {
+    WriteFile(content);
+    try {
+      copier.CopyFrom(table_info, FILE_NAME);
+      FAIL() << "no error for " << content;
+    } catch (const Exception &e) {
+      EXPECT_NE(std::string::npos, std::string(e.what()).find(message)) << e.what();
+    }
+  };
+  expect_error("1,a,t\n2,b\n", "line 2: expected 3 fields, found 2");
+  expect_error("1,\"a\nb\",t\nx,b,t\n", "line 3: invalid integer \"x\"");
+  expect_error("1,a,t,4\n", "line 1: more than 3 fields");
+  expect_error("1,a,maybe\n", "line 1: invalid boolean \"maybe\"");
+  expect_error("1,\"a,t\n", "unterminated quoted field");
+  expect_error("1,\"a\"b,t\n", "unexpected character after quoted field");
+  EXPECT_THROW(copier.CopyFrom(table_info, "table_copier_test.missing"), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableCopierTest, ParallelTest) {
+  auto *table_info = CreateTable("t");
+  // enough lines for several chunks, with quoted newlines across chunk boundaries
+  const int64_t num_rows = 150000;
+  std::string content;
+  for (int64_t i = 0; i < num_rows; i++) {
+    content += std::to_string(i) + (i % 7 == 0 ? ",\"row\n" : ",row") + std::to_string(i % 1000) +
+               (i % 7 == 0 ? "\"" : "") + (i % 2 == 0 ? ",t\n" : ",f\n");
+  }
+  ASSERT_GT(content.size(), 2 * TableCopier::CHUNK_SIZE);
+  WriteFile(content);
+
+  TableCopier copier(exec_ctx_.get(), CopyFormat::CSV, ',', false, 4);
+  ASSERT_EQ(num_rows, copier.CopyFrom(table_info, FILE_NAME));
+  // rows land in file order
+  int64_t i = 0;
+  for (const auto &row : ReadRows(table_info)) {
+    ASSERT_EQ(i, row[0].GetAs<int64_t>());
+    ASSERT_EQ((i % 7 == 0 ? "row\n" : "row") + std::to_string(i % 1000), row[1].ToString());
+    ASSERT_EQ(i % 2 == 0, row[2].GetAs<bool>());
+    i++;
+  }
+  EXPECT_EQ(num_rows, i);
+  for (int64_t key = 0; key < num_rows; key += 997) {
+    EXPECT_EQ(1, LookUp(table_info, key).size()) << key;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableCopierTest, BinaryTest) {
+  auto *table_info = CreateTable("t");
+  WriteFile("1,x,t\n2,,\n3,\"\",f\n");
+  TableCopier csv(exec_ctx_.get(), CopyFormat::CSV, ',', false);
+  ASSERT_EQ(3, csv.CopyFrom(table_info, FILE_NAME));
+
+  TableCopier binary(exec_ctx_.get(), CopyFormat::BINARY, ',', false);
+  ASSERT_EQ(3, binary.CopyTo(table_info, FILE_NAME));
+  auto *copy_info = CreateTable("u");
+  ASSERT_EQ(3, binary.CopyFrom(copy_info, FILE_NAME));
+  auto rows = ReadRows(table_info);
+  auto copied = ReadRows(copy_info);
+  ASSERT_EQ(rows.size(), copied.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    for (size_t j = 0; j < rows[i].size(); j++) {
+      EXPECT_EQ(rows[i][j].IsNull(), copied[i][j].IsNull()) << i << " " << j;
+      EXPECT_EQ(rows[i][j].ToString(), copied[i][j].ToString()) << i << " " << j;
+    }
+  }
+  EXPECT_EQ(1, LookUp(copy_info, 3).size());
+
+  // a file of another table's columns does not load
+  Schema schema({Column("a", TypeId::INTEGER)});
+  auto *other_info = catalog_->CreateTable(txn_.get(), "v", schema);
+  EXPECT_THROW(binary.CopyFrom(other_info, FILE_NAME), Exception);
+
+  // nor does a tuple whose variable-length value reaches past its end
+  std::string content;
+  {
+    std::ifstream in(FILE_NAME, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  auto first_tuple = 10 + sizeof(uint32_t) + table_info->schema_.GetColumnCount() + sizeof(uint32_t);
+  auto varlen_offset = first_tuple + table_info->schema_.GetColumn(1).GetOffset();
+  auto corrupt = content;
+  uint32_t offset;
+  memcpy(&offset, &corrupt[varlen_offset], sizeof(uint32_t));
+  uint32_t len = 1000;
+  memcpy(&corrupt[first_tuple + offset], &len, sizeof(uint32_t));
+  WriteFile(corrupt);
+  EXPECT_THROW(binary.CopyFrom(copy_info, FILE_NAME), Exception);
+  corrupt = content;
+  offset = 1U << 20;
+  memcpy(&corrupt[varlen_offset], &offset, sizeof(uint32_t));
+  WriteFile(corrupt);
+  EXPECT_THROW(binary.CopyFrom(copy_info, FILE_NAME), Exception);
+  EXPECT_EQ(3, ReadRows(copy_info).size());
+}
+
+}  // namespace bustub
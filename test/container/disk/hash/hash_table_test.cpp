@@ -10,10 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
 #include "common/logger.h"
 #include "container/disk/hash/disk_extendible_hash_table.h"
 #include "gtest/gtest.h"
@@ -24,7 +27,7 @@ namespace bustub {
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +120,195 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, GrowShrinkTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  // a single directory page, so that it has to grow deep
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>(), false, 0);
+
+  // enough pairs to split buckets many times over
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    if (i % 3 == 0) {
+      ASSERT_TRUE(ht.Insert(nullptr, i, -i - 1));
+    }
+  }
+  ht.VerifyIntegrity();
+  EXPECT_GT(ht.GetGlobalDepth(), 4);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(i % 3 == 0 ? 2 : 1, res.size());
+  }
+
+  // emptied buckets merge back and the directory shrinks with them
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+    if (i % 3 == 0) {
+      ASSERT_TRUE(ht.Remove(nullptr, i, -i - 1));
+    }
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 0, &res));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, UniqueTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>(), true);
+
+  for (int i = 0; i < 2000; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 2000; i++) {
+    EXPECT_FALSE(ht.Insert(nullptr, i, i + 1));
+  }
+  ASSERT_TRUE(ht.Remove(nullptr, 7, 7));
+  EXPECT_TRUE(ht.Insert(nullptr, 7, 8));
+  std::vector<int> res;
+  ASSERT_TRUE(ht.GetValue(nullptr, 7, &res));
+  EXPECT_EQ(std::vector<int>{8}, res);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, OverflowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // one key with more values than three buckets hold, among keys that make its bucket split
+  const int num_values = 3 * BUSTUB_PAGE_SIZE / sizeof(std::pair<int, int>);
+  for (int i = 0; i < num_values; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, 7, i));
+    if (i % 2 == 0) {
+      ASSERT_TRUE(ht.Insert(nullptr, 1000 + i, i));
+    }
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 7, 0));
+  ht.VerifyIntegrity();
+  std::vector<int> res;
+  ASSERT_TRUE(ht.GetValue(nullptr, 7, &res));
+  std::sort(res.begin(), res.end());
+  ASSERT_EQ(num_values, res.size());
+  for (int i = 0; i < num_values; i++) {
+    ASSERT_EQ(i, res[i]);
+  }
+
+  // removes empty the overflow pages again
+  for (int i = 0; i < num_values; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, 7, i));
+    if (i % 2 == 0) {
+      res.clear();
+      ASSERT_TRUE(ht.GetValue(nullptr, 1000 + i, &res));
+      ASSERT_EQ(std::vector<int>{i}, res);
+    }
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, 7, &res));
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+
+  // every thread inserts its own keys and reads them back, then removes half of them, splitting and merging buckets
+  // under the others
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<int> res;
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        ASSERT_TRUE(ht.Insert(nullptr, i, i));
+        res.clear();
+        ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+        ASSERT_EQ(std::vector<int>{i}, res);
+      }
+      for (int i = t; i < num_threads * keys_per_thread; i += 2 * num_threads) {
+        ASSERT_TRUE(ht.Remove(nullptr, i, i));
+        res.clear();
+        ASSERT_FALSE(ht.GetValue(nullptr, i, &res));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % (2 * num_threads) >= num_threads, ht.GetValue(nullptr, i, &res)) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MultiDirectoryTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  Schema key_schema({Column("key", TypeId::BIGINT)});
+  DiskExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>> ht(
+      "blah", bpm, GenericComparator<64>(&key_schema), HashFunction<GenericKey<64>>());
+
+  // more pairs than the buckets of one full directory page can hold
+  const int bucket_size = 4 * BUSTUB_PAGE_SIZE / (4 * sizeof(std::pair<GenericKey<64>, RID>) + 1);
+  const int num_keys = DIRECTORY_ARRAY_SIZE * (bucket_size + 10);
+  GenericKey<64> key;
+  for (int i = 0; i < num_keys; i++) {
+    key.SetFromInteger(i);
+    ASSERT_TRUE(ht.Insert(nullptr, key, RID(i, 0))) << i;
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<RID> res;
+    key.SetFromInteger(i);
+    ASSERT_TRUE(ht.GetValue(nullptr, key, &res)) << i;
+    EXPECT_EQ(std::vector<RID>{RID(i, 0)}, res);
+  }
+  for (int i = 0; i < num_keys; i += 2) {
+    key.SetFromInteger(i);
+    ASSERT_TRUE(ht.Remove(nullptr, key, RID(i, 0)));
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<RID> res;
+    key.SetFromInteger(i);
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, key, &res)) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    ASSERT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+  }
+  // a pair can only be in the table once
+  EXPECT_FALSE(ht.Insert(nullptr, 3, 3));
+
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{i, 2 * i + 1}), res);
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    res.clear();
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>{2 * i + 1}, res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // grow through several resizes, checking that nothing gets lost while pairs move between the arrays
+  const int num_keys = 40000;
+  size_t size = ht.GetSize();
+  int resizes = 0;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    if (ht.GetSize() != size) {
+      size = ht.GetSize();
+      resizes++;
+      for (int j = 0; j <= i; j++) {
+        std::vector<int> res;
+        ASSERT_TRUE(ht.GetValue(nullptr, j, &res)) << j;
+        EXPECT_EQ(std::vector<int>{j}, res);
+      }
+    }
+  }
+  EXPECT_GE(resizes, 5);
+  EXPECT_GE(ht.GetSize(), num_keys * 2);
+
+  // removes move pairs too, and leave tombstones that the probes have to step over
+  for (int i = 0; i < num_keys; i += 2) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res)) << i;
+  }
+
+  // an explicit resize moves the pairs incrementally as well
+  ht.Resize(ht.GetSize());
+  for (int i = 0; i < num_keys; i += 2) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,330 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index_test.cpp
+//
+// Identification: test/storage/art_index_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/art.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// 8 byte big endian keys, so that some of them share long prefixes
+auto IntKey(uint64_t key) -> ARTKey {
+  ARTKey out;
+  for (int i = 7; i >= 0; i--) {
+    out.push_back(static_cast<char>((key >> (8 * i)) & 0xff));
+  }
+  return out;
+}
+
+// terminated keys of different lengths, most of them with a common part longer than a node keeps
+auto StringKey(int key) -> ARTKey {
+  auto out = key % 5 == 0 ? std::to_string(key) : "a_rather_long_common_prefix/" + std::to_string(key);
+  out.push_back(0);
+  return out;
+}
+
+// Read the whole tree and a few ranges both ways, and compare with the expected contents.
+void CheckTree(AdaptiveRadixTree *tree, const std::map<ARTKey, std::vector<RID>> &expected) {
+  std::vector<RID> rids;
+  for (const auto &[key, values] : expected) {
+    rids.clear();
+    ASSERT_TRUE(tree->GetValue(key, &rids));
+    EXPECT_EQ(rids, values);
+  }
+
+  std::vector<std::pair<ARTKey, RID>> entries;
+  for (const auto &[key, values] : expected) {
+    for (const auto &rid : values) {
+      entries.emplace_back(key, rid);
+    }
+  }
+  size_t i = 0;
+  for (ARTIterator it(tree, std::nullopt, std::nullopt, false); !it.IsEnd(); ++it, i++) {
+    ASSERT_LT(i, entries.size());
+    EXPECT_EQ((*it).first, entries[i].first);
+    EXPECT_EQ((*it).second, entries[i].second);
+  }
+  EXPECT_EQ(i, entries.size());
+  for (ARTIterator it(tree, std::nullopt, std::nullopt, true); !it.IsEnd(); ++it) {
+    ASSERT_GT(i, 0);
+    i--;
+    EXPECT_EQ((*it).first, entries[i].first);
+    EXPECT_EQ((*it).second, entries[i].second);
+  }
+  EXPECT_EQ(i, 0);
+
+  if (expected.empty()) {
+    return;
+  }
+  // ranges from and to keys that are in the tree as well as keys that are not
+  std::vector<ARTKey> bounds;
+  size_t step = 0;
+  for (const auto &[key, values] : expected) {
+    if (step++ % (expected.size() / 8 + 1) == 0) {
+      bounds.push_back(key);
+      bounds.push_back(key + '\x7f');
+    }
+  }
+  for (size_t b = 0; b + 1 < bounds.size(); b++) {
+    const auto &low = bounds[b];
+    const auto &high = bounds[bounds.size() - 1 - b / 2];
+    std::vector<ARTKey> want;
+    for (auto it = expected.lower_bound(low); it != expected.end() && it->first <= high; ++it) {
+      for (size_t v = 0; v < it->second.size(); v++) {
+        want.push_back(it->first);
+      }
+    }
+    std::vector<ARTKey> got;
+    for (ARTIterator it(tree, low, high, false); !it.IsEnd(); ++it) {
+      got.push_back((*it).first);
+    }
+    EXPECT_EQ(got, want);
+    got.clear();
+    for (ARTIterator it(tree, high, low, true); !it.IsEnd(); ++it) {
+      got.push_back((*it).first);
+    }
+    std::reverse(want.begin(), want.end());
+    EXPECT_EQ(got, want);
+  }
+}
+
+}  // namespace
+
+TEST(ARTTests, InsertRemoveTest) {
+  for (bool string_keys : {false, true}) {
+    AdaptiveRadixTree tree;
+    std::map<ARTKey, std::vector<RID>> expected;
+    std::mt19937_64 rng(15445);
+    std::vector<ARTKey> keys;
+    for (int i = 0; i < 5000; i++) {
+      // clustered integers fill whole nodes, scattered ones leave long paths
+      keys.push_back(string_keys ? StringKey(i) : IntKey(i % 2 == 0 ? i / 2 : rng()));
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < keys.size(); i++) {
+      RID rid(static_cast<page_id_t>(i), 0);
+      ASSERT_TRUE(tree.Insert(keys[i], rid));
+      expected[keys[i]] = {rid};
+    }
+    // unique keys
+    EXPECT_FALSE(tree.Insert(keys[0], RID(100000, 0)));
+    CheckTree(&tree, expected);
+
+    // remove most keys, so that nodes shrink and paths collapse
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (i % 10 != 0) {
+        EXPECT_TRUE(tree.Remove(keys[i], expected[keys[i]][0]));
+        expected.erase(keys[i]);
+      }
+    }
+    EXPECT_FALSE(tree.Remove(keys[1]));
+    EXPECT_FALSE(tree.Remove(keys[0], RID(100000, 0)));
+    std::vector<RID> rids;
+    EXPECT_FALSE(tree.GetValue(keys[1], &rids));
+    CheckTree(&tree, expected);
+
+    for (const auto &[key, values] : expected) {
+      EXPECT_TRUE(tree.Remove(key));
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+  }
+}
+
+TEST(ARTTests, DuplicateKeyTest) {
+  AdaptiveRadixTree tree(false);
+  std::map<ARTKey, std::vector<RID>> expected;
+  for (int i = 0; i < 3000; i++) {
+    auto key = IntKey(i % 100);
+    RID rid(i, i % 7);
+    ASSERT_TRUE(tree.Insert(key, rid));
+    expected[key].push_back(rid);
+  }
+  // a pair can only be in the tree once
+  EXPECT_FALSE(tree.Insert(IntKey(5), RID(5, 5)));
+  CheckTree(&tree, expected);
+
+  for (int i = 0; i < 3000; i += 3) {
+    auto key = IntKey(i % 100);
+    ASSERT_TRUE(tree.Remove(key, RID(i, i % 7)));
+    auto &values = expected[key];
+    values.erase(std::find(values.begin(), values.end(), RID(i, i % 7)));
+  }
+  CheckTree(&tree, expected);
+}
+
+TEST(ARTTests, BulkLoadTest) {
+  for (bool unique : {true, false}) {
+    AdaptiveRadixTree tree(unique);
+    std::map<ARTKey, std::vector<RID>> expected;
+    std::vector<std::pair<ARTKey, RID>> entries;
+    for (int i = 0; i < 4000; i++) {
+      auto key = StringKey(i % 1500);
+      RID rid(i, 0);
+      entries.emplace_back(key, rid);
+      if (!unique || expected.count(key) == 0) {
+        expected[key].push_back(rid);
+      }
+    }
+    std::shuffle(entries.begin(), entries.end(), std::mt19937(15445));
+    if (unique) {
+      // a repeated key fails the whole load, so only the first entry of each key is loaded
+      ASSERT_FALSE(tree.BulkLoad(entries));
+      ASSERT_TRUE(tree.IsEmpty());
+      expected.clear();
+      std::vector<std::pair<ARTKey, RID>> firsts;
+      for (const auto &[key, rid] : entries) {
+        if (expected.emplace(key, std::vector<RID>{rid}).second) {
+          firsts.emplace_back(key, rid);
+        }
+      }
+      entries = std::move(firsts);
+    }
+    ASSERT_TRUE(tree.BulkLoad(entries));
+    CheckTree(&tree, expected);
+
+    // the loaded tree takes changes like any other
+    for (int i = 0; i < 1500; i += 2) {
+      tree.Remove(StringKey(i));
+      expected.erase(StringKey(i));
+    }
+    for (int i = 5000; i < 5500; i++) {
+      tree.Insert(StringKey(i), RID(i, 0));
+      expected[StringKey(i)] = {RID(i, 0)};
+    }
+    CheckTree(&tree, expected);
+  }
+}
+
+TEST(ARTTests, ConcurrentTest) {
+  AdaptiveRadixTree tree;
+  const int num_threads = 4;
+  const int keys_per_thread = 20000;
+
+  // every thread inserts its own keys, then removes half of them, while all of them read each other's keys
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      std::vector<RID> rids;
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        ASSERT_TRUE(tree.Insert(IntKey(i), RID(i, 0)));
+        rids.clear();
+        ASSERT_TRUE(tree.GetValue(IntKey(i), &rids));
+        tree.GetValue(IntKey(rng() % (num_threads * keys_per_thread)), &rids);
+      }
+      for (int i = t; i < num_threads * keys_per_thread; i += 2 * num_threads) {
+        ASSERT_TRUE(tree.Remove(IntKey(i)));
+        size_t scanned = 0;
+        for (ARTIterator it(&tree, IntKey(rng() % (num_threads * keys_per_thread)), std::nullopt, false);
+             !it.IsEnd() && scanned < 10; ++it) {
+          scanned++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::map<ARTKey, std::vector<RID>> expected;
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    if (i % (2 * num_threads) >= num_threads) {
+      expected[IntKey(i)] = {RID(i, 0)};
+    }
+  }
+  CheckTree(&tree, expected);
+}
+
+TEST(ARTTests, NormalizeKeyTest) {
+  auto table_schema = ParseCreateStatement("a integer,b varchar,c bigint");
+  auto key_schema = ParseCreateStatement("a integer,b varchar");
+  ARTIndex index(std::make_unique<IndexMetadata>("art", "t", table_schema.get(), std::vector<uint32_t>{0, 1}));
+
+  // keys in increasing order
+  std::vector<std::pair<int32_t, std::string>> keys{
+      {-100000, "x"}, {-1, ""}, {-1, std::string(1, '\0')}, {-1, "a"}, {-1, std::string("a\0b", 3)},
+      {-1, "ab"},     {0, "zz"}, {1, "a"},                     {70000, "a"}};
+  std::vector<ARTKey> normalized;
+  for (const auto &[a, b] : keys) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(b)};
+    normalized.push_back(index.NormalizeKey(Tuple(values, key_schema.get())));
+  }
+  for (size_t i = 0; i + 1 < normalized.size(); i++) {
+    EXPECT_LT(normalized[i], normalized[i + 1]) << i;
+    EXPECT_NE(normalized[i + 1].compare(0, normalized[i].size(), normalized[i]), 0) << "prefix at " << i;
+  }
+}
+
+TEST(ARTTests, DISABLED_LookupBenchmark) {  // NOLINT
+  // point lookups on one integer column through both index types, as the executors issue them
+  auto table_schema = ParseCreateStatement("a integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(4096, disk_manager.get());
+  ARTIndex art(std::make_unique<IndexMetadata>("art", "t", table_schema.get(), std::vector<uint32_t>{0}));
+  BPlusTreeIndexForOneIntegerColumn btree(
+      std::make_unique<IndexMetadata>("btree", "t", table_schema.get(), std::vector<uint32_t>{0}), bpm.get());
+
+  const int num_keys = 1000000;
+  const int num_lookups = 1000000;
+  std::vector<int> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  auto key_of = [&](int k) { return Tuple({ValueFactory::GetIntegerValue(k)}, art.GetKeySchema()); };
+  for (int k : keys) {
+    ASSERT_TRUE(art.InsertEntry(key_of(k), RID(k, 0), nullptr));
+    ASSERT_TRUE(btree.InsertEntry(key_of(k), RID(k, 0), nullptr));
+  }
+  std::vector<Tuple> probes;
+  probes.reserve(num_lookups);
+  for (int i = 0; i < num_lookups; i++) {
+    probes.push_back(key_of(static_cast<int>(rng() % num_keys)));
+  }
+
+  auto time_ms = [&](Index *index) {
+    std::vector<RID> rids;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &probe : probes) {
+      rids.clear();
+      index->ScanKey(probe, &rids, nullptr);
+      ASSERT_EQ(1, rids.size());
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << index->GetName() << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms" << std::endl;
+  };
+  std::cout << num_lookups << " point lookups over " << num_keys << " keys" << std::endl;
+  time_ms(&art);
+  time_ms(&btree);
+}
+
+}  // namespace bustub
@@ -122,7 +122,7 @@ void LookupHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, con
   delete transaction;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
+TEST(BPlusTreeConcurrentTest, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -170,7 +170,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
+TEST(BPlusTreeConcurrentTest, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -217,7 +217,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
+TEST(BPlusTreeConcurrentTest, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -256,7 +256,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
+TEST(BPlusTreeConcurrentTest, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -295,7 +295,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest1) {
+TEST(BPlusTreeConcurrentTest, MixTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -336,7 +336,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest2) {
+TEST(BPlusTreeConcurrentTest, MixTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -402,4 +402,184 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest2) {
   delete bpm;
 }
 
+TEST(BPlusTreeConcurrentTest, MixTest3) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // tiny pages, so that writers keep falling back from leaf-only latching to latch crabbing
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 3, 4);
+
+  // every thread inserts its own stripe of keys, then removes the odd ones
+  int64_t total_keys = 2000;
+  size_t num_threads = 4;
+  std::vector<int64_t> keys;
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key <= total_keys; key++) {
+    keys.push_back(key);
+    if (key % 2 == 1) {
+      odd_keys.push_back(key);
+    }
+  }
+  LaunchParallelTest(num_threads, InsertHelperSplit, &tree, keys, num_threads);
+  LaunchParallelTest(num_threads, DeleteHelperSplit, &tree, odd_keys, num_threads);
+
+  int64_t expected = 2;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ((*iter).first.ToString(), expected);
+    expected += 2;
+  }
+  ASSERT_EQ(expected, total_keys + 2);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, MixTest4) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // tiny pages, so that lookups and scans keep running into splits that have not reached the parent yet
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 3, 4);
+
+  // every tenth key is there from the start; the others are inserted while readers look for the first ones
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  int64_t total_keys = 1000;
+  for (int64_t key = 1; key <= total_keys; key++) {
+    if (key % 10 == 0) {
+      perserved_keys.push_back(key);
+    } else {
+      dynamic_keys.push_back(key);
+    }
+  }
+  InsertHelper(&tree, perserved_keys);
+
+  size_t num_inserters = 6;
+  auto insert_task = [&](int tid) { InsertHelperSplit(&tree, dynamic_keys, num_inserters, tid); };
+  auto lookup_task = [&](int tid) { LookupHelper(&tree, perserved_keys, tid); };
+  auto scan_task = [&](int tid) {
+    for (int round = 0; round < 5; round++) {
+      int64_t previous = 0;
+      size_t found = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        int64_t key = (*iter).first.ToString();
+        ASSERT_GT(key, previous);
+        previous = key;
+        found += key % 10 == 0 ? 1 : 0;
+      }
+      ASSERT_EQ(found, perserved_keys.size());
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_inserters; i++) {
+    threads.emplace_back(insert_task, i);
+  }
+  for (size_t i = 0; i < 4; i++) {
+    threads.emplace_back(lookup_task, i);
+    threads.emplace_back(scan_task, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int64_t expected = 1;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ((*iter).first.ToString(), expected);
+    expected++;
+  }
+  ASSERT_EQ(expected, total_keys + 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, MixTest5) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // tiny pages, so that reverse scans keep meeting splits and merges of the leaf to their left
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 3, 4);
+
+  // every tenth key stays; the others are inserted and then removed again while reverse scans run
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  int64_t total_keys = 1000;
+  for (int64_t key = 1; key <= total_keys; key++) {
+    if (key % 10 == 0) {
+      perserved_keys.push_back(key);
+    } else {
+      dynamic_keys.push_back(key);
+    }
+  }
+  InsertHelper(&tree, perserved_keys);
+
+  size_t num_writers = 4;
+  auto write_task = [&](int tid) {
+    InsertHelperSplit(&tree, dynamic_keys, num_writers, tid);
+    DeleteHelperSplit(&tree, dynamic_keys, num_writers, tid);
+  };
+  auto reverse_scan_task = [&](int tid) {
+    GenericKey<8> start_key;
+    start_key.SetFromInteger(total_keys - 100 * tid);
+    for (int round = 0; round < 5; round++) {
+      int64_t previous = total_keys + 1;
+      size_t found = 0;
+      for (auto iter = tree.RBegin(start_key); iter != tree.End(); ++iter) {
+        int64_t key = (*iter).first.ToString();
+        ASSERT_LT(key, previous);
+        previous = key;
+        found += key % 10 == 0 ? 1 : 0;
+      }
+      ASSERT_EQ(found, perserved_keys.size() - 10 * tid);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_writers; i++) {
+    threads.emplace_back(write_task, i);
+    threads.emplace_back(reverse_scan_task, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int64_t expected = total_keys;
+  for (auto iter = tree.RBegin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ((*iter).first.ToString(), expected);
+    expected -= 10;
+  }
+  ASSERT_EQ(expected, 0);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 }  // namespace bustub
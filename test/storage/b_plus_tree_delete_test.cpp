@@ -23,7 +23,7 @@ namespace bustub {
 
 using bustub::DiskManagerUnlimitedMemory;
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -90,7 +90,7 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -156,4 +156,66 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, LazyMergeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  auto *transaction = new Transaction(0);
+  GenericKey<8> index_key;
+
+  // Delete and reinsert every other key of a full tree a few times, once with each merge policy.
+  auto churn = [&](bool lazy_merge) {
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4,
+                                                             4);
+    tree.SetLazyMerge(lazy_merge);
+    const int64_t num_keys = 200;
+    for (int64_t key = 0; key < num_keys; key++) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key), transaction);
+    }
+    for (int round = 0; round < 3; round++) {
+      for (int64_t key = round % 2; key < num_keys; key += 2) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, transaction);
+      }
+      for (int64_t key = round % 2; key < num_keys; key += 2) {
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, RID(0, key), transaction);
+      }
+    }
+
+    // leave most leaves underfull, then let compaction rebalance them
+    for (int64_t key = 0; key < num_keys; key++) {
+      if (key % 10 != 0) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, transaction);
+      }
+    }
+    int fixed = tree.Compact();
+    EXPECT_EQ(fixed > 0, lazy_merge);
+    EXPECT_EQ(tree.Compact(), 0);
+
+    int64_t expected = 0;
+    for (auto it = tree.Begin(); !it.IsEnd(); ++it, expected += 10) {
+      EXPECT_EQ((*it).first.ToString(), expected);
+    }
+    EXPECT_EQ(expected, num_keys);
+    bpm->UnpinPage(page_id, true);
+    return tree.GetStats();
+  };
+
+  auto eager = churn(false);
+  auto lazy = churn(true);
+  EXPECT_GT(eager.merges_ + eager.redistributions_, 0);
+  EXPECT_LT(lazy.splits_, eager.splits_);
+  EXPECT_LT(lazy.merges_ + lazy.redistributions_, eager.merges_ + eager.redistributions_);
+
+  delete transaction;
+  delete bpm;
+}
 }  // namespace bustub
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_duplicate_key_test.cpp
+//
+// Identification: test/storage/b_plus_tree_duplicate_key_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+auto SortedRids(std::vector<RID> rids) -> std::vector<RID> {
+  std::sort(rids.begin(), rids.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+  return rids;
+}
+
+// Walk the whole tree both ways and compare with the expected (key, rids) pairs.
+void CheckIteration(Tree *tree, const std::map<int64_t, std::vector<RID>> &expected) {
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (const auto &[key, rids] : expected) {
+    for (const auto &rid : SortedRids(rids)) {
+      entries.emplace_back(key, rid);
+    }
+  }
+
+  size_t i = 0;
+  for (auto it = tree->Begin(); !it.IsEnd(); ++it, i++) {
+    ASSERT_LT(i, entries.size());
+    EXPECT_EQ((*it).first.ToString(), entries[i].first);
+    EXPECT_EQ((*it).second, entries[i].second);
+  }
+  EXPECT_EQ(i, entries.size());
+
+  i = entries.size();
+  for (auto it = tree->RBegin(); !it.IsEnd(); ++it) {
+    ASSERT_GT(i, 0);
+    i--;
+    EXPECT_EQ((*it).first.ToString(), entries[i].first);
+    EXPECT_EQ((*it).second, entries[i].second);
+  }
+  EXPECT_EQ(i, 0);
+}
+
+}  // namespace
+
+TEST(BPlusTreeTests, DuplicateKeyTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // small pages, so that keys with posting lists move around in splits and merges
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 5, false);
+  ASSERT_FALSE(tree.IsUnique());
+  auto *transaction = new Transaction(0);
+  GenericKey<8> index_key;
+
+  // key k has k % 4 + 1 rows, and key 7 has enough rows to fill several posting pages
+  std::map<int64_t, std::vector<RID>> expected;
+  std::vector<std::pair<int64_t, RID>> pairs;
+  int32_t next_rid = 0;
+  for (int64_t key = 0; key < 40; key++) {
+    int rows = key == 7 ? 2000 : static_cast<int>(key % 4 + 1);
+    for (int i = 0; i < rows; i++) {
+      RID rid(next_rid / 100, next_rid % 100);
+      next_rid++;
+      expected[key].push_back(rid);
+      pairs.emplace_back(key, rid);
+    }
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(pairs.begin(), pairs.end(), rng);
+  for (const auto &[key, rid] : pairs) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+
+  // a pair can only be in the tree once
+  for (int64_t key : {0, 3, 7}) {
+    index_key.SetFromInteger(key);
+    EXPECT_FALSE(tree.Insert(index_key, expected[key][0], transaction));
+  }
+
+  std::vector<RID> rids;
+  for (const auto &[key, key_rids] : expected) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids, SortedRids(key_rids));
+  }
+  CheckIteration(&tree, expected);
+
+  // a range scan starts at the first row of its first key and ends after the last row of its stop key
+  GenericKey<8> stop_key;
+  index_key.SetFromInteger(6);
+  stop_key.SetFromInteger(8);
+  size_t scanned = 0;
+  for (auto it = tree.Begin(index_key, stop_key); !it.IsEnd(); ++it) {
+    scanned++;
+  }
+  EXPECT_EQ(scanned, expected[6].size() + expected[7].size() + expected[8].size());
+
+  // removing a pair leaves the other rows of its key in place
+  auto remove = [&](int64_t key, RID rid) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, rid, transaction);
+    auto &key_rids = expected[key];
+    key_rids.erase(std::find(key_rids.begin(), key_rids.end(), rid));
+    if (key_rids.empty()) {
+      expected.erase(key);
+    }
+  };
+  // a row that is not in the tree is left alone
+  index_key.SetFromInteger(1);
+  tree.Remove(index_key, RID(1000, 0), transaction);
+  index_key.SetFromInteger(7);
+  tree.Remove(index_key, RID(1000, 0), transaction);
+
+  for (int64_t key = 0; key < 40; key += 2) {
+    while (expected.count(key) > 0 && expected[key].size() > (key % 3 == 0 ? 0 : 1)) {
+      remove(key, expected[key].front());
+    }
+  }
+  auto hot = expected[7];
+  std::shuffle(hot.begin(), hot.end(), rng);
+  for (size_t i = 0; i + 3 < hot.size(); i++) {
+    remove(7, hot[i]);
+  }
+  for (const auto &[key, key_rids] : expected) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids, SortedRids(key_rids));
+  }
+  for (int64_t key = 0; key < 40; key += 6) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+  CheckIteration(&tree, expected);
+
+  // empty the tree
+  while (!expected.empty()) {
+    auto &[key, key_rids] = *expected.begin();
+    remove(key, key_rids.back());
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, DuplicateKeyRemoveKeyTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 5, false);
+  auto *transaction = new Transaction(0);
+  GenericKey<8> index_key;
+
+  for (int64_t key = 0; key < 10; key++) {
+    index_key.SetFromInteger(key);
+    for (int32_t i = 0; i < 600; i++) {
+      tree.Insert(index_key, RID(static_cast<int32_t>(key), i), transaction);
+    }
+  }
+  // removing a key drops all of its rows
+  for (int64_t key = 0; key < 10; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < 10; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 1);
+    EXPECT_EQ(rids.size(), key % 2 == 1 ? 600 : 0);
+  }
+
+  // a removed key starts over with a single row
+  index_key.SetFromInteger(4);
+  ASSERT_TRUE(tree.Insert(index_key, RID(4, 1000), transaction));
+  rids.clear();
+  ASSERT_TRUE(tree.GetValue(index_key, &rids));
+  ASSERT_EQ(rids.size(), 1);
+  EXPECT_EQ(rids[0], RID(4, 1000));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -23,7 +24,7 @@ namespace bustub {
 
 using bustub::DiskManagerUnlimitedMemory;
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -62,7 +63,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -120,7 +121,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -184,4 +185,96 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, InsertTest4) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+
+  // create b+ tree with small pages, so iterators cross many leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  GenericKey<8> stop_key;
+  RID rid;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  EXPECT_TRUE(tree.RBegin() == tree.End());
+
+  // even keys from 2 to 200, inserted out of order
+  std::vector<int64_t> keys;
+  for (int64_t key = 2; key <= 200; key += 2) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  auto collect = [](auto iterator, auto end) {
+    std::vector<int64_t> result;
+    for (; iterator != end; ++iterator) {
+      result.push_back((*iterator).first.ToString());
+    }
+    return result;
+  };
+  auto expected_range = [](int64_t from, int64_t to, int64_t step) {
+    std::vector<int64_t> result;
+    for (int64_t key = from; step > 0 ? key <= to : key >= to; key += step) {
+      result.push_back(key);
+    }
+    return result;
+  };
+
+  // full reverse scan
+  EXPECT_EQ(collect(tree.RBegin(), tree.End()), expected_range(200, 2, -2));
+
+  // reverse scan from a present and from an absent key
+  index_key.SetFromInteger(100);
+  EXPECT_EQ(collect(tree.RBegin(index_key), tree.End()), expected_range(100, 2, -2));
+  index_key.SetFromInteger(101);
+  EXPECT_EQ(collect(tree.RBegin(index_key), tree.End()), expected_range(100, 2, -2));
+  index_key.SetFromInteger(1000);
+  EXPECT_EQ(collect(tree.RBegin(index_key), tree.End()), expected_range(200, 2, -2));
+  index_key.SetFromInteger(1);
+  EXPECT_TRUE(tree.RBegin(index_key) == tree.End());
+
+  // bounded scans in both directions, stop keys inclusive
+  index_key.SetFromInteger(11);
+  stop_key.SetFromInteger(40);
+  EXPECT_EQ(collect(tree.Begin(index_key, stop_key), tree.End()), expected_range(12, 40, 2));
+  stop_key.SetFromInteger(41);
+  EXPECT_EQ(collect(tree.Begin(index_key, stop_key), tree.End()), expected_range(12, 40, 2));
+  stop_key.SetFromInteger(11);
+  EXPECT_TRUE(tree.Begin(index_key, stop_key) == tree.End());
+
+  index_key.SetFromInteger(151);
+  stop_key.SetFromInteger(99);
+  EXPECT_EQ(collect(tree.RBegin(index_key, stop_key), tree.End()), expected_range(150, 100, -2));
+  stop_key.SetFromInteger(152);
+  EXPECT_TRUE(tree.RBegin(index_key, stop_key) == tree.End());
+
+  // the back links are kept up to date by merges too
+  for (int64_t key = 2; key <= 200; key += 4) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  EXPECT_EQ(collect(tree.RBegin(), tree.End()), expected_range(200, 4, -4));
+  index_key.SetFromInteger(3);
+  EXPECT_TRUE(tree.RBegin(index_key) == tree.End());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
 }  // namespace bustub
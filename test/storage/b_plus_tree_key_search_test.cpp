@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_key_search.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+template <size_t KeySize, typename IntType>
+auto MakeKeys(const std::vector<IntType> &values) -> std::vector<GenericKey<KeySize>> {
+  std::vector<GenericKey<KeySize>> keys(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    memset(keys[i].data_, 0, KeySize);
+    memcpy(keys[i].data_, &values[i], sizeof(IntType));
+  }
+  return keys;
+}
+
+template <size_t KeySize, typename IntType>
+void CheckAgainstComparator(const std::string &schema_sql, size_t num_keys, std::mt19937_64 *rng) {
+  auto key_schema = ParseCreateStatement(schema_sql);
+  GenericComparator<KeySize> comparator(key_schema.get());
+  ASSERT_TRUE(comparator.IsIntegerKey());
+
+  // sparse sorted keys with negatives and duplicates-free gaps, so probes fall between, before and after them
+  std::uniform_int_distribution<IntType> dist(-1000000, 1000000);
+  std::vector<IntType> values(num_keys);
+  for (auto &v : values) {
+    v = dist(*rng);
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  auto keys = MakeKeys<KeySize, IntType>(values);
+  int size = static_cast<int>(keys.size());
+
+  for (int probe = 0; probe < 2000; probe++) {
+    IntType target = probe % 2 == 0 ? dist(*rng) : values[(*rng)() % values.size()];
+    auto key = MakeKeys<KeySize, IntType>({target})[0];
+    int lo = static_cast<int>((*rng)() % (size + 1));
+    int hi = lo + static_cast<int>((*rng)() % (size - lo + 1));
+    int expected = ComparatorLowerBound(keys.data(), lo, hi, key, comparator);
+    int actual =
+        BPlusTreeKeySearch<GenericKey<KeySize>, GenericComparator<KeySize>>::LowerBound(keys.data(), lo, hi, key,
+                                                                                        comparator);
+    ASSERT_EQ(expected, actual) << "target " << target << " in [" << lo << ", " << hi << ")";
+  }
+}
+
+}  // namespace
+
+TEST(BPlusTreeKeySearchTest, IntegerKeysMatchComparator) {
+  std::mt19937_64 rng(15445);
+  for (size_t num_keys : {1, 3, 7, 8, 31, 64, 65, 200, 1000}) {
+    CheckAgainstComparator<4, int32_t>("a integer", num_keys, &rng);
+    CheckAgainstComparator<8, int64_t>("a bigint", num_keys, &rng);
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, NonIntegerSchemaFallsBack) {
+  // two INTEGER columns also fit in GenericKey<8>, but their bytes do not order like an int64
+  auto key_schema = ParseCreateStatement("a integer,b integer");
+  GenericComparator<8> comparator(key_schema.get());
+  ASSERT_FALSE(comparator.IsIntegerKey());
+
+  std::vector<GenericKey<8>> keys(4);
+  int32_t columns[4][2] = {{1, 5}, {2, -1}, {2, 3}, {3, 0}};
+  for (int i = 0; i < 4; i++) {
+    memcpy(keys[i].data_, columns[i], sizeof(columns[i]));
+  }
+  GenericKey<8> key;
+  int32_t target[2] = {2, 3};
+  memcpy(key.data_, target, sizeof(target));
+  EXPECT_EQ(2, (BPlusTreeKeySearch<GenericKey<8>, GenericComparator<8>>::LowerBound(keys.data(), 0, 4, key,
+                                                                                     comparator)));
+}
+
+TEST(BPlusTreeKeySearchTest, NullKeysOrderFirst) {
+  // NULL is stored as the smallest value of its type; both searches must agree it sorts first and matches only NULL
+  auto int_schema = ParseCreateStatement("a integer");
+  GenericComparator<4> int_comparator(int_schema.get());
+  auto int_keys = MakeKeys<4, int32_t>({BUSTUB_INT32_NULL, 5, 7});
+  auto int_null = MakeKeys<4, int32_t>({BUSTUB_INT32_NULL})[0];
+  EXPECT_EQ(0, int_comparator(int_null, int_keys[0]));
+  EXPECT_GT(0, int_comparator(int_null, int_keys[1]));
+  EXPECT_LT(0, int_comparator(int_keys[1], int_null));
+  EXPECT_EQ(0, (BPlusTreeKeySearch<GenericKey<4>, GenericComparator<4>>::LowerBound(int_keys.data(), 0, 3, int_null,
+                                                                                     int_comparator)));
+  EXPECT_EQ(1, (BPlusTreeKeySearch<GenericKey<4>, GenericComparator<4>>::LowerBound(int_keys.data(), 1, 3, int_null,
+                                                                                     int_comparator)));
+
+  auto pair_schema = ParseCreateStatement("a integer,b integer");
+  GenericComparator<8> pair_comparator(pair_schema.get());
+  std::vector<GenericKey<8>> keys(3);
+  int32_t columns[3][2] = {{BUSTUB_INT32_NULL, 1}, {BUSTUB_INT32_NULL, 2}, {5, BUSTUB_INT32_NULL}};
+  for (int i = 0; i < 3; i++) {
+    memcpy(keys[i].data_, columns[i], sizeof(columns[i]));
+  }
+  EXPECT_GT(0, pair_comparator(keys[0], keys[1]));
+  EXPECT_GT(0, pair_comparator(keys[1], keys[2]));
+  EXPECT_EQ(0, pair_comparator(keys[2], keys[2]));
+  GenericKey<8> five_one;
+  int32_t target[2] = {5, 1};
+  memcpy(five_one.data_, target, sizeof(target));
+  EXPECT_GT(0, pair_comparator(keys[2], five_one));
+}
+
+TEST(BPlusTreeKeySearchTest, DISABLED_LookupBenchmark) {  // NOLINT
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  // in-node search over one full leaf
+  std::vector<int64_t> values((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - sizeof(GenericKey<8>)) /
+                             (sizeof(GenericKey<8>) + sizeof(RID)));
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = static_cast<int64_t>(i) * 3;
+  }
+  auto keys = MakeKeys<8, int64_t>(values);
+  std::mt19937_64 rng(15445);
+  std::vector<GenericKey<8>> probes;
+  for (int i = 0; i < 100000; i++) {
+    probes.push_back(MakeKeys<8, int64_t>({static_cast<int64_t>(rng() % (values.size() * 3))})[0]);
+  }
+  int size = static_cast<int>(keys.size());
+
+  auto time_ms = [&](auto &&search) {
+    auto start = std::chrono::steady_clock::now();
+    int64_t checksum = 0;
+    for (const auto &probe : probes) {
+      checksum += search(probe);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::make_pair(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), checksum);
+  };
+  auto [scalar_us, scalar_sum] =
+      time_ms([&](const GenericKey<8> &key) { return ComparatorLowerBound(keys.data(), 0, size, key, comparator); });
+  auto [simd_us, simd_sum] = time_ms([&](const GenericKey<8> &key) {
+    return BPlusTreeKeySearch<GenericKey<8>, GenericComparator<8>>::LowerBound(keys.data(), 0, size, key, comparator);
+  });
+  ASSERT_EQ(scalar_sum, simd_sum);
+  std::cout << "leaf of " << size << " keys, " << probes.size() << " probes" << std::endl;
+  std::cout << "comparator search: " << scalar_us << " us" << std::endl;
+  std::cout << "integer search:    " << simd_us << " us" << std::endl;
+
+  // point lookups through the whole tree
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(1024, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator);
+  auto *transaction = new Transaction(0);
+  const int64_t num_keys = 200000;
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key)), transaction);
+  }
+  std::vector<RID> result;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 200000; i++) {
+    index_key.SetFromInteger(static_cast<int64_t>(rng() % num_keys));
+    result.clear();
+    ASSERT_TRUE(tree.GetValue(index_key, &result));
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "tree point lookups: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
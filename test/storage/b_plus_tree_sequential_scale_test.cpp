@@ -11,7 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
 #include <random>
 
 #include "buffer/buffer_pool_manager.h"
@@ -27,7 +29,7 @@ using bustub::DiskManagerUnlimitedMemory;
 /**
  * This test should be passing with your Checkpoint 1 submission.
  */
-TEST(BPlusTreeTests, DISABLED_ScaleTest) {  // NOLINT
+TEST(BPlusTreeTests, ScaleTest) {  // NOLINT
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -77,4 +79,55 @@ TEST(BPlusTreeTests, DISABLED_ScaleTest) {  // NOLINT
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, DISABLED_ColdScanPrefetchBenchmark) {  // NOLINT
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  // far fewer frames than leaves, so every scan reads most leaves from disk
+  auto *bpm = new BufferPoolManager(32, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 64, 64);
+  auto *transaction = new Transaction(0);
+
+  const int64_t num_keys = 10000;
+  GenericKey<8> index_key;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key)), transaction);
+  }
+
+  disk_manager->SetLatency(1);
+  for (int depth : {0, INDEX_ITERATOR_PREFETCH_DEPTH}) {
+    tree.SetIteratorPrefetchDepth(depth);
+    auto start = std::chrono::steady_clock::now();
+    int64_t expected = 1;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+      ASSERT_EQ((*iter).first.ToString(), expected);
+      expected++;
+    }
+    ASSERT_EQ(expected, num_keys + 1);
+    auto end = std::chrono::steady_clock::now();
+
+    expected = num_keys;
+    for (auto iter = tree.RBegin(); iter != tree.End(); ++iter) {
+      ASSERT_EQ((*iter).first.ToString(), expected);
+      expected--;
+    }
+    ASSERT_EQ(expected, 0);
+
+    std::cout << "cold forward scan with prefetch depth " << depth << ": "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
 }  // namespace bustub
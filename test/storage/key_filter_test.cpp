@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_filter_test.cpp
+//
+// Identification: test/storage/key_filter_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/key_filter.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(KeyFilterTest, InsertRemoveTest) {
+  const uint64_t num_keys = 10000;
+  KeyFilter filter(num_keys);
+  // every key twice, as in a non-unique index
+  for (uint64_t i = 0; i < 2 * num_keys; i++) {
+    filter.Insert(i % num_keys);
+  }
+  for (uint64_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(filter.MayContain(i)) << i;
+  }
+  for (uint64_t i = num_keys; i < 2 * num_keys; i++) {
+    if (filter.MayContain(i)) {
+      filter.RecordFalsePositive();
+    }
+  }
+  auto stats = filter.GetStats();
+  EXPECT_EQ(2 * num_keys, stats.lookups_);
+  EXPECT_EQ(num_keys, stats.skipped_ + stats.false_positives_);
+  EXPECT_LT(stats.FalsePositiveRate(), 0.05);
+
+  // a key stays in until its last copy is removed
+  for (uint64_t i = 0; i < num_keys; i++) {
+    filter.Remove(i);
+  }
+  for (uint64_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(filter.MayContain(i)) << i;
+  }
+  for (uint64_t i = 0; i < num_keys; i++) {
+    filter.Remove(i);
+  }
+  for (uint64_t i = 0; i < num_keys; i++) {
+    EXPECT_FALSE(filter.MayContain(i)) << i;
+  }
+}
+
+namespace {
+
+// Fill the index with the even keys, look up every key, then remove half of the even keys and look them up again.
+void CheckIndexWithFilter(Index *index, const Schema *key_schema) {
+  index->EnableKeyFilter(1000);
+  auto key_of = [&](int k) { return Tuple({ValueFactory::GetIntegerValue(k)}, key_schema); };
+  for (int k = 0; k < 2000; k += 2) {
+    index->InsertEntry(key_of(k), RID(k, 0), nullptr);
+  }
+  for (int k = 0; k < 2000; k++) {
+    std::vector<RID> rids;
+    index->ScanKey(key_of(k), &rids, nullptr);
+    EXPECT_EQ(k % 2 == 0 ? std::vector<RID>{RID(k, 0)} : std::vector<RID>{}, rids) << k;
+  }
+  auto stats = index->GetKeyFilter()->GetStats();
+  EXPECT_EQ(2000, stats.lookups_);
+  EXPECT_EQ(1000, stats.skipped_ + stats.false_positives_);
+  EXPECT_GT(stats.skipped_, 900);
+
+  // a removed pair leaves the filter too, but a pair that is not in the index does not take its key along
+  for (int k = 0; k < 2000; k += 4) {
+    index->DeleteEntry(key_of(k), RID(k, 0), nullptr);
+    index->DeleteEntry(key_of(k + 2), RID(k + 1, 0), nullptr);
+  }
+  for (int k = 0; k < 2000; k += 2) {
+    std::vector<RID> rids;
+    index->ScanKey(key_of(k), &rids, nullptr);
+    EXPECT_EQ(k % 4 == 2 ? std::vector<RID>{RID(k, 0)} : std::vector<RID>{}, rids) << k;
+  }
+  EXPECT_GT(index->GetKeyFilter()->GetStats().skipped_, stats.skipped_ + 450);
+}
+
+}  // namespace
+
+TEST(KeyFilterTest, IndexTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table_schema = ParseCreateStatement("a integer");
+
+  BPlusTreeIndexForOneIntegerColumn btree(
+      std::make_unique<IndexMetadata>("btree", "t", table_schema.get(), std::vector<uint32_t>{0}), bpm.get());
+  CheckIndexWithFilter(&btree, btree.GetKeySchema());
+
+  ExtendibleHashTableIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType> hash(
+      std::make_unique<IndexMetadata>("hash", "t", table_schema.get(), std::vector<uint32_t>{0}), bpm.get(),
+      IntegerHashFunctionType());
+  CheckIndexWithFilter(&hash, hash.GetKeySchema());
+}
+
+TEST(KeyFilterTest, CoveringIndexTest) {
+  // B+ tree entries carry included columns after the key, while search keys are laid out in the key schema alone
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table_schema = ParseCreateStatement("a integer,b integer,c integer");
+
+  BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>> index(
+      std::make_unique<IndexMetadata>("btree", "t", table_schema.get(), std::vector<uint32_t>{0},
+                                      std::vector<uint32_t>{1, 2}),
+      bpm.get());
+  index.EnableKeyFilter(1000);
+  for (int k = 0; k < 1000; k++) {
+    // a NULL included column must not leak into the key hash
+    auto c = k % 2 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(k);
+    Tuple entry({ValueFactory::GetIntegerValue(k), ValueFactory::GetIntegerValue(k * 10), c}, index.GetEntrySchema());
+    index.InsertEntry(entry, RID(k, 0), nullptr);
+  }
+  for (int k = 0; k < 1000; k++) {
+    std::vector<RID> rids;
+    index.ScanKey(Tuple({ValueFactory::GetIntegerValue(k)}, index.GetKeySchema()), &rids, nullptr);
+    ASSERT_EQ(std::vector<RID>{RID(k, 0)}, rids) << k;
+  }
+  EXPECT_EQ(0, index.GetKeyFilter()->GetStats().skipped_);
+}
+
+}  // namespace bustub
@@ -0,0 +1,403 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 64)});
+  auto tuple_of = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(40, 'x'))}, &schema);
+  };
+  Transaction txn(0);
+  auto table = std::make_unique<TableHeap>(bpm.get(), nullptr, nullptr, &txn);
+
+  // enough tuples for the free-space map to span several pages
+  const int num_tuples = 100000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple_of(i), &rid, &txn));
+    rids.push_back(rid);
+  }
+  auto num_pages = table->GetNumPages();
+  int count = 0;
+  for (auto iter = table->Begin(&txn); iter != table->End(); ++iter) {
+    ASSERT_EQ(count, iter->GetValue(&schema, 0).GetAs<int32_t>());
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  // free the first and the last pages; new tuples go there instead of into new pages (the free-space map rounds
+  // free space down, so a page takes back a little less than it held)
+  std::set<page_id_t> freed_pages;
+  for (int i = 0; i < num_tuples; i++) {
+    if (i < num_tuples / 10 || i >= num_tuples - num_tuples / 10) {
+      ASSERT_TRUE(table->MarkDelete(rids[i], &txn));
+      table->ApplyDelete(rids[i], &txn);
+      freed_pages.insert(rids[i].GetPageId());
+    }
+  }
+  for (int i = 0; i < num_tuples / 6; i++) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple_of(i), &rid, &txn));
+    EXPECT_EQ(1, freed_pages.count(rid.GetPageId())) << i;
+  }
+  EXPECT_EQ(num_pages, table->GetNumPages());
+
+  // a reopened table lists its pages again and keeps filling them
+  auto first_page_id = table->GetFirstPageId();
+  for (int i = 0; i < num_tuples / 10; i++) {
+    ASSERT_TRUE(table->MarkDelete(rids[num_tuples / 2 + i], &txn));
+    table->ApplyDelete(rids[num_tuples / 2 + i], &txn);
+  }
+  table = std::make_unique<TableHeap>(bpm.get(), nullptr, nullptr, first_page_id);
+  EXPECT_EQ(num_pages, table->GetNumPages());
+  for (int i = 0; i < num_tuples / 12; i++) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple_of(i), &rid, &txn));
+  }
+  EXPECT_EQ(num_pages, table->GetNumPages());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, AppendTuplesTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 64)});
+  auto tuple_of = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))},
+                 &schema);
+  };
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+
+  // a few single inserts, then batches that span many pages
+  const int num_tuples = 20000;
+  std::vector<RID> rids;
+  for (int i = 0; i < 10; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple_of(i), &rid, &txn));
+    rids.push_back(rid);
+  }
+  for (int i = 10; i < num_tuples; i += 1000) {
+    std::vector<Tuple> batch;
+    for (int j = i; j < std::min(i + 1000, num_tuples); j++) {
+      batch.push_back(tuple_of(j));
+    }
+    ASSERT_TRUE(table.AppendTuples(batch, &rids, &txn));
+  }
+  ASSERT_EQ(num_tuples, rids.size());
+  EXPECT_EQ(num_tuples, txn.GetWriteSet()->size());
+
+  // the tuples follow each other in the table, and pages are filled before the next one starts
+  int count = 0;
+  std::set<page_id_t> pages;
+  for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+    ASSERT_EQ(rids[count], iter->GetRid());
+    ASSERT_EQ(count, iter->GetValue(&schema, 0).GetAs<int32_t>());
+    pages.insert(iter->GetRid().GetPageId());
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+  EXPECT_EQ(pages.size(), table.GetNumPages());
+  size_t bytes = 0;
+  for (int i = 0; i < num_tuples; i++) {
+    bytes += tuple_of(i).GetLength() + 8;
+  }
+  EXPECT_LE(table.GetNumPages(), bytes / (BUSTUB_PAGE_SIZE - 24 - 64) + 1);
+
+  // an insert after the append fills the last page
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(tuple_of(0), &rid, &txn));
+  EXPECT_EQ(rids.back().GetPageId(), rid.GetPageId());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, VacuumTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 64)});
+  auto tuple_of = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))},
+                 &schema);
+  };
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+
+  const int num_tuples = 20000;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table.InsertTuple(tuple_of(i), &rids[i], &txn));
+  }
+
+  // no vacuum while another transaction has uncommitted changes to the table
+  Transaction other(1);
+  RID other_rid;
+  ASSERT_TRUE(table.InsertTuple(tuple_of(0), &other_rid, &other));
+  EXPECT_FALSE(table.Vacuum([](const Tuple &, const RID &, const RID &) {}, &txn).has_value());
+  table.ApplyDelete(other_rid, &other);
+  table.ReleaseWrite(&other);
+  // nor while a scan is open
+  {
+    auto scan_latch = table.LockForScan();
+    EXPECT_FALSE(table.Vacuum([](const Tuple &, const RID &, const RID &) {}, &txn).has_value());
+  }
+  auto num_pages = table.GetNumPages();
+
+  // keep every fourth tuple, and one more that is marked as deleted but not yet gone
+  const int pending = num_tuples - 2;
+  for (int i = 0; i < num_tuples; i++) {
+    if (i % 4 != 0) {
+      ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+      if (i != pending) {
+        table.ApplyDelete(rids[i], &txn);
+      }
+    }
+  }
+
+  std::unordered_map<int, RID> moved;
+  auto vacuumed = table.Vacuum(
+      [&](const Tuple &tuple, const RID &old_rid, const RID &new_rid) {
+        auto i = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+        EXPECT_EQ(rids[i], old_rid);
+        EXPECT_LT(new_rid.GetPageId(), old_rid.GetPageId());
+        moved[i] = new_rid;
+      },
+      &txn);
+  ASSERT_TRUE(vacuumed.has_value());
+  auto num_dropped = *vacuumed;
+  EXPECT_EQ(num_pages - num_dropped, table.GetNumPages());
+  EXPECT_LE(table.GetNumPages(), num_pages / 3);
+  EXPECT_EQ(0, moved.count(pending));
+
+  // every kept tuple is where the callback said it went, and a scan reads each once from the remaining pages
+  std::set<page_id_t> pages;
+  int count = 0;
+  for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+    auto i = iter->GetValue(&schema, 0).GetAs<int32_t>();
+    ASSERT_EQ(0, i % 4);
+    ASSERT_EQ(moved.count(i) != 0 ? moved[i] : rids[i], iter->GetRid());
+    pages.insert(iter->GetRid().GetPageId());
+    count++;
+  }
+  EXPECT_EQ(num_tuples / 4, count);
+  EXPECT_EQ(table.GetNumPages(), pages.size() + (pages.count(rids[pending].GetPageId()) != 0 ? 0 : 1));
+
+  // the pending delete can still be rolled back where it was
+  table.RollbackDelete(rids[pending], &txn);
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rids[pending], &tuple, &txn));
+  EXPECT_EQ(pending, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+
+  // new tuples go into the remaining pages before the table grows again
+  for (int i = 0; i < 50; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple_of(i), &rid, &txn));
+  }
+  EXPECT_EQ(num_pages - num_dropped, table.GetNumPages());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ToastTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 65536), Column("c", TypeId::VARCHAR, 64)});
+  auto text_of = [](int i) { return std::string(20000 + i, static_cast<char>('a' + i % 26)); };
+  auto tuple_of = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(text_of(i)),
+                  ValueFactory::GetVarcharValue("small")},
+                 &schema);
+  };
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn, &schema);
+
+  // tuples larger than a page go in, with their large value moved out of the table pages
+  const int num_tuples = 50;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples / 2; i++) {
+    ASSERT_TRUE(table.InsertTuple(tuple_of(i), &rids[i], &txn));
+  }
+  std::vector<Tuple> tuples;
+  for (int i = num_tuples / 2; i < num_tuples; i++) {
+    tuples.push_back(tuple_of(i));
+  }
+  std::vector<RID> appended;
+  ASSERT_TRUE(table.AppendTuples(tuples, &appended, &txn));
+  std::copy(appended.begin(), appended.end(), rids.begin() + num_tuples / 2);
+  EXPECT_EQ(1, table.GetNumPages());
+
+  int count = 0;
+  for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+    ASSERT_TRUE(iter->IsToasted(&schema));
+    auto i = iter->GetValue(&schema, 0).GetAs<int32_t>();
+    EXPECT_EQ(rids[i], iter->GetRid());
+    EXPECT_EQ(text_of(i), iter->GetValue(&schema, 1).ToString());
+    EXPECT_EQ("small", iter->GetValue(&schema, 2).ToString());
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  // a tuple that fits stays as it is
+  RID rid;
+  Tuple small({ValueFactory::GetIntegerValue(num_tuples + 1), ValueFactory::GetVarcharValue("b"),
+               ValueFactory::GetVarcharValue("c")},
+              &schema);
+  ASSERT_TRUE(table.InsertTuple(small, &rid, &txn));
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  EXPECT_FALSE(tuple.IsToasted(&schema));
+
+  // an update toasts the new tuple; a rollback brings the old one back, and a commit keeps the new one
+  ASSERT_TRUE(table.UpdateTuple(tuple_of(num_tuples + 1), rid, &txn));
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  ASSERT_TRUE(tuple.IsToasted(&schema));
+  EXPECT_EQ(text_of(num_tuples + 1), tuple.GetValue(&schema, 1).ToString());
+  auto update = txn.GetWriteSet()->back();
+  ASSERT_EQ(WType::UPDATE, update.wtype_);
+  table.RollbackUpdate(update.tuple_, rid, &txn);
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  EXPECT_EQ("b", tuple.GetValue(&schema, 1).ToString());
+  ASSERT_TRUE(table.UpdateTuple(tuple_of(num_tuples + 1), rid, &txn));
+  ASSERT_TRUE(table.UpdateTuple(tuple_of(num_tuples + 3), rid, &txn));
+  table.ApplyUpdate(txn.GetWriteSet()->back().tuple_);
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  EXPECT_EQ(text_of(num_tuples + 3), tuple.GetValue(&schema, 1).ToString());
+  ASSERT_TRUE(table.UpdateTuple(small, rid, &txn));
+
+  // deleting a toasted tuple frees its overflow pages; the value reads back until then
+  for (int i = 0; i < num_tuples; i += 2) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    ASSERT_TRUE(table.GetTuple(rids[i + 1], &tuple, &txn));
+    EXPECT_EQ(text_of(i + 1), tuple.GetValue(&schema, 1).ToString());
+    table.ApplyDelete(rids[i], &txn);
+  }
+  count = 0;
+  for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+    auto i = iter->GetValue(&schema, 0).GetAs<int32_t>();
+    EXPECT_EQ(1, i % 2);
+    if (i < num_tuples) {
+      EXPECT_EQ(text_of(i), iter->GetValue(&schema, 1).ToString());
+    }
+    count++;
+  }
+  EXPECT_EQ(num_tuples / 2 + 1, count);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PaxTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 65536), Column("c", TypeId::BIGINT)});
+  auto tuple_of = [&](int i, const std::string &text) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(text),
+                  i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(i * 10)},
+                 &schema);
+  };
+  auto text_of = [](int i) { return std::string(i % 40, static_cast<char>('a' + i % 26)); };
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn, &schema, TableFormat::PAX);
+
+  // tuples go in one by one and in batches, and read back in the row format, NULLs included
+  const int num_tuples = 5000;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples / 2; i++) {
+    ASSERT_TRUE(table.InsertTuple(tuple_of(i, text_of(i)), &rids[i], &txn));
+  }
+  std::vector<Tuple> tuples;
+  for (int i = num_tuples / 2; i < num_tuples; i++) {
+    tuples.push_back(tuple_of(i, text_of(i)));
+  }
+  std::vector<RID> appended;
+  ASSERT_TRUE(table.AppendTuples(tuples, &appended, &txn));
+  std::copy(appended.begin(), appended.end(), rids.begin() + num_tuples / 2);
+  int count = 0;
+  for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+    ASSERT_EQ(rids[count], iter->GetRid());
+    ASSERT_EQ(count, iter->GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(text_of(count), iter->GetValue(&schema, 1).ToString());
+    EXPECT_EQ(count % 7 == 0, iter->IsNull(&schema, 2));
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  // a scan of some columns leaves the others NULL
+  std::vector<char> copy(BUSTUB_PAGE_SIZE);
+  std::vector<uint32_t> columns{0, 2};
+  count = 0;
+  for (auto page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id = table.ScanPage(page_id, copy.data(), &tuples, &columns);
+    for (const auto &tuple : tuples) {
+      ASSERT_EQ(count, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+      EXPECT_TRUE(tuple.IsNull(&schema, 1));
+      EXPECT_TRUE(tuple.GetValue(&schema, 1).IsNull());
+      if (count % 7 != 0) {
+        EXPECT_EQ(count * 10, tuple.GetValue(&schema, 2).GetAs<int64_t>());
+      }
+      count++;
+    }
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  // the zone maps skip the pages whose values of a are all out of range
+  std::vector<ColumnRange> ranges{{0, ValueFactory::GetIntegerValue(1000), ValueFactory::GetIntegerValue(1099)}};
+  count = 0;
+  int num_scanned = 0;
+  for (auto page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id = table.ScanPage(page_id, copy.data(), &tuples, &columns, &ranges);
+    for (const auto &tuple : tuples) {
+      auto i = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+      count += static_cast<int>(i >= 1000 && i <= 1099);
+      num_scanned++;
+    }
+  }
+  EXPECT_EQ(100, count);
+  EXPECT_LT(num_scanned, num_tuples / 2);
+
+  // updates, deletes and their rollback
+  Tuple tuple;
+  ASSERT_TRUE(table.UpdateTuple(tuple_of(1, std::string(60, 'u')), rids[1], &txn));
+  ASSERT_TRUE(table.GetTuple(rids[1], &tuple, &txn));
+  EXPECT_EQ(std::string(60, 'u'), tuple.GetValue(&schema, 1).ToString());
+  ASSERT_TRUE(table.MarkDelete(rids[2], &txn));
+  EXPECT_FALSE(table.GetTuple(rids[2], &tuple, &txn));
+  table.RollbackDelete(rids[2], &txn);
+  ASSERT_TRUE(table.GetTuple(rids[2], &tuple, &txn));
+  EXPECT_EQ(text_of(2), tuple.GetValue(&schema, 1).ToString());
+  ASSERT_TRUE(table.MarkDelete(rids[3], &txn));
+  table.ApplyDelete(rids[3], &txn);
+  EXPECT_FALSE(table.GetTuple(rids[3], &tuple, &txn));
+
+  // a tuple larger than a page is toasted
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(tuple_of(3, std::string(20000, 't')), &rid, &txn));
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  EXPECT_TRUE(tuple.IsToasted(&schema));
+  EXPECT_EQ(std::string(20000, 't'), tuple.GetValue(&schema, 1).ToString());
+}
+
+}  // namespace bustub
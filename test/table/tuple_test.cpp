@@ -20,7 +20,9 @@
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +73,99 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, ViewTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16)});
+  std::vector<char> buffer;
+  auto view = Tuple::ViewOf({ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("one")}, &schema, &buffer);
+  ASSERT_TRUE(view.IsView());
+  EXPECT_EQ(buffer.data(), view.GetData());
+  EXPECT_EQ("one", view.GetValue(&schema, 1).ToString());
+
+  // moving keeps the view, copying makes a tuple of its own
+  Tuple moved = std::move(view);
+  ASSERT_TRUE(moved.IsView());
+  Tuple copied = moved;
+  Tuple assigned;
+  assigned = moved;
+  EXPECT_FALSE(copied.IsView());
+  EXPECT_FALSE(assigned.IsView());
+
+  // the next row reuses the buffer, which the view follows but the copies do not
+  auto *data = buffer.data();
+  auto next = Tuple::ViewOf({ValueFactory::GetIntegerValue(2), ValueFactory::GetVarcharValue("two")}, &schema, &buffer);
+  EXPECT_EQ(data, next.GetData());
+  EXPECT_EQ(2, moved.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ(1, copied.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ("one", assigned.GetValue(&schema, 1).ToString());
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, NullBitmapTest) {
+  std::vector<Column> columns;
+  std::vector<Value> values;
+  for (uint32_t i = 0; i < 10; i++) {
+    auto type = i % 3 == 0 ? TypeId::VARCHAR : (i % 3 == 1 ? TypeId::INTEGER : TypeId::BIGINT);
+    auto name = "c" + std::to_string(i);
+    columns.push_back(type == TypeId::VARCHAR ? Column(name, type, 16) : Column(name, type));
+    if (i % 4 == 1) {
+      values.push_back(ValueFactory::GetNullValueByType(type));
+    } else if (type == TypeId::VARCHAR) {
+      values.push_back(ValueFactory::GetVarcharValue(std::to_string(i)));
+    } else {
+      values.push_back(ValueFactory::GetIntegerValue(i).CastAs(type));
+    }
+  }
+  Schema schema(columns);
+  ASSERT_EQ(2, Tuple::NullBitmapSize(&schema));
+  Tuple tuple(values, &schema);
+
+  // columns 1, 5 and 9 are NULL
+  const uint8_t *null_bitmap = tuple.GetNullBitmap(&schema);
+  EXPECT_EQ(0x22, null_bitmap[0]);
+  EXPECT_EQ(0x02, null_bitmap[1]);
+  for (uint32_t i = 0; i < 10; i++) {
+    ASSERT_EQ(i % 4 == 1, tuple.IsNull(&schema, i)) << i;
+    auto value = tuple.GetValue(&schema, i);
+    ASSERT_EQ(i % 4 == 1, value.IsNull()) << i;
+    ASSERT_EQ(columns[i].GetType(), value.GetTypeId()) << i;
+    if (!value.IsNull()) {
+      ASSERT_EQ(std::to_string(i), value.ToString()) << i;
+    }
+  }
+  EXPECT_NE(std::string::npos, tuple.ToString(&schema).find("<NULL>"));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, ScanPageTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16)});
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+  std::vector<RID> rids(2000);
+  for (int i = 0; i < 2000; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))}, &schema);
+    ASSERT_TRUE(table.InsertTuple(tuple, &rids[i], &txn));
+  }
+  ASSERT_TRUE(table.MarkDelete(rids[5], &txn));
+
+  // a page at a time, the views read what a tuple at a time reads
+  std::vector<char> copy(BUSTUB_PAGE_SIZE);
+  std::vector<Tuple> tuples;
+  auto iter = table.Begin(&txn);
+  size_t num_pages = 0;
+  for (auto page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID; num_pages++) {
+    page_id = table.ScanPage(page_id, copy.data(), &tuples);
+    for (const auto &tuple : tuples) {
+      ASSERT_TRUE(tuple.IsView());
+      ASSERT_EQ(iter->GetRid(), tuple.GetRid());
+      ASSERT_EQ(iter->GetValue(&schema, 1).ToString(), tuple.GetValue(&schema, 1).ToString());
+      ++iter;
+    }
+  }
+  EXPECT_TRUE(iter == table.End());
+  EXPECT_EQ(table.GetNumPages(), num_pages);
+}
+
 }  // namespace bustub
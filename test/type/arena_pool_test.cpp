@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool_test.cpp
+//
+// Identification: test/type/arena_pool_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+#include "gtest/gtest.h"
+#include "storage/table/tuple.h"
+#include "type/arena_pool.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, AllocateTest) {
+  ArenaPool arena(ArenaPool::BLOCK_SIZE * 2);
+  std::vector<char *> chunks;
+  for (size_t size = 1; size < 1000; size += 7) {
+    auto *chunk = static_cast<char *>(arena.Allocate(size));
+    ASSERT_NE(nullptr, chunk);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(chunk) % alignof(std::max_align_t));
+    memset(chunk, static_cast<int>(size), size);
+    chunks.push_back(chunk);
+  }
+  for (size_t i = 0; i < chunks.size(); i++) {
+    EXPECT_EQ(static_cast<char>(1 + 7 * i), chunks[i][1 + 7 * i - 1]);
+  }
+
+  // a request larger than a block gets a block of its own
+  auto reserved = arena.GetBytesReserved();
+  ASSERT_NE(nullptr, arena.AllocateAligned(ArenaPool::BLOCK_SIZE * 3, 64));
+  EXPECT_GE(arena.GetBytesReserved(), reserved + ArenaPool::BLOCK_SIZE * 3);
+
+  // the budget bounds Allocate, but not AllocateAligned
+  EXPECT_EQ(nullptr, arena.Allocate(ArenaPool::BLOCK_SIZE * 2));
+  EXPECT_NE(nullptr, arena.AllocateAligned(ArenaPool::BLOCK_SIZE * 2, 8));
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, ValueTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 32)});
+  Value copied;
+  Tuple kept;
+  {
+    auto arena = std::make_unique<ArenaPool>();
+    ArenaPool::Scope scope(arena.get());
+    auto value = ValueFactory::GetVarcharValue("in the arena");
+    EXPECT_GT(arena->GetBytesUsed(), 0);
+    EXPECT_EQ("in the arena", Value(value).ToString());
+
+    // a tuple built while the arena is current lives in it
+    Tuple tuple({ValueFactory::GetIntegerValue(1), value}, &schema);
+    EXPECT_TRUE(tuple.IsView());
+    EXPECT_EQ("in the arena", tuple.GetValue(&schema, 1).ToString());
+
+    // copies made where no arena is current come from the heap, and outlive the arena
+    [&] {
+      ArenaPool::Scope no_arena(nullptr);
+      copied = value;
+      kept = tuple;
+    }();
+    EXPECT_FALSE(kept.IsView());
+  }
+  EXPECT_EQ("in the arena", copied.ToString());
+  EXPECT_EQ("in the arena", kept.GetValue(&schema, 1).ToString());
+
+  // past the budget, values fall back to the heap
+  ArenaPool small(8);
+  ArenaPool::Scope scope(&small);
+  EXPECT_EQ("longer than the budget", ValueFactory::GetVarcharValue("longer than the budget").ToString());
+  EXPECT_EQ(0, small.GetBytesUsed());
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, AggregationHashTableTest) {
+  ArenaPool arena;
+  std::vector<AbstractExpressionRef> agg_exprs;
+  std::vector<AggregationType> agg_types{AggregationType::CountStarAggregate};
+  agg_exprs.emplace_back(nullptr);
+  SimpleAggregationHashTable ht(agg_exprs, agg_types, &arena);
+  for (int i = 0; i < 1000; i++) {
+    ht.InsertCombine({{ValueFactory::GetIntegerValue(i % 100)}}, {{ValueFactory::GetIntegerValue(1)}});
+  }
+  int count = 0;
+  for (auto iter = ht.Begin(); iter != ht.End(); ++iter) {
+    EXPECT_LT(iter.Key().group_bys_[0].GetAs<int32_t>(), 100);
+    count++;
+  }
+  EXPECT_EQ(100, count);
+  EXPECT_GT(arena.GetBytesReserved(), 0);
+}
+
+}  // namespace bustub
@@ -17,6 +17,7 @@
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "type/value.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 //===--------------------------------------------------------------------===//
@@ -95,4 +96,58 @@ TEST(TypeTests, TemplateTest) {
   BPlusTreePage<Value, Value> node;
   node.GetInfo(val1, val2);
 }
+
+// NOLINTNEXTLINE
+TEST(TypeTests, NativeFastPathTest) {
+  // same-type operations on native values agree with the Type of the value
+  std::vector<std::vector<Value>> samples = {
+      {ValueFactory::GetBooleanValue(false), ValueFactory::GetBooleanValue(true)},
+      {ValueFactory::GetTinyIntValue(-3), ValueFactory::GetTinyIntValue(7)},
+      {ValueFactory::GetSmallIntValue(-300), ValueFactory::GetSmallIntValue(700)},
+      {ValueFactory::GetIntegerValue(-30000), ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(40000)},
+      {ValueFactory::GetBigIntValue(-3000000000), ValueFactory::GetBigIntValue(70000)},
+      {ValueFactory::GetDecimalValue(-2.5), ValueFactory::GetDecimalValue(1.25)},
+  };
+  for (const auto &values : samples) {
+    const auto *type = Type::GetInstance(values[0].GetTypeId());
+    for (const auto &x : values) {
+      for (const auto &y : values) {
+        EXPECT_EQ(type->CompareEquals(x, y), x.CompareEquals(y));
+        EXPECT_EQ(type->CompareNotEquals(x, y), x.CompareNotEquals(y));
+        EXPECT_EQ(type->CompareLessThan(x, y), x.CompareLessThan(y));
+        EXPECT_EQ(type->CompareLessThanEquals(x, y), x.CompareLessThanEquals(y));
+        EXPECT_EQ(type->CompareGreaterThan(x, y), x.CompareGreaterThan(y));
+        EXPECT_EQ(type->CompareGreaterThanEquals(x, y), x.CompareGreaterThanEquals(y));
+        auto id = x.GetTypeId();
+        if (id == TypeId::INTEGER || id == TypeId::BIGINT || id == TypeId::DECIMAL) {
+          EXPECT_EQ(CmpBool::CmpTrue, type->Add(x, y).CompareEquals(x.Add(y)));
+          EXPECT_EQ(CmpBool::CmpTrue, type->Subtract(x, y).CompareEquals(x.Subtract(y)));
+          EXPECT_EQ(CmpBool::CmpTrue, type->Multiply(x, y).CompareEquals(x.Multiply(y)));
+          EXPECT_EQ(id, x.Add(y).GetTypeId());
+        }
+      }
+      char storage[8];
+      x.SerializeTo(storage);
+      EXPECT_EQ(CmpBool::CmpTrue, x.CompareEquals(Value::DeserializeFrom(storage, x.GetTypeId())));
+    }
+  }
+
+  // TIMESTAMP has no Type instance, but compares on the fast path
+  EXPECT_EQ(CmpBool::CmpTrue,
+            ValueFactory::GetTimestampValue(1000).CompareLessThan(ValueFactory::GetTimestampValue(2000)));
+
+  // overflow still throws, and NULL still compares as NULL
+  auto max_int = ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX);
+  EXPECT_THROW(max_int.Add(ValueFactory::GetIntegerValue(1)), Exception);
+  EXPECT_THROW(max_int.Multiply(max_int), Exception);
+  auto max_bigint = ValueFactory::GetBigIntValue(BUSTUB_INT64_MAX);
+  EXPECT_THROW(max_bigint.Add(ValueFactory::GetBigIntValue(1)), Exception);
+  auto null_int = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  EXPECT_EQ(CmpBool::CmpNull, null_int.CompareEquals(max_int));
+  EXPECT_TRUE(null_int.Add(max_int).IsNull());
+  char storage[4];
+  null_int.SerializeTo(storage);
+  EXPECT_TRUE(Value::DeserializeFrom(storage, TypeId::INTEGER).IsNull());
+}
+
 }  // namespace bustub
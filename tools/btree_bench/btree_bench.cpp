@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <cpp_random_distributions/zipfian_int_distribution.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const size_t BUSTUB_BENCH_THREAD = 8;
+static const size_t LRU_K_SIZE = 16;
+static const size_t BUSTUB_BPM_SIZE = 256;
+static const size_t BUSTUB_RECORD_CNT = 100000;
+static const size_t BUSTUB_SCAN_LENGTH = 100;
+static const double ZIPFIAN_THETA = 0.99;
+
+using BenchTree = bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+
+enum class OpType { Read, Update, Insert, Delete, Scan, ReadModifyWrite };
+static const std::array<const char *, 6> OP_NAMES = {"read", "update", "insert", "delete", "scan", "rmw"};
+
+/** Percentage of each operation in a workload, in OpType order. */
+using OpMix = std::array<int, 6>;
+
+/** The YCSB core workloads. Workload D reads the latest records; the rest read by the chosen key distribution. */
+auto YcsbMix(char workload) -> OpMix {
+  switch (workload) {
+    case 'a':
+      return {50, 50, 0, 0, 0, 0};
+    case 'b':
+      return {95, 5, 0, 0, 0, 0};
+    case 'c':
+      return {100, 0, 0, 0, 0, 0};
+    case 'd':
+      return {95, 0, 5, 0, 0, 0};
+    case 'e':
+      return {0, 0, 5, 0, 95, 0};
+    case 'f':
+      return {50, 0, 0, 0, 0, 50};
+    default:
+      throw bustub::Exception(fmt::format("unknown workload {}", workload));
+  }
+}
+
+/**
+ * Log-linear latency histogram: 16 buckets per power of two, so each percentile is off by at most 1/16th. Adding a
+ * sample costs a few instructions, which keeps the measurement out of the way of the operations it measures.
+ */
+struct LatencyHistogram {
+  static const int SUB_BUCKETS = 16;
+  std::vector<uint64_t> buckets_ = std::vector<uint64_t>(64 * SUB_BUCKETS, 0);
+  uint64_t count_{0};
+
+  static auto BucketOf(uint64_t ns) -> size_t {
+    if (ns < SUB_BUCKETS) {
+      return ns;
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    return (msb - 3) * SUB_BUCKETS + ((ns >> (msb - 4)) & (SUB_BUCKETS - 1));
+  }
+
+  // smallest value falling in the bucket
+  static auto ValueOf(size_t bucket) -> uint64_t {
+    if (bucket < SUB_BUCKETS) {
+      return bucket;
+    }
+    int msb = static_cast<int>(bucket / SUB_BUCKETS) + 3;
+    return (static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS)) << (msb - 4);
+  }
+
+  void Add(uint64_t ns) {
+    buckets_[BucketOf(ns)]++;
+    count_++;
+  }
+
+  void Merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < buckets_.size(); i++) {
+      buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+  }
+
+  auto Percentile(double p) const -> uint64_t {
+    auto rank = static_cast<uint64_t>(p * count_);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); i++) {
+      seen += buckets_[i];
+      if (seen > rank) {
+        return ValueOf(i);
+      }
+    }
+    return 0;
+  }
+};
+
+struct BTreeTotalMetrics {
+  std::array<uint64_t, 6> op_cnt_{};
+  LatencyHistogram latency_;
+  uint64_t start_time_{0};
+  uint64_t end_time_{0};
+  std::mutex mutex_;
+
+  void Begin() { start_time_ = ClockMs(); }
+
+  void End() { end_time_ = ClockMs(); }
+
+  void Report(const std::array<uint64_t, 6> &op_cnt, const LatencyHistogram &latency) {
+    std::unique_lock<std::mutex> l(mutex_);
+    for (size_t i = 0; i < op_cnt_.size(); i++) {
+      op_cnt_[i] += op_cnt[i];
+    }
+    latency_.Merge(latency);
+  }
+
+  void Report(BenchTree *tree, bustub::BufferPoolManager *bpm, uint64_t hits, uint64_t misses,
+              const bustub::BPlusTreeStats &stats) {
+    auto elapsed = static_cast<double>(end_time_ - start_time_);
+    uint64_t total = 0;
+    for (auto cnt : op_cnt_) {
+      total += cnt;
+    }
+
+    fmt::print("<<< BEGIN\n");
+    fmt::print("ops: {}\n", total / elapsed * 1000);
+    for (size_t i = 0; i < op_cnt_.size(); i++) {
+      if (op_cnt_[i] > 0) {
+        fmt::print("{}: {}\n", OP_NAMES[i], op_cnt_[i] / elapsed * 1000);
+      }
+    }
+    fmt::print("p50_us: {:.3f}\n", latency_.Percentile(0.5) / 1000.0);
+    fmt::print("p99_us: {:.3f}\n", latency_.Percentile(0.99) / 1000.0);
+    fmt::print("p999_us: {:.3f}\n", latency_.Percentile(0.999) / 1000.0);
+    fmt::print("height: {}\n", tree->GetHeight());
+    fmt::print("bpm_hit_rate: {:.4f}\n", hits + misses == 0 ? 1.0 : hits / static_cast<double>(hits + misses));
+    fmt::print("splits: {}\n", stats.splits_ / elapsed * 1000);
+    fmt::print("merges: {}\n", stats.merges_ / elapsed * 1000);
+    fmt::print("redistributions: {}\n", stats.redistributions_ / elapsed * 1000);
+    fmt::print(">>> END\n");
+  }
+};
+
+struct BTreeMetrics {
+  uint64_t start_time_{0};
+  uint64_t last_report_at_{0};
+  uint64_t last_cnt_{0};
+  uint64_t cnt_{0};
+  std::string reporter_;
+  uint64_t duration_ms_;
+
+  explicit BTreeMetrics(std::string reporter, uint64_t duration_ms)
+      : reporter_(std::move(reporter)), duration_ms_(duration_ms) {}
+
+  void Tick() { cnt_ += 1; }
+
+  void Begin() { start_time_ = ClockMs(); }
+
+  void Report() {
+    auto now = ClockMs();
+    auto elsped = now - start_time_;
+    if (elsped - last_report_at_ > 1000) {
+      fmt::print(stderr, "[{:5.2f}] {}: total_cnt={:<10} throughput={:<10.3f} avg_throughput={:<10.3f}\n",
+                 elsped / 1000.0, reporter_, cnt_,
+                 (cnt_ - last_cnt_) / static_cast<double>(elsped - last_report_at_) * 1000,
+                 cnt_ / static_cast<double>(elsped) * 1000);
+      last_report_at_ = elsped;
+      last_cnt_ = cnt_;
+    }
+  }
+
+  auto ShouldFinish() -> bool {
+    auto now = ClockMs();
+    return now - start_time_ > duration_ms_;
+  }
+};
+
+/** Picks the keys of one thread. Keys are integers; the records loaded before the run are 0 to record_cnt - 1. */
+class KeyChooser {
+ public:
+  KeyChooser(std::string distribution, bool latest, size_t record_cnt, size_t thread_id, size_t thread_cnt)
+      : distribution_(std::move(distribution)),
+        latest_(latest),
+        zipfian_(0, record_cnt - 1, ZIPFIAN_THETA),
+        gen_(std::random_device{}()),
+        next_sequential_(record_cnt * thread_id / thread_cnt) {}
+
+  // a key among the max_key records inserted so far
+  auto Next(int64_t max_key) -> int64_t {
+    int64_t offset;
+    if (distribution_ == "sequential") {
+      offset = static_cast<int64_t>(next_sequential_++ % max_key);
+    } else if (distribution_ == "zipfian") {
+      offset = static_cast<int64_t>(zipfian_(gen_) % max_key);
+    } else {
+      offset = std::uniform_int_distribution<int64_t>(0, max_key - 1)(gen_);
+    }
+    // the latest records are the hottest ones
+    return latest_ ? max_key - 1 - offset : offset;
+  }
+
+ private:
+  std::string distribution_;
+  bool latest_;
+  zipfian_int_distribution<size_t> zipfian_;
+  std::default_random_engine gen_;
+  size_t next_sequential_;
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  using bustub::BufferPoolManager;
+  using bustub::DiskManagerUnlimitedMemory;
+  using bustub::GenericKey;
+  using bustub::page_id_t;
+  using bustub::RID;
+
+  argparse::ArgumentParser program("bustub-btree-bench");
+  program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--workload").help("YCSB core workload: a, b, c, d, e or f");
+  program.add_argument("--mix").help(
+      "operation percentages read:update:insert:delete:scan:rmw, overriding the workload");
+  program.add_argument("--distribution").help("key distribution: uniform, zipfian or sequential");
+  program.add_argument("--threads").help("number of worker threads");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+  program.add_argument("--records").help("number of records loaded before the run");
+  program.add_argument("--scan-length").help("number of entries read by a scan");
+  program.add_argument("--lazy-merge").help("only merge pages once they are empty");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 30000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+
+  uint64_t latency_ms = 0;
+  if (program.present("--latency")) {
+    latency_ms = std::stoi(program.get("--latency"));
+  }
+
+  char workload = 'a';
+  if (program.present("--workload")) {
+    workload = bustub::StringUtil::Lower(program.get("--workload"))[0];
+  }
+  OpMix mix = YcsbMix(workload);
+  if (program.present("--mix")) {
+    auto parts = bustub::StringUtil::Split(program.get("--mix"), ':');
+    if (parts.size() != mix.size()) {
+      std::cerr << "--mix takes " << mix.size() << " percentages" << std::endl;
+      return 1;
+    }
+    for (size_t i = 0; i < mix.size(); i++) {
+      mix[i] = std::stoi(parts[i]);
+    }
+  }
+  int mix_total = 0;
+  for (auto percent : mix) {
+    mix_total += percent;
+  }
+  if (mix_total != 100) {
+    std::cerr << "operation percentages must add up to 100" << std::endl;
+    return 1;
+  }
+
+  std::string distribution = "zipfian";
+  if (program.present("--distribution")) {
+    distribution = bustub::StringUtil::Lower(program.get("--distribution"));
+    if (distribution != "uniform" && distribution != "zipfian" && distribution != "sequential") {
+      std::cerr << "unknown key distribution " << distribution << std::endl;
+      return 1;
+    }
+  }
+
+  size_t thread_cnt = BUSTUB_BENCH_THREAD;
+  if (program.present("--threads")) {
+    thread_cnt = std::stoi(program.get("--threads"));
+  }
+
+  size_t bpm_size = BUSTUB_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoi(program.get("--bpm-size"));
+  }
+
+  size_t record_cnt = BUSTUB_RECORD_CNT;
+  if (program.present("--records")) {
+    record_cnt = std::stoi(program.get("--records"));
+  }
+
+  size_t scan_length = BUSTUB_SCAN_LENGTH;
+  if (program.present("--scan-length")) {
+    scan_length = std::stoi(program.get("--scan-length"));
+  }
+
+  bool lazy_merge = false;
+  if (program.present("--lazy-merge")) {
+    lazy_merge = bustub::StringUtil::Lower(program.get("--lazy-merge")) == "true" || program.get("--lazy-merge") == "1";
+  }
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(bpm_size, disk_manager.get(), LRU_K_SIZE);
+  bustub::Schema key_schema({bustub::Column("key", bustub::TypeId::BIGINT)});
+  bustub::GenericComparator<8> comparator(&key_schema);
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id);
+  BenchTree tree("bench", header_page_id, bpm.get(), comparator);
+  tree.SetLazyMerge(lazy_merge);
+
+  fmt::print(stderr,
+             "[info] workload={}, mix={}, distribution={}, records={}, threads={}, duration_ms={}, latency_ms={}, "
+             "bpm_size={}, scan_length={}, lazy_merge={}\n",
+             workload, fmt::join(mix, ":"), distribution, record_cnt, thread_cnt, duration_ms, latency_ms, bpm_size,
+             scan_length, lazy_merge);
+
+  auto make_rid = [](int64_t key) { return RID(static_cast<page_id_t>(key >> 32), static_cast<uint32_t>(key)); };
+  GenericKey<8> index_key;
+  for (size_t i = 0; i < record_cnt; i++) {
+    index_key.SetFromInteger(static_cast<int64_t>(i));
+    tree.Insert(index_key, make_rid(static_cast<int64_t>(i)));
+  }
+
+  // enable disk latency after loading the records
+  disk_manager->SetLatency(latency_ms);
+
+  fmt::print(stderr, "[info] benchmark start\n");
+
+  // inserts take fresh keys past the loaded records
+  std::atomic<int64_t> next_key{static_cast<int64_t>(record_cnt)};
+  uint64_t hits_before = bpm->GetHitCount();
+  uint64_t misses_before = bpm->GetMissCount();
+  auto stats_before = tree.GetStats();
+  BTreeTotalMetrics total_metrics;
+  total_metrics.Begin();
+
+  std::vector<std::thread> threads;
+
+  for (size_t thread_id = 0; thread_id < thread_cnt; thread_id++) {
+    threads.emplace_back(std::thread([&, thread_id] {
+      KeyChooser keys(distribution, workload == 'd' && !program.present("--mix"), record_cnt, thread_id, thread_cnt);
+      std::default_random_engine gen(std::random_device{}());
+      std::uniform_int_distribution<int> percent(0, 99);
+      std::array<uint64_t, 6> op_cnt{};
+      LatencyHistogram latency;
+      std::vector<RID> result;
+      GenericKey<8> key;
+
+      BTreeMetrics metrics(fmt::format("btree {:>2}", thread_id), duration_ms);
+      metrics.Begin();
+
+      while (!metrics.ShouldFinish()) {
+        int dice = percent(gen);
+        size_t op = 0;
+        while (dice >= mix[op]) {
+          dice -= mix[op];
+          op++;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        switch (static_cast<OpType>(op)) {
+          case OpType::Read: {
+            key.SetFromInteger(keys.Next(next_key.load()));
+            result.clear();
+            tree.GetValue(key, &result);
+            break;
+          }
+          case OpType::Update: {
+            // an index update replaces the entry of the key
+            int64_t k = keys.Next(next_key.load());
+            key.SetFromInteger(k);
+            tree.Remove(key, nullptr);
+            tree.Insert(key, make_rid(k));
+            break;
+          }
+          case OpType::Insert: {
+            int64_t k = next_key.fetch_add(1);
+            key.SetFromInteger(k);
+            tree.Insert(key, make_rid(k));
+            break;
+          }
+          case OpType::Delete: {
+            key.SetFromInteger(keys.Next(next_key.load()));
+            tree.Remove(key, nullptr);
+            break;
+          }
+          case OpType::Scan: {
+            key.SetFromInteger(keys.Next(next_key.load()));
+            size_t scanned = 0;
+            for (auto it = tree.Begin(key); !it.IsEnd() && scanned < scan_length; ++it) {
+              scanned++;
+            }
+            break;
+          }
+          case OpType::ReadModifyWrite: {
+            int64_t k = keys.Next(next_key.load());
+            key.SetFromInteger(k);
+            result.clear();
+            tree.GetValue(key, &result);
+            tree.Remove(key, nullptr);
+            tree.Insert(key, make_rid(k));
+            break;
+          }
+        }
+        auto end = std::chrono::steady_clock::now();
+        latency.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        op_cnt[op]++;
+
+        metrics.Tick();
+        metrics.Report();
+      }
+
+      total_metrics.Report(op_cnt, latency);
+    }));
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  total_metrics.End();
+
+  auto stats = tree.GetStats();
+  stats.splits_ -= stats_before.splits_;
+  stats.merges_ -= stats_before.merges_;
+  stats.redistributions_ -= stats_before.redistributions_;
+  total_metrics.Report(&tree, bpm.get(), bpm->GetHitCount() - hits_before, bpm->GetMissCount() - misses_before,
+                       stats);
+
+  bpm->UnpinPage(header_page_id, false);
+  return 0;
+}
@@ -0,0 +1,287 @@
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <cpp_random_distributions/zipfian_int_distribution.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/util/string_util.h"
+#include "container/disk/hash/disk_extendible_hash_table.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/generic_key.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const size_t BUSTUB_BENCH_THREAD = 8;
+static const size_t LRU_K_SIZE = 16;
+static const size_t BUSTUB_BPM_SIZE = 256;
+static const size_t BUSTUB_RECORD_CNT = 100000;
+static const double ZIPFIAN_THETA = 0.99;
+
+using BenchTable = bustub::DiskExtendibleHashTable<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+
+enum class OpType { Read, Insert, Delete };
+static const std::array<const char *, 3> OP_NAMES = {"read", "insert", "delete"};
+
+/** Percentage of each operation, in OpType order. */
+using OpMix = std::array<int, 3>;
+
+struct HashTotalMetrics {
+  std::array<uint64_t, 3> op_cnt_{};
+  uint64_t start_time_{0};
+  uint64_t end_time_{0};
+  std::mutex mutex_;
+
+  void Begin() { start_time_ = ClockMs(); }
+
+  void End() { end_time_ = ClockMs(); }
+
+  void Report(const std::array<uint64_t, 3> &op_cnt) {
+    std::unique_lock<std::mutex> l(mutex_);
+    for (size_t i = 0; i < op_cnt_.size(); i++) {
+      op_cnt_[i] += op_cnt[i];
+    }
+  }
+
+  void Report(BenchTable *table, uint64_t hits, uint64_t misses) {
+    auto elapsed = static_cast<double>(end_time_ - start_time_);
+    uint64_t total = 0;
+    for (auto cnt : op_cnt_) {
+      total += cnt;
+    }
+
+    fmt::print("<<< BEGIN\n");
+    fmt::print("ops: {}\n", total / elapsed * 1000);
+    for (size_t i = 0; i < op_cnt_.size(); i++) {
+      if (op_cnt_[i] > 0) {
+        fmt::print("{}: {}\n", OP_NAMES[i], op_cnt_[i] / elapsed * 1000);
+      }
+    }
+    fmt::print("global_depth: {}\n", table->GetGlobalDepth());
+    fmt::print("bpm_hit_rate: {:.4f}\n", hits + misses == 0 ? 1.0 : hits / static_cast<double>(hits + misses));
+    fmt::print(">>> END\n");
+  }
+};
+
+struct HashMetrics {
+  uint64_t start_time_{0};
+  uint64_t last_report_at_{0};
+  uint64_t last_cnt_{0};
+  uint64_t cnt_{0};
+  std::string reporter_;
+  uint64_t duration_ms_;
+
+  explicit HashMetrics(std::string reporter, uint64_t duration_ms)
+      : reporter_(std::move(reporter)), duration_ms_(duration_ms) {}
+
+  void Tick() { cnt_ += 1; }
+
+  void Begin() { start_time_ = ClockMs(); }
+
+  void Report() {
+    auto now = ClockMs();
+    auto elsped = now - start_time_;
+    if (elsped - last_report_at_ > 1000) {
+      fmt::print(stderr, "[{:5.2f}] {}: total_cnt={:<10} throughput={:<10.3f} avg_throughput={:<10.3f}\n",
+                 elsped / 1000.0, reporter_, cnt_,
+                 (cnt_ - last_cnt_) / static_cast<double>(elsped - last_report_at_) * 1000,
+                 cnt_ / static_cast<double>(elsped) * 1000);
+      last_report_at_ = elsped;
+      last_cnt_ = cnt_;
+    }
+  }
+
+  auto ShouldFinish() -> bool {
+    auto now = ClockMs();
+    return now - start_time_ > duration_ms_;
+  }
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  using bustub::BufferPoolManager;
+  using bustub::DiskManagerUnlimitedMemory;
+  using bustub::GenericKey;
+  using bustub::page_id_t;
+  using bustub::RID;
+
+  argparse::ArgumentParser program("bustub-hash-bench");
+  program.add_argument("--duration").help("run hash table bench for n milliseconds");
+  program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--mix").help("operation percentages read:insert:delete");
+  program.add_argument("--distribution").help("key distribution of reads and deletes: uniform or zipfian");
+  program.add_argument("--threads").help("number of worker threads");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+  program.add_argument("--records").help("number of records loaded before the run");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 30000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+
+  uint64_t latency_ms = 0;
+  if (program.present("--latency")) {
+    latency_ms = std::stoi(program.get("--latency"));
+  }
+
+  OpMix mix = {80, 20, 0};
+  if (program.present("--mix")) {
+    auto parts = bustub::StringUtil::Split(program.get("--mix"), ':');
+    if (parts.size() != mix.size()) {
+      std::cerr << "--mix takes " << mix.size() << " percentages" << std::endl;
+      return 1;
+    }
+    for (size_t i = 0; i < mix.size(); i++) {
+      mix[i] = std::stoi(parts[i]);
+    }
+  }
+  if (mix[0] + mix[1] + mix[2] != 100) {
+    std::cerr << "operation percentages must add up to 100" << std::endl;
+    return 1;
+  }
+
+  std::string distribution = "uniform";
+  if (program.present("--distribution")) {
+    distribution = bustub::StringUtil::Lower(program.get("--distribution"));
+    if (distribution != "uniform" && distribution != "zipfian") {
+      std::cerr << "unknown key distribution " << distribution << std::endl;
+      return 1;
+    }
+  }
+
+  size_t thread_cnt = BUSTUB_BENCH_THREAD;
+  if (program.present("--threads")) {
+    thread_cnt = std::stoi(program.get("--threads"));
+  }
+
+  size_t bpm_size = BUSTUB_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoi(program.get("--bpm-size"));
+  }
+
+  size_t record_cnt = BUSTUB_RECORD_CNT;
+  if (program.present("--records")) {
+    record_cnt = std::stoi(program.get("--records"));
+  }
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(bpm_size, disk_manager.get(), LRU_K_SIZE);
+  bustub::Schema key_schema({bustub::Column("key", bustub::TypeId::BIGINT)});
+  bustub::GenericComparator<8> comparator(&key_schema);
+  BenchTable table("bench", bpm.get(), comparator, bustub::HashFunction<GenericKey<8>>());
+
+  fmt::print(stderr,
+             "[info] mix={}, distribution={}, records={}, threads={}, duration_ms={}, latency_ms={}, bpm_size={}\n",
+             fmt::join(mix, ":"), distribution, record_cnt, thread_cnt, duration_ms, latency_ms, bpm_size);
+
+  auto make_rid = [](int64_t key) { return RID(static_cast<page_id_t>(key >> 32), static_cast<uint32_t>(key)); };
+  GenericKey<8> index_key;
+  for (size_t i = 0; i < record_cnt; i++) {
+    index_key.SetFromInteger(static_cast<int64_t>(i));
+    table.Insert(nullptr, index_key, make_rid(static_cast<int64_t>(i)));
+  }
+
+  // enable disk latency after loading the records
+  disk_manager->SetLatency(latency_ms);
+
+  fmt::print(stderr, "[info] benchmark start\n");
+
+  // inserts take fresh keys past the loaded records
+  std::atomic<int64_t> next_key{static_cast<int64_t>(record_cnt)};
+  uint64_t hits_before = bpm->GetHitCount();
+  uint64_t misses_before = bpm->GetMissCount();
+  HashTotalMetrics total_metrics;
+  total_metrics.Begin();
+
+  std::vector<std::thread> threads;
+
+  for (size_t thread_id = 0; thread_id < thread_cnt; thread_id++) {
+    threads.emplace_back(std::thread([&, thread_id] {
+      std::default_random_engine gen(std::random_device{}());
+      zipfian_int_distribution<size_t> zipfian(0, record_cnt - 1, ZIPFIAN_THETA);
+      std::uniform_int_distribution<int> percent(0, 99);
+      std::array<uint64_t, 3> op_cnt{};
+      std::vector<RID> result;
+      GenericKey<8> key;
+
+      auto next_existing = [&]() -> int64_t {
+        int64_t max_key = next_key.load();
+        if (distribution == "zipfian") {
+          return static_cast<int64_t>(zipfian(gen) % max_key);
+        }
+        return std::uniform_int_distribution<int64_t>(0, max_key - 1)(gen);
+      };
+
+      HashMetrics metrics(fmt::format("hash {:>2}", thread_id), duration_ms);
+      metrics.Begin();
+
+      while (!metrics.ShouldFinish()) {
+        int dice = percent(gen);
+        size_t op = 0;
+        while (dice >= mix[op]) {
+          dice -= mix[op];
+          op++;
+        }
+
+        switch (static_cast<OpType>(op)) {
+          case OpType::Read: {
+            key.SetFromInteger(next_existing());
+            result.clear();
+            table.GetValue(nullptr, key, &result);
+            break;
+          }
+          case OpType::Insert: {
+            int64_t k = next_key.fetch_add(1);
+            key.SetFromInteger(k);
+            table.Insert(nullptr, key, make_rid(k));
+            break;
+          }
+          case OpType::Delete: {
+            int64_t k = next_existing();
+            key.SetFromInteger(k);
+            table.Remove(nullptr, key, make_rid(k));
+            break;
+          }
+        }
+        op_cnt[op]++;
+
+        metrics.Tick();
+        metrics.Report();
+      }
+
+      total_metrics.Report(op_cnt);
+    }));
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  total_metrics.End();
+
+  total_metrics.Report(&table, bpm->GetHitCount() - hits_before, bpm->GetMissCount() - misses_before);
+  return 0;
+}
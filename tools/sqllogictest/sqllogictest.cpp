@@ -73,6 +73,16 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("IndexScan not found\n");
           return false;
         }
+      } else if (opt == "ensure:index_only_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "index_only")) {
+          fmt::print("index-only IndexScan not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:index_lookup") {
+        if (!bustub::StringUtil::Contains(result.str(), "IndexLookup")) {
+          fmt::print("IndexLookup not found\n");
+          return false;
+        }
       } else if (opt == "ensure:topn") {
         if (!bustub::StringUtil::Contains(result.str(), "TopN")) {
           fmt::print("TopN not found\n");